@@ -0,0 +1,53 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "../small_alloc/small_alloc.h"
+#include "sampler.h"
+
+
+struct Payload
+{
+    long values[8];
+};
+
+
+// Replaces random members of a window of live objects through MakeUnique.
+static double churn(std::vector<UniquePtr<Payload, SmallDelete<Payload>>>& live, long operations)
+{
+    const std::size_t window = live.size();
+    unsigned seed = 1;
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < operations; ++i)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        live[(seed >> 8) % window] = MakeUnique<Payload>();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return seconds * 1e9 / static_cast<double>(operations);
+}
+
+
+int main(int argc, char** argv)
+{
+    const long operations = argc > 1 ? std::atol(argv[1]) : 20000000;
+    const std::size_t window = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 4096;
+
+    std::vector<UniquePtr<Payload, SmallDelete<Payload>>> live(window);
+    churn(live, operations / 10);
+    std::printf("%ld MakeUnique replacements of %zu bytes, %zu kept live; ns each\n", operations, sizeof(Payload),
+                window);
+    std::printf("%-24s %10s %14s\n", "sampler", "ns", "live samples");
+    std::printf("%-24s %10.2f %14s\n", "stopped", churn(live, operations), "-");
+    const std::size_t intervals[] = {AllocSampler::default_interval, 64 * 1024, 4096};
+    for (std::size_t interval : intervals)
+    {
+        AllocSampler::start(interval);
+        const double ns = churn(live, operations);
+        AllocSampler::stop();
+        char name[32];
+        std::snprintf(name, sizeof(name), "every %zu KiB", interval / 1024);
+        std::printf("%-24s %10.2f %14zu\n", name, ns, AllocSampler::live().size());
+    }
+    return 0;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// The part of AllocSampler that SmallAlloc calls on every create and
+// destroy. AllocSampler::start installs the slow paths; until then, and
+// whenever nothing is sampled or live, each hook returns after one load and
+// the sampler itself is never built.
+class AllocSampleHooks
+{
+public:
+    typedef void (*Allocated)(const void* address, std::size_t size);
+    typedef void (*Freed)(const void* address);
+
+    struct State
+    {
+        // Odd while sampling; bumped by every start() and stop().
+        std::atomic<std::uint64_t> generation;
+        std::atomic<std::size_t> live_count;
+        std::atomic<Allocated> allocated;
+        std::atomic<Freed> freed;
+    };
+
+    static State& state() noexcept;
+    static void allocated(const void* address, std::size_t size) noexcept;
+    static void freed(const void* address) noexcept;
+};
+
+inline AllocSampleHooks::State& AllocSampleHooks::state() noexcept
+{
+    // Zero-initialised, so there is no guard to check on the hot path.
+    static State state;
+    return state;
+}
+
+inline void AllocSampleHooks::allocated(const void* const address, const std::size_t size) noexcept
+{
+    State& state = AllocSampleHooks::state();
+    if (state.generation.load(std::memory_order_acquire) & 1)
+        state.allocated.load(std::memory_order_relaxed)(address, size);
+}
+
+inline void AllocSampleHooks::freed(const void* const address) noexcept
+{
+    State& state = AllocSampleHooks::state();
+    if (state.live_count.load(std::memory_order_relaxed) == 0)
+        return;
+    if (Freed hook = state.freed.load(std::memory_order_acquire))
+        hook(address);
+}
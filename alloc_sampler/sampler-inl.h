@@ -0,0 +1,201 @@
+#include <execinfo.h>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <system_error>
+
+inline AllocSampler::State::State()
+{
+    for (std::atomic<std::uint16_t>& count : filter)
+        count.store(0, std::memory_order_relaxed);
+}
+
+inline AllocSampler::State& AllocSampler::state()
+{
+    // Never destroyed: static destructors may still free sampled objects.
+    static State& state = *new State();
+    return state;
+}
+
+inline AllocSamplerThread& AllocSampler::local() noexcept
+{
+    static thread_local AllocSamplerThread thread = {0, 0, 0};
+    return thread;
+}
+
+inline std::size_t AllocSampler::slot(const void* const address) noexcept
+{
+    const std::uint64_t key = reinterpret_cast<std::uintptr_t>(address) >> 4;
+    return static_cast<std::size_t>((key * 0x9e3779b97f4a7c15ull) >> (64 - filter_bits));
+}
+
+inline std::atomic<std::uint64_t>& AllocSampler::generation() noexcept
+{
+    return AllocSampleHooks::state().generation;
+}
+
+inline void AllocSampler::start(const std::size_t mean_interval)
+{
+    State& state = AllocSampler::state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    for (const auto& entry : state.live)
+        state.filter[slot(entry.first)].fetch_sub(1, std::memory_order_relaxed);
+    state.live.clear();
+    state.stacks.clear();
+    AllocSampleHooks::state().live_count.store(0, std::memory_order_relaxed);
+    state.interval.store(mean_interval ? mean_interval : 1, std::memory_order_relaxed);
+    AllocSampleHooks::state().allocated.store(&AllocSampler::allocated, std::memory_order_relaxed);
+    AllocSampleHooks::state().freed.store(&AllocSampler::freed, std::memory_order_release);
+
+    const std::uint64_t current = generation().load(std::memory_order_relaxed);
+    generation().store(current + (current & 1 ? 2 : 1), std::memory_order_release);
+}
+
+inline void AllocSampler::stop() noexcept
+{
+    State& state = AllocSampler::state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    const std::uint64_t current = generation().load(std::memory_order_relaxed);
+    if (current & 1)
+        generation().store(current + 1, std::memory_order_release);
+}
+
+inline bool AllocSampler::sampling() noexcept
+{
+    return generation().load(std::memory_order_acquire) & 1;
+}
+
+inline std::int64_t AllocSampler::next_distance(AllocSamplerThread& thread, const std::size_t mean) noexcept
+{
+    if (thread.random == 0)
+        thread.random = reinterpret_cast<std::uintptr_t>(&thread) * 0x9e3779b97f4a7c15ull | 1;
+    thread.random ^= thread.random >> 12;
+    thread.random ^= thread.random << 25;
+    thread.random ^= thread.random >> 27;
+    // Uniform in (0, 1], so the logarithm is finite.
+    const double uniform = static_cast<double>((thread.random * 0x2545f4914f6cdd1dull >> 11) + 1) / 9007199254740992.0;
+    return static_cast<std::int64_t>(-std::log(uniform) * static_cast<double>(mean)) + 1;
+}
+
+inline void AllocSampler::allocated(const void* const address, const std::size_t size) noexcept
+{
+    const std::uint64_t current = generation().load(std::memory_order_acquire);
+    if (!(current & 1))
+        return;
+
+    AllocSamplerThread& thread = local();
+    if (thread.generation != current)
+    {
+        thread.generation = current;
+        thread.until_sample = next_distance(thread, state().interval.load(std::memory_order_relaxed));
+    }
+    thread.until_sample -= static_cast<std::int64_t>(size);
+    if (thread.until_sample < 0)
+        sample(thread, address, size);
+}
+
+inline void AllocSampler::sample(AllocSamplerThread& thread, const void* const address, const std::size_t size) noexcept
+{
+    State& state = AllocSampler::state();
+    thread.until_sample = next_distance(thread, state.interval.load(std::memory_order_relaxed));
+
+    void* frames[max_frames];
+    const int depth = backtrace(frames, static_cast<int>(max_frames));
+    try
+    {
+        // The first frame is this function.
+        std::vector<void*> stack(frames + (depth > 1 ? 1 : 0), frames + depth);
+        std::lock_guard<std::mutex> lock(state.mutex);
+        Stacks::iterator totals = state.stacks.emplace(std::move(stack), StackTotals{0, 0, 0, 0}).first;
+        if (!state.live.emplace(address, Live{size, totals}).second)
+            return;
+        totals->second.live_objects += 1;
+        totals->second.live_bytes += size;
+        totals->second.total_objects += 1;
+        totals->second.total_bytes += size;
+        state.filter[slot(address)].fetch_add(1, std::memory_order_relaxed);
+        AllocSampleHooks::state().live_count.fetch_add(1, std::memory_order_relaxed);
+    }
+    catch (...)
+    {
+    }
+}
+
+inline void AllocSampler::freed(const void* const address) noexcept
+{
+    State& state = AllocSampler::state();
+    if (state.filter[slot(address)].load(std::memory_order_relaxed) == 0)
+        return;
+
+    std::lock_guard<std::mutex> lock(state.mutex);
+    auto found = state.live.find(address);
+    if (found == state.live.end())
+        return;
+    found->second.stack->second.live_objects -= 1;
+    found->second.stack->second.live_bytes -= found->second.size;
+    state.filter[slot(address)].fetch_sub(1, std::memory_order_relaxed);
+    AllocSampleHooks::state().live_count.fetch_sub(1, std::memory_order_relaxed);
+    state.live.erase(found);
+}
+
+inline std::vector<AllocSample> AllocSampler::live()
+{
+    State& state = AllocSampler::state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    std::vector<AllocSample> samples;
+    samples.reserve(state.live.size());
+    for (const auto& entry : state.live)
+        samples.push_back(AllocSample{entry.first, entry.second.size, entry.second.stack->first});
+    return samples;
+}
+
+inline std::string AllocSampler::profile()
+{
+    State& state = AllocSampler::state();
+    std::ostringstream out;
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        StackTotals all = {0, 0, 0, 0};
+        for (const auto& entry : state.stacks)
+        {
+            all.live_objects += entry.second.live_objects;
+            all.live_bytes += entry.second.live_bytes;
+            all.total_objects += entry.second.total_objects;
+            all.total_bytes += entry.second.total_bytes;
+        }
+
+        // heap_v2 tells pprof the counts are samples taken every interval
+        // bytes on average, which it scales back up.
+        out << "heap profile: " << all.live_objects << ": " << all.live_bytes << " [" << all.total_objects << ": "
+            << all.total_bytes << "] @ heap_v2/" << state.interval.load(std::memory_order_relaxed) << "\n";
+        for (const auto& entry : state.stacks)
+        {
+            const StackTotals& totals = entry.second;
+            out << totals.live_objects << ": " << totals.live_bytes << " [" << totals.total_objects << ": "
+                << totals.total_bytes << "] @";
+            for (void* frame : entry.first)
+                out << " " << frame;
+            out << "\n";
+        }
+    }
+
+    out << "\nMAPPED_LIBRARIES:\n";
+    std::ifstream maps("/proc/self/maps");
+    out << maps.rdbuf();
+    return out.str();
+}
+
+inline void AllocSampler::save(const std::string& path)
+{
+    const std::string text = profile();
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (file == nullptr)
+        throw std::system_error(errno, std::generic_category(), "open " + path);
+
+    bool written = std::fwrite(text.data(), 1, text.size(), file) == text.size();
+    const int error = errno;
+    if (std::fclose(file) != 0 || !written)
+        throw std::system_error(written ? errno : error, std::generic_category(), "write " + path);
+}
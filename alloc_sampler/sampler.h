@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "sample_hooks.h"
+
+struct AllocSample
+{
+    const void* address;
+    std::size_t size;
+    std::vector<void*> stack;
+};
+
+struct AllocSamplerThread
+{
+    std::int64_t until_sample;
+    std::uint64_t random;
+    std::uint64_t generation;
+};
+
+// Heap profiler for the make-functions. While stopped, the allocation hook
+// costs one relaxed load. While started, each thread counts
+// down the bytes it allocates through them and records a stack trace for
+// the allocation that crosses zero, after which it draws the next distance
+// from an exponential distribution with the configured mean. Every byte
+// allocated thus has the same chance of being sampled, so big allocations
+// are seen more often, and pprof can scale the samples back up.
+//
+// Sampled objects stay in a live table until freed. A small counting filter
+// on their addresses lets frees of unsampled objects, which is nearly all of
+// them, return after one load.
+class AllocSampler
+{
+public:
+    static constexpr std::size_t default_interval = 512 * 1024;
+
+    static void start(std::size_t mean_interval = default_interval);
+    // Stops taking new samples; objects already sampled are still removed
+    // from the live table when freed.
+    static void stop() noexcept;
+    static bool sampling() noexcept;
+
+    // Slow paths installed into AllocSampleHooks by start().
+    static void allocated(const void* address, std::size_t size) noexcept;
+    static void freed(const void* address) noexcept;
+
+    static std::vector<AllocSample> live();
+    // Live samples in the legacy text heap profile format read by pprof,
+    // followed by the process's mappings for symbolisation.
+    static std::string profile();
+    // Throws std::system_error on I/O failure.
+    static void save(const std::string& path);
+
+private:
+    static constexpr std::size_t max_frames = 64;
+    static constexpr std::size_t filter_bits = 12;
+
+    struct StackTotals
+    {
+        std::size_t live_objects;
+        std::size_t live_bytes;
+        std::size_t total_objects;
+        std::size_t total_bytes;
+    };
+
+    typedef std::map<std::vector<void*>, StackTotals> Stacks;
+
+    struct Live
+    {
+        std::size_t size;
+        Stacks::iterator stack;
+    };
+
+    struct State
+    {
+        std::mutex mutex;
+        std::atomic<std::size_t> interval{default_interval};
+        std::atomic<std::uint16_t> filter[std::size_t(1) << filter_bits];
+        Stacks stacks;
+        std::unordered_map<const void*, Live> live;
+
+        State();
+    };
+
+    static State& state();
+    static std::atomic<std::uint64_t>& generation() noexcept;
+    static AllocSamplerThread& local() noexcept;
+    static std::size_t slot(const void* address) noexcept;
+    static std::int64_t next_distance(AllocSamplerThread& thread, std::size_t mean) noexcept;
+    static void sample(AllocSamplerThread& thread, const void* address, std::size_t size) noexcept;
+};
+
+#include "sampler-inl.h"
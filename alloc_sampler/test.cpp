@@ -0,0 +1,99 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../shared_ptr/shared.h"
+#include "sampler.h"
+
+
+struct Blob
+{
+    char bytes[256];
+};
+
+struct Small
+{
+    long value;
+};
+
+
+static bool is_live(const void* address)
+{
+    std::vector<AllocSample> samples = AllocSampler::live();
+    return std::any_of(samples.begin(), samples.end(),
+                       [address](const AllocSample& sample) { return sample.address == address; });
+}
+
+
+TEST(AllocSamplerTest, NothingIsSampledWhileStopped)
+{
+    AllocSampler::start(1);
+    AllocSampler::stop();
+    UniquePtr<Blob, SmallDelete<Blob>> blob = MakeUnique<Blob>();
+    EXPECT_FALSE(AllocSampler::sampling());
+    EXPECT_TRUE(AllocSampler::live().empty());
+}
+
+
+TEST(AllocSamplerTest, TracksSampledObjectsUntilFreed)
+{
+    AllocSampler::start(1);
+    UniquePtr<Blob, SmallDelete<Blob>> unique = MakeUnique<Blob>();
+    SharedPtr<Blob> shared = MakeShared<Blob>();
+    AllocSampler::stop();
+
+    std::vector<AllocSample> samples = AllocSampler::live();
+    ASSERT_EQ(samples.size(), 2u);
+    EXPECT_TRUE(is_live(unique.get()));
+    for (const AllocSample& sample : samples)
+    {
+        EXPECT_GE(sample.size, sizeof(Blob));
+        EXPECT_FALSE(sample.stack.empty());
+    }
+
+    unique.reset();
+    EXPECT_EQ(AllocSampler::live().size(), 1u);
+    shared.reset();
+    EXPECT_TRUE(AllocSampler::live().empty());
+}
+
+
+TEST(AllocSamplerTest, SampleCountFollowsInterval)
+{
+    const std::size_t interval = 4096;
+    const std::size_t objects = 200000;
+    AllocSampler::start(interval);
+    std::vector<UniquePtr<Small, SmallDelete<Small>>> kept;
+    kept.reserve(objects);
+    for (std::size_t i = 0; i < objects; ++i)
+        kept.push_back(MakeUnique<Small>());
+    AllocSampler::stop();
+
+    const double expected = static_cast<double>(objects * sizeof(Small)) / interval;
+    const double sampled = static_cast<double>(AllocSampler::live().size());
+    EXPECT_GT(sampled, expected * 0.85);
+    EXPECT_LT(sampled, expected * 1.15);
+
+    kept.clear();
+    EXPECT_TRUE(AllocSampler::live().empty());
+}
+
+
+TEST(AllocSamplerTest, ProfileUsesLegacyHeapFormat)
+{
+    AllocSampler::start(1);
+    std::vector<UniquePtr<Blob, SmallDelete<Blob>>> blobs;
+    for (int i = 0; i < 3; ++i)
+        blobs.push_back(MakeUnique<Blob>());
+    blobs.pop_back();
+    AllocSampler::stop();
+
+    const std::string text = AllocSampler::profile();
+    const std::string header = "heap profile: 2: " + std::to_string(2 * sizeof(Blob)) + " [3: " +
+                               std::to_string(3 * sizeof(Blob)) + "] @ heap_v2/1\n";
+    EXPECT_EQ(text.compare(0, header.size(), header), 0) << text.substr(0, 200);
+    // Whether the loop's samples share one stack depends on codegen, so only
+    // the totals are exact; each bucket line ends in frame addresses.
+    EXPECT_NE(text.find("] @ 0x", header.size()), std::string::npos);
+    EXPECT_NE(text.find("\nMAPPED_LIBRARIES:\n"), std::string::npos);
+}
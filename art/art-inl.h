@@ -0,0 +1,480 @@
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <utility>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+template <typename V>
+void AdaptiveRadixTree<V>::NodeDelete::operator()(Node* const node) const noexcept
+{
+    switch (node->type)
+    {
+    case NodeType::leaf:
+        destroy_leaf(static_cast<Leaf*>(node));
+        break;
+    case NodeType::node4:
+        delete static_cast<Node4*>(node);
+        break;
+    case NodeType::node16:
+        delete static_cast<Node16*>(node);
+        break;
+    case NodeType::node48:
+        delete static_cast<Node48*>(node);
+        break;
+    case NodeType::node256:
+        delete static_cast<Node256*>(node);
+        break;
+    }
+}
+
+template <typename V>
+AdaptiveRadixTree<V>::AdaptiveRadixTree() noexcept
+{
+    count = 0;
+}
+
+template <typename V>
+std::string_view AdaptiveRadixTree<V>::Leaf::key() const noexcept
+{
+    return std::string_view(reinterpret_cast<const char*>(this + 1), length);
+}
+
+template <typename V>
+typename AdaptiveRadixTree<V>::NodePtr AdaptiveRadixTree<V>::make_leaf(const std::string_view key, const V& value)
+{
+    void* memory = ::operator new(sizeof(Leaf) + key.size());
+    Leaf* leaf;
+    try
+    {
+        leaf = new (memory) Leaf{{NodeType::leaf}, static_cast<std::uint32_t>(key.size()), value};
+    }
+    catch (...)
+    {
+        ::operator delete(memory);
+        throw;
+    }
+    std::memcpy(reinterpret_cast<char*>(leaf + 1), key.data(), key.size());
+    return NodePtr(leaf);
+}
+
+template <typename V>
+void AdaptiveRadixTree<V>::destroy_leaf(Leaf* const leaf) noexcept
+{
+    leaf->~Leaf();
+    ::operator delete(leaf);
+}
+
+template <typename V>
+std::size_t AdaptiveRadixTree<V>::common_prefix(const std::string_view left, const std::string_view right) noexcept
+{
+    const std::size_t limit = std::min(left.size(), right.size());
+    std::size_t length = 0;
+    while (length < limit && left[length] == right[length])
+        ++length;
+    return length;
+}
+
+template <typename V>
+typename AdaptiveRadixTree<V>::NodePtr* AdaptiveRadixTree<V>::find_child(Inner* const node, const std::uint8_t byte) noexcept
+{
+    switch (node->type)
+    {
+    case NodeType::node4:
+    {
+        Node4* small = static_cast<Node4*>(node);
+        for (std::uint16_t i = 0; i < small->count; ++i)
+        {
+            if (small->keys[i] == byte)
+                return &small->children[i];
+        }
+        return nullptr;
+    }
+    case NodeType::node16:
+    {
+        Node16* medium = static_cast<Node16*>(node);
+#ifdef __SSE2__
+        const __m128i keys = _mm_loadu_si128(reinterpret_cast<const __m128i*>(medium->keys));
+        const __m128i matches = _mm_cmpeq_epi8(keys, _mm_set1_epi8(static_cast<char>(byte)));
+        const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(matches)) & ((1u << medium->count) - 1);
+        return mask ? &medium->children[__builtin_ctz(mask)] : nullptr;
+#else
+        for (std::uint16_t i = 0; i < medium->count; ++i)
+        {
+            if (medium->keys[i] == byte)
+                return &medium->children[i];
+        }
+        return nullptr;
+#endif
+    }
+    case NodeType::node48:
+    {
+        Node48* large = static_cast<Node48*>(node);
+        return large->index[byte] ? &large->children[large->index[byte] - 1] : nullptr;
+    }
+    case NodeType::node256:
+    {
+        Node256* full = static_cast<Node256*>(node);
+        return full->children[byte] ? &full->children[byte] : nullptr;
+    }
+    default:
+        return nullptr;
+    }
+}
+
+template <typename V>
+bool AdaptiveRadixTree<V>::full(const Inner* const node) noexcept
+{
+    switch (node->type)
+    {
+    case NodeType::node4:
+        return node->count == 4;
+    case NodeType::node16:
+        return node->count == 16;
+    case NodeType::node48:
+        return node->count == 48;
+    default:
+        return false;
+    }
+}
+
+template <typename V>
+void AdaptiveRadixTree<V>::add_child(Inner* const node, const std::uint8_t byte, NodePtr child)
+{
+    std::uint8_t* keys;
+    NodePtr* children;
+    std::uint16_t position = 0;
+    switch (node->type)
+    {
+    case NodeType::node4:
+    {
+        Node4* small = static_cast<Node4*>(node);
+        keys = small->keys;
+        children = small->children;
+        while (position < small->count && keys[position] < byte)
+            ++position;
+        break;
+    }
+    case NodeType::node16:
+    {
+        Node16* medium = static_cast<Node16*>(node);
+        keys = medium->keys;
+        children = medium->children;
+#ifdef __SSE2__
+        // Unsigned less-than via a signed compare with the sign bits flipped.
+        const __m128i bias = _mm_set1_epi8(static_cast<char>(0x80));
+        const __m128i lanes = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys)), bias);
+        const __m128i target = _mm_xor_si128(_mm_set1_epi8(static_cast<char>(byte)), bias);
+        const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmplt_epi8(lanes, target))) & ((1u << node->count) - 1);
+        position = static_cast<std::uint16_t>(__builtin_popcount(mask));
+#else
+        while (position < medium->count && keys[position] < byte)
+            ++position;
+#endif
+        break;
+    }
+    case NodeType::node48:
+    {
+        // Nothing is ever removed, so slots fill in order.
+        Node48* large = static_cast<Node48*>(node);
+        large->children[node->count] = std::move(child);
+        large->index[byte] = static_cast<std::uint8_t>(node->count + 1);
+        ++node->count;
+        return;
+    }
+    default:
+        static_cast<Node256*>(node)->children[byte] = std::move(child);
+        ++node->count;
+        return;
+    }
+
+    for (std::uint16_t i = node->count; i > position; --i)
+    {
+        keys[i] = keys[i - 1];
+        children[i] = std::move(children[i - 1]);
+    }
+    keys[position] = byte;
+    children[position] = std::move(child);
+    ++node->count;
+}
+
+template <typename V>
+void AdaptiveRadixTree<V>::grow(NodePtr& slot)
+{
+    Inner* node = static_cast<Inner*>(slot.get());
+    Inner* bigger;
+    if (node->type == NodeType::node4)
+    {
+        Node4* small = static_cast<Node4*>(node);
+        Node16* medium = new Node16();
+        medium->type = NodeType::node16;
+        for (std::uint16_t i = 0; i < small->count; ++i)
+        {
+            medium->keys[i] = small->keys[i];
+            medium->children[i] = std::move(small->children[i]);
+        }
+        bigger = medium;
+    }
+    else if (node->type == NodeType::node16)
+    {
+        Node16* medium = static_cast<Node16*>(node);
+        Node48* large = new Node48();
+        large->type = NodeType::node48;
+        for (std::uint16_t i = 0; i < medium->count; ++i)
+        {
+            large->index[medium->keys[i]] = static_cast<std::uint8_t>(i + 1);
+            large->children[i] = std::move(medium->children[i]);
+        }
+        bigger = large;
+    }
+    else
+    {
+        Node48* large = static_cast<Node48*>(node);
+        Node256* full = new Node256();
+        full->type = NodeType::node256;
+        for (int byte = 0; byte < 256; ++byte)
+        {
+            if (large->index[byte])
+                full->children[byte] = std::move(large->children[large->index[byte] - 1]);
+        }
+        bigger = full;
+    }
+    bigger->count = node->count;
+    bigger->prefix = std::move(node->prefix);
+    bigger->terminal = std::move(node->terminal);
+    slot = NodePtr(bigger);
+}
+
+template <typename V>
+void AdaptiveRadixTree<V>::place(Inner* const node, const std::string_view key, const std::size_t depth, NodePtr child)
+{
+    if (key.size() == depth)
+        node->terminal = std::move(child);
+    else
+        add_child(node, static_cast<std::uint8_t>(key[depth]), std::move(child));
+}
+
+template <typename V>
+bool AdaptiveRadixTree<V>::insert(NodePtr& slot, const std::string_view key, std::size_t depth, const V& value)
+{
+    if (!slot)
+    {
+        slot = make_leaf(key, value);
+        return true;
+    }
+
+    if (slot->type == NodeType::leaf)
+    {
+        Leaf* leaf = static_cast<Leaf*>(slot.get());
+        if (leaf->key() == key)
+        {
+            leaf->value = value;
+            return false;
+        }
+
+        // Expand the leaf into a Node4 holding both keys below their
+        // common prefix. The old leaf does not move, so its key stays valid.
+        // Everything that can throw happens before slot is moved.
+        const std::string_view existing = leaf->key();
+        const std::size_t common = common_prefix(existing.substr(depth), key.substr(depth));
+        NodePtr added = make_leaf(key, value);
+        Node4* node = new Node4();
+        node->type = NodeType::node4;
+        NodePtr fresh(node);
+        node->prefix = std::string(key.substr(depth, common));
+        place(node, existing, depth + common, std::move(slot));
+        place(node, key, depth + common, std::move(added));
+        slot = std::move(fresh);
+        return true;
+    }
+
+    Inner* inner = static_cast<Inner*>(slot.get());
+    const std::size_t matched = common_prefix(inner->prefix, key.substr(depth));
+    if (matched < inner->prefix.size())
+    {
+        // The key leaves the compressed path: split it at the mismatch.
+        NodePtr added = make_leaf(key, value);
+        Node4* node = new Node4();
+        node->type = NodeType::node4;
+        NodePtr fresh(node);
+        node->prefix = inner->prefix.substr(0, matched);
+        const std::uint8_t byte = static_cast<std::uint8_t>(inner->prefix[matched]);
+        inner->prefix.erase(0, matched + 1);
+        add_child(node, byte, std::move(slot));
+        place(node, key, depth + matched, std::move(added));
+        slot = std::move(fresh);
+        return true;
+    }
+
+    depth += inner->prefix.size();
+    if (depth == key.size())
+    {
+        if (inner->terminal)
+        {
+            static_cast<Leaf*>(inner->terminal.get())->value = value;
+            return false;
+        }
+        inner->terminal = make_leaf(key, value);
+        return true;
+    }
+
+    const std::uint8_t byte = static_cast<std::uint8_t>(key[depth]);
+    NodePtr* child = find_child(inner, byte);
+    if (child)
+        return insert(*child, key, depth + 1, value);
+
+    if (full(inner))
+    {
+        grow(slot);
+        inner = static_cast<Inner*>(slot.get());
+    }
+    add_child(inner, byte, make_leaf(key, value));
+    return true;
+}
+
+template <typename V>
+bool AdaptiveRadixTree<V>::insert(const std::string_view key, const V& value)
+{
+    const bool inserted = insert(root, key, 0, value);
+    if (inserted)
+        ++count;
+    return inserted;
+}
+
+template <typename V>
+V* AdaptiveRadixTree<V>::find(const std::string_view key) noexcept
+{
+    Node* node = root.get();
+    std::size_t depth = 0;
+    while (node)
+    {
+        if (node->type == NodeType::leaf)
+        {
+            Leaf* leaf = static_cast<Leaf*>(node);
+            return leaf->key() == key ? &leaf->value : nullptr;
+        }
+
+        Inner* inner = static_cast<Inner*>(node);
+        if (key.size() - depth < inner->prefix.size() || key.compare(depth, inner->prefix.size(), inner->prefix) != 0)
+            return nullptr;
+        depth += inner->prefix.size();
+        if (depth == key.size())
+        {
+            node = inner->terminal.get();
+            continue;
+        }
+
+        NodePtr* child = find_child(inner, static_cast<std::uint8_t>(key[depth]));
+        node = child ? child->get() : nullptr;
+        ++depth;
+    }
+    return nullptr;
+}
+
+template <typename V>
+const V* AdaptiveRadixTree<V>::find(const std::string_view key) const noexcept
+{
+    return const_cast<AdaptiveRadixTree*>(this)->find(key);
+}
+
+template <typename V>
+bool AdaptiveRadixTree<V>::contains(const std::string_view key) const noexcept
+{
+    return find(key) != nullptr;
+}
+
+template <typename V>
+template <typename Func>
+void AdaptiveRadixTree<V>::visit(const Node* const node, Func& func)
+{
+    if (node->type == NodeType::leaf)
+    {
+        const Leaf* leaf = static_cast<const Leaf*>(node);
+        func(leaf->key(), leaf->value);
+        return;
+    }
+
+    const Inner* inner = static_cast<const Inner*>(node);
+    if (inner->terminal)
+        visit(inner->terminal.get(), func);
+    switch (node->type)
+    {
+    case NodeType::node4:
+        for (std::uint16_t i = 0; i < inner->count; ++i)
+            visit(static_cast<const Node4*>(node)->children[i].get(), func);
+        break;
+    case NodeType::node16:
+        for (std::uint16_t i = 0; i < inner->count; ++i)
+            visit(static_cast<const Node16*>(node)->children[i].get(), func);
+        break;
+    case NodeType::node48:
+    {
+        const Node48* large = static_cast<const Node48*>(node);
+        for (int byte = 0; byte < 256; ++byte)
+        {
+            if (large->index[byte])
+                visit(large->children[large->index[byte] - 1].get(), func);
+        }
+        break;
+    }
+    default:
+    {
+        const Node256* full = static_cast<const Node256*>(node);
+        for (int byte = 0; byte < 256; ++byte)
+        {
+            if (full->children[byte])
+                visit(full->children[byte].get(), func);
+        }
+        break;
+    }
+    }
+}
+
+template <typename V>
+template <typename Func>
+void AdaptiveRadixTree<V>::scan_prefix(const std::string_view prefix, Func func) const
+{
+    const Node* node = root.get();
+    std::size_t depth = 0;
+    while (node)
+    {
+        if (node->type == NodeType::leaf)
+        {
+            const Leaf* leaf = static_cast<const Leaf*>(node);
+            if (leaf->key().substr(0, prefix.size()) == prefix)
+                func(leaf->key(), leaf->value);
+            return;
+        }
+
+        // Everything below a node whose path covers the prefix matches.
+        const Inner* inner = static_cast<const Inner*>(node);
+        const std::size_t remaining = prefix.size() - depth;
+        const std::size_t overlap = std::min(remaining, inner->prefix.size());
+        if (prefix.compare(depth, overlap, inner->prefix, 0, overlap) != 0)
+            return;
+        if (remaining <= inner->prefix.size())
+        {
+            visit(node, func);
+            return;
+        }
+        depth += inner->prefix.size();
+
+        NodePtr* child = find_child(const_cast<Inner*>(inner), static_cast<std::uint8_t>(prefix[depth]));
+        node = child ? child->get() : nullptr;
+        ++depth;
+    }
+}
+
+template <typename V>
+std::size_t AdaptiveRadixTree<V>::size() const noexcept
+{
+    return count;
+}
+
+template <typename V>
+bool AdaptiveRadixTree<V>::empty() const noexcept
+{
+    return count == 0;
+}
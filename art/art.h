@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "../unique_ptr/unique.h"
+
+// Adaptive radix tree over byte-string keys (Leis et al.). Inner nodes grow
+// through four layouts as they gain children: Node4 and Node16 keep sorted
+// key bytes (Node16 is searched with one SSE2 compare), Node48 maps a byte
+// to one of 48 slots, and Node256 indexes children directly. Every child is
+// owned by a UniquePtr whose deleter dispatches on the node type, so there
+// are no virtual calls on the lookup path.
+//
+// Path compression: a run of single-child levels collapses into the prefix
+// of the next inner node. Lazy expansion: a key gets a leaf as soon as it is
+// unique, and the leaf keeps the whole key inline, so lookups compare the rest of
+// the key once at the end. A key that ends inside the tree hangs off the
+// terminal slot of the inner node where it ends.
+template <typename V>
+class AdaptiveRadixTree
+{
+private:
+    enum class NodeType : std::uint8_t
+    {
+        leaf,
+        node4,
+        node16,
+        node48,
+        node256
+    };
+
+    struct Node
+    {
+        NodeType type;
+    };
+
+    struct NodeDelete
+    {
+        void operator()(Node* node) const noexcept;
+    };
+
+    typedef UniquePtr<Node, NodeDelete> NodePtr;
+
+    // The key bytes follow the leaf in the same allocation.
+    struct Leaf : Node
+    {
+        std::uint32_t length;
+        V value;
+
+        std::string_view key() const noexcept;
+    };
+
+    struct Inner : Node
+    {
+        std::uint16_t count;
+        std::string prefix;
+        NodePtr terminal;
+    };
+
+    struct Node4 : Inner
+    {
+        std::uint8_t keys[4];
+        NodePtr children[4];
+    };
+
+    struct Node16 : Inner
+    {
+        std::uint8_t keys[16];
+        NodePtr children[16];
+    };
+
+    struct Node48 : Inner
+    {
+        // Slot + 1 for every present byte, 0 for absent ones.
+        std::uint8_t index[256];
+        NodePtr children[48];
+    };
+
+    struct Node256 : Inner
+    {
+        NodePtr children[256];
+    };
+
+public:
+    AdaptiveRadixTree() noexcept;
+    AdaptiveRadixTree(const AdaptiveRadixTree&) = delete;
+    AdaptiveRadixTree& operator=(const AdaptiveRadixTree&) = delete;
+
+    // Inserts or overwrites; true if the key was new.
+    bool insert(std::string_view key, const V& value);
+    V* find(std::string_view key) noexcept;
+    const V* find(std::string_view key) const noexcept;
+    bool contains(std::string_view key) const noexcept;
+    // Calls func(std::string_view key, const V& value) for every key starting
+    // with prefix, in lexicographic byte order.
+    template <typename Func>
+    void scan_prefix(std::string_view prefix, Func func) const;
+
+    std::size_t size() const noexcept;
+    bool empty() const noexcept;
+
+private:
+    NodePtr root;
+    std::size_t count;
+
+    static NodePtr make_leaf(std::string_view key, const V& value);
+    static void destroy_leaf(Leaf* leaf) noexcept;
+    static std::size_t common_prefix(std::string_view left, std::string_view right) noexcept;
+    static NodePtr* find_child(Inner* node, std::uint8_t byte) noexcept;
+    static bool full(const Inner* node) noexcept;
+    static void add_child(Inner* node, std::uint8_t byte, NodePtr child);
+    static void grow(NodePtr& slot);
+    static void place(Inner* node, std::string_view key, std::size_t depth, NodePtr child);
+    bool insert(NodePtr& slot, std::string_view key, std::size_t depth, const V& value);
+    template <typename Func>
+    static void visit(const Node* node, Func& func);
+};
+
+#include "art-inl.h"
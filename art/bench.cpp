@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "art.h"
+
+
+class ArtIndex
+{
+private:
+    AdaptiveRadixTree<long> tree;
+
+public:
+    void insert(const std::string& key, long value)
+    {
+        tree.insert(key, value);
+    }
+
+    const long* find(const std::string& key) const
+    {
+        return tree.find(key);
+    }
+
+    template <typename Func>
+    void scan_prefix(const std::string& prefix, Func func) const
+    {
+        tree.scan_prefix(prefix, func);
+    }
+};
+
+
+class MapIndex
+{
+private:
+    std::map<std::string, long> map;
+
+public:
+    void insert(const std::string& key, long value)
+    {
+        map[key] = value;
+    }
+
+    const long* find(const std::string& key) const
+    {
+        auto it = map.find(key);
+        return it == map.end() ? nullptr : &it->second;
+    }
+
+    template <typename Func>
+    void scan_prefix(const std::string& prefix, Func func) const
+    {
+        for (auto it = map.lower_bound(prefix); it != map.end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it)
+            func(it->first, it->second);
+    }
+};
+
+
+// A hash table has no order, so a prefix scan has to look at every key.
+class HashIndex
+{
+private:
+    std::unordered_map<std::string, long> map;
+
+public:
+    void insert(const std::string& key, long value)
+    {
+        map[key] = value;
+    }
+
+    const long* find(const std::string& key) const
+    {
+        auto it = map.find(key);
+        return it == map.end() ? nullptr : &it->second;
+    }
+
+    template <typename Func>
+    void scan_prefix(const std::string& prefix, Func func) const
+    {
+        for (const auto& entry : map)
+        {
+            if (entry.first.compare(0, prefix.size(), prefix) == 0)
+                func(entry.first, entry.second);
+        }
+    }
+};
+
+
+// Keys shaped like "tenant/0042/user/00031337/session": shared leading
+// segments with a dense numeric tail, as in typical string-keyed indexes.
+std::vector<std::string> make_keys(std::size_t count)
+{
+    std::mt19937_64 random(42);
+    static const char* const kinds[] = {"user", "order", "session", "invoice"};
+    std::vector<std::string> keys;
+    keys.reserve(count);
+    char buffer[96];
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const unsigned tenant = static_cast<unsigned>(random() % 1000);
+        std::snprintf(buffer, sizeof(buffer), "tenant/%04u/%s/%08llx", tenant, kinds[random() % 4],
+                      static_cast<unsigned long long>(random() % 0xffffffffull));
+        keys.emplace_back(buffer);
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    std::shuffle(keys.begin(), keys.end(), random);
+    return keys;
+}
+
+
+double since(std::chrono::steady_clock::time_point start, std::size_t operations)
+{
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / operations;
+}
+
+
+template <typename Index>
+void run(const char* name, const std::vector<std::string>& keys, std::size_t lookups, std::size_t scans)
+{
+    Index* index = new Index();
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < keys.size(); ++i)
+        index->insert(keys[i], static_cast<long>(i));
+    const double insert_ns = since(start, keys.size());
+
+    std::mt19937_64 random(3);
+    long sink = 0;
+    start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < lookups; ++i)
+        sink += *index->find(keys[random() % keys.size()]);
+    const double lookup_ns = since(start, lookups);
+
+    // "tenant/0042/user/" selects roughly 1/4000 of the keys.
+    std::size_t matched = 0;
+    start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < scans; ++i)
+    {
+        const std::string& key = keys[random() % keys.size()];
+        index->scan_prefix(key.substr(0, key.rfind('/') + 1), [&](std::string_view, long value) {
+            sink += value;
+            ++matched;
+        });
+    }
+    const double scan_us = since(start, scans) / 1000;
+
+    delete index;
+    std::printf("%-22s %12.1f %12.1f %14.1f %10zu\n", name, insert_ns, lookup_ns, scan_us, matched / std::max<std::size_t>(scans, 1));
+    if (sink == 42)
+        std::printf(" ");
+}
+
+
+int main(int argc, char** argv)
+{
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+    const std::size_t lookups = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 2000000;
+    const std::size_t scans = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 2000;
+
+    const std::vector<std::string> keys = make_keys(count);
+    std::printf("%zu keys, %zu lookups, %zu prefix scans\n", keys.size(), lookups, scans);
+    std::printf("%-22s %12s %12s %14s %10s\n", "index", "insert ns", "lookup ns", "scan us", "keys/scan");
+    run<ArtIndex>("AdaptiveRadixTree", keys, lookups, scans);
+    run<MapIndex>("std::map", keys, lookups, scans);
+    run<HashIndex>("std::unordered_map", keys, lookups, scans / 100);
+    return 0;
+}
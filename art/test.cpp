@@ -0,0 +1,162 @@
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "art.h"
+
+
+std::vector<std::string> collect(const AdaptiveRadixTree<int>& tree, const std::string& prefix)
+{
+    std::vector<std::string> keys;
+    tree.scan_prefix(prefix, [&keys](std::string_view key, int) { keys.emplace_back(key); });
+    return keys;
+}
+
+
+TEST(AdaptiveRadixTreeTest, InsertFindOverwrite)
+{
+    AdaptiveRadixTree<int> tree;
+    EXPECT_TRUE(tree.empty());
+    EXPECT_EQ(tree.find("a"), nullptr);
+    EXPECT_TRUE(tree.insert("hello", 1));
+    EXPECT_TRUE(tree.insert("help", 2));
+    EXPECT_FALSE(tree.insert("hello", 3));
+    EXPECT_EQ(tree.size(), 2u);
+    EXPECT_EQ(*tree.find("hello"), 3);
+    EXPECT_EQ(*tree.find("help"), 2);
+    EXPECT_FALSE(tree.contains("hel"));
+    EXPECT_FALSE(tree.contains("helpers"));
+    EXPECT_FALSE(tree.contains("hellO"));
+}
+
+
+struct ThrowingValue
+{
+    static bool fail;
+    int value;
+
+    explicit ThrowingValue(int value) : value(value) {}
+    ThrowingValue(const ThrowingValue& other) : value(other.value)
+    {
+        if (fail)
+            throw std::runtime_error("copy failed");
+    }
+    ThrowingValue& operator=(const ThrowingValue&) = default;
+};
+
+bool ThrowingValue::fail = false;
+
+
+TEST(AdaptiveRadixTreeTest, FailedInsertKeepsExistingKeys)
+{
+    AdaptiveRadixTree<ThrowingValue> tree;
+    ThrowingValue::fail = false;
+    ASSERT_TRUE(tree.insert("apple", ThrowingValue(1)));
+
+    // Expanding the root leaf into a Node4.
+    ThrowingValue::fail = true;
+    EXPECT_THROW(tree.insert("apricot", ThrowingValue(2)), std::runtime_error);
+    ThrowingValue::fail = false;
+    EXPECT_EQ(tree.size(), 1u);
+    ASSERT_NE(tree.find("apple"), nullptr);
+    ASSERT_TRUE(tree.insert("apricot", ThrowingValue(2)));
+
+    // Splitting the compressed "ap" path.
+    ThrowingValue::fail = true;
+    EXPECT_THROW(tree.insert("banana", ThrowingValue(3)), std::runtime_error);
+    ThrowingValue::fail = false;
+    EXPECT_EQ(tree.size(), 2u);
+    ASSERT_NE(tree.find("apple"), nullptr);
+    ASSERT_NE(tree.find("apricot"), nullptr);
+    EXPECT_EQ(tree.find("apple")->value, 1);
+    EXPECT_EQ(tree.find("apricot")->value, 2);
+    EXPECT_FALSE(tree.contains("banana"));
+}
+
+TEST(AdaptiveRadixTreeTest, KeysThatArePrefixesOfOthers)
+{
+    AdaptiveRadixTree<int> tree;
+    EXPECT_TRUE(tree.insert("abcdef", 1));
+    EXPECT_TRUE(tree.insert("abc", 2));
+    EXPECT_TRUE(tree.insert("", 3));
+    EXPECT_TRUE(tree.insert("ab", 4));
+    EXPECT_TRUE(tree.insert("abcdeg", 5));
+    EXPECT_FALSE(tree.insert("abc", 6));
+    EXPECT_EQ(*tree.find("abcdef"), 1);
+    EXPECT_EQ(*tree.find("abc"), 6);
+    EXPECT_EQ(*tree.find(""), 3);
+    EXPECT_EQ(*tree.find("ab"), 4);
+    EXPECT_EQ(*tree.find("abcdeg"), 5);
+    EXPECT_FALSE(tree.contains("abcd"));
+    EXPECT_EQ(tree.size(), 5u);
+}
+
+
+TEST(AdaptiveRadixTreeTest, NodesGrowThroughEveryLayout)
+{
+    AdaptiveRadixTree<int> tree;
+    for (int byte = 255; byte >= 0; --byte)
+    {
+        std::string key = "k";
+        key.push_back(static_cast<char>(byte));
+        EXPECT_TRUE(tree.insert(key, byte));
+        for (int check = byte; check < 256; check += 37)
+        {
+            std::string probe = "k";
+            probe.push_back(static_cast<char>(check));
+            ASSERT_NE(tree.find(probe), nullptr) << byte << " " << check;
+            EXPECT_EQ(*tree.find(probe), check);
+        }
+    }
+    std::vector<std::string> keys = collect(tree, "k");
+    ASSERT_EQ(keys.size(), 256u);
+    for (int byte = 0; byte < 256; ++byte)
+        EXPECT_EQ(static_cast<unsigned char>(keys[byte][1]), byte);
+}
+
+
+TEST(AdaptiveRadixTreeTest, PrefixScanIsOrderedAndComplete)
+{
+    AdaptiveRadixTree<int> tree;
+    for (const char* key : {"user:1", "user:10", "user:2", "users", "use", "admin", "user:1:profile"})
+        tree.insert(key, 0);
+
+    EXPECT_EQ(collect(tree, "user:"), (std::vector<std::string>{"user:1", "user:10", "user:1:profile", "user:2"}));
+    EXPECT_EQ(collect(tree, "user"), (std::vector<std::string>{"user:1", "user:10", "user:1:profile", "user:2", "users"}));
+    EXPECT_EQ(collect(tree, "us"), (std::vector<std::string>{"use", "user:1", "user:10", "user:1:profile", "user:2", "users"}));
+    EXPECT_EQ(collect(tree, "user:1:"), (std::vector<std::string>{"user:1:profile"}));
+    EXPECT_EQ(collect(tree, "x").size(), 0u);
+    EXPECT_EQ(collect(tree, "user:3").size(), 0u);
+    EXPECT_EQ(collect(tree, "").size(), 7u);
+}
+
+
+TEST(AdaptiveRadixTreeTest, MatchesStdMapOnRandomKeys)
+{
+    AdaptiveRadixTree<int> tree;
+    std::map<std::string, int> expected;
+    std::mt19937 random(11);
+    for (int i = 0; i < 50000; ++i)
+    {
+        std::string key;
+        const int length = static_cast<int>(random() % 12);
+        for (int j = 0; j < length; ++j)
+            key.push_back(static_cast<char>("abcxyz\0\xff"[random() % 8]));
+        EXPECT_EQ(tree.insert(key, i), expected.insert_or_assign(key, i).second);
+    }
+    EXPECT_EQ(tree.size(), expected.size());
+
+    std::vector<std::pair<std::string, int>> all;
+    tree.scan_prefix("", [&all](std::string_view key, int value) { all.emplace_back(key, value); });
+    EXPECT_EQ(all, (std::vector<std::pair<std::string, int>>(expected.begin(), expected.end())));
+
+    for (const auto& entry : expected)
+    {
+        const int* value = tree.find(entry.first);
+        ASSERT_NE(value, nullptr);
+        EXPECT_EQ(*value, entry.second);
+        EXPECT_FALSE(tree.contains(entry.first + "q"));
+    }
+}
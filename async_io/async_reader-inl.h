@@ -0,0 +1,358 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <system_error>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+inline void ReturnToPool::operator()(Buffer* const buffer) const noexcept
+{
+    pool->release(buffer);
+}
+
+inline BufferPool::BufferPool(const std::size_t buffer_size, const int buffer_count)
+{
+    const std::size_t page = 4096;
+    buffers.resize(static_cast<std::size_t>(buffer_count));
+    free_list.reserve(buffers.size());
+    for (int i = 0; i < buffer_count; ++i)
+    {
+        Buffer& buffer = buffers[static_cast<std::size_t>(i)];
+        buffer.data = static_cast<std::uint8_t*>(std::aligned_alloc(page, (buffer_size + page - 1) / page * page));
+        if (buffer.data == nullptr)
+        {
+            for (int j = 0; j < i; ++j)
+                std::free(buffers[static_cast<std::size_t>(j)].data);
+            throw std::bad_alloc();
+        }
+        buffer.capacity = buffer_size;
+        buffer.size = 0;
+        buffer.done = 0;
+        buffer.offset = 0;
+        buffer.tag = 0;
+        buffer.error = 0;
+        buffer.index = i;
+        buffer.fd = -1;
+        free_list.push_back(&buffer);
+    }
+}
+
+inline BufferPool::~BufferPool() noexcept
+{
+    for (Buffer& buffer : buffers)
+        std::free(buffer.data);
+}
+
+inline Buffer* BufferPool::acquire() noexcept
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (free_list.empty())
+        return nullptr;
+    Buffer* buffer = free_list.back();
+    free_list.pop_back();
+    return buffer;
+}
+
+inline void BufferPool::release(Buffer* const buffer) noexcept
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    free_list.push_back(buffer);
+}
+
+inline int BufferPool::available() noexcept
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return static_cast<int>(free_list.size());
+}
+
+inline std::vector<Buffer>& BufferPool::all() noexcept
+{
+    return buffers;
+}
+
+inline ReadBackend::~ReadBackend() noexcept
+{}
+
+inline UringBackend::UringBackend(BufferPool& pool, const unsigned entries)
+{
+    sq_map = MAP_FAILED;
+    cq_map = MAP_FAILED;
+    sqe_map = MAP_FAILED;
+    pending = 0;
+
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    ring = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    if (ring < 0)
+        throw std::system_error(errno, std::generic_category(), "io_uring_setup");
+
+    sq_map_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_map_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single)
+        sq_map_size = cq_map_size = std::max(sq_map_size, cq_map_size);
+    sqe_map_size = params.sq_entries * sizeof(io_uring_sqe);
+
+    sq_map = mmap(nullptr, sq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_SQ_RING);
+    if (sq_map != MAP_FAILED)
+        cq_map = single ? sq_map : mmap(nullptr, cq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_CQ_RING);
+    if (cq_map != MAP_FAILED)
+        sqe_map = mmap(nullptr, sqe_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_SQES);
+    if (sqe_map == MAP_FAILED)
+    {
+        int error = errno;
+        unmap();
+        close(ring);
+        throw std::system_error(error, std::generic_category(), "io_uring mmap");
+    }
+
+    char* sq = static_cast<char*>(sq_map);
+    char* cq = static_cast<char*>(cq_map);
+    sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sq_mask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cq_mask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes = cq + params.cq_off.cqes;
+
+    // Fixed buffers skip the per-read page pinning; without them (for
+    // example under a low RLIMIT_MEMLOCK) plain reads still work.
+    std::vector<iovec> vectors;
+    for (Buffer& buffer : pool.all())
+        vectors.push_back(iovec{buffer.data, buffer.capacity});
+    registered = syscall(__NR_io_uring_register, ring, IORING_REGISTER_BUFFERS, vectors.data(), vectors.size()) == 0;
+}
+
+inline UringBackend::~UringBackend() noexcept
+{
+    unmap();
+    close(ring);
+}
+
+inline void UringBackend::unmap() noexcept
+{
+    if (sqe_map != MAP_FAILED)
+        munmap(sqe_map, sqe_map_size);
+    if (cq_map != MAP_FAILED && cq_map != sq_map)
+        munmap(cq_map, cq_map_size);
+    if (sq_map != MAP_FAILED)
+        munmap(sq_map, sq_map_size);
+}
+
+inline void UringBackend::submit(Buffer* const buffer)
+{
+    const unsigned tail = *sq_tail;
+    const unsigned index = tail & *sq_mask;
+
+    io_uring_sqe* sqe = static_cast<io_uring_sqe*>(sqe_map) + index;
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = registered ? IORING_OP_READ_FIXED : IORING_OP_READ;
+    sqe->fd = buffer->fd;
+    sqe->addr = reinterpret_cast<std::uint64_t>(buffer->data + buffer->done);
+    sqe->len = static_cast<std::uint32_t>(buffer->size - buffer->done);
+    sqe->off = static_cast<std::uint64_t>(buffer->offset) + buffer->done;
+    sqe->buf_index = registered ? static_cast<std::uint16_t>(buffer->index) : 0;
+    sqe->user_data = reinterpret_cast<std::uint64_t>(buffer);
+
+    sq_array[index] = index;
+    __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+    ++pending;
+}
+
+inline Buffer* UringBackend::complete(const bool block)
+{
+    for (;;)
+    {
+        const unsigned head = *cq_head;
+        if (head != __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE))
+        {
+            io_uring_cqe* cqe = static_cast<io_uring_cqe*>(cqes) + (head & *cq_mask);
+            Buffer* buffer = reinterpret_cast<Buffer*>(cqe->user_data);
+            const int result = cqe->res;
+            __atomic_store_n(cq_head, head + 1, __ATOMIC_RELEASE);
+
+            // Like the pread loop in ThreadPoolBackend, a short read is not
+            // the end: the remainder goes back to the ring until the range
+            // is full, the file ends or the read fails.
+            if (result == -EINTR || (result > 0 && buffer->done + static_cast<std::size_t>(result) < buffer->size))
+            {
+                buffer->done += result > 0 ? static_cast<std::size_t>(result) : 0;
+                submit(buffer);
+                continue;
+            }
+
+            buffer->error = result < 0 ? -result : 0;
+            buffer->size = buffer->done + (result < 0 ? 0 : static_cast<std::size_t>(result));
+            return buffer;
+        }
+        if (!block && pending == 0)
+            return nullptr;
+
+        // Submissions queued since the last call go to the kernel together
+        // with the wait for completions.
+        long result = syscall(__NR_io_uring_enter, ring, pending, block ? 1 : 0, block ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+        if (result < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            throw std::system_error(errno, std::generic_category(), "io_uring_enter");
+        }
+        pending -= static_cast<unsigned>(result);
+    }
+}
+
+inline ThreadPoolBackend::ThreadPoolBackend(const int threads)
+{
+    stopping = false;
+    for (int i = 0; i < threads; ++i)
+        workers.emplace_back(&ThreadPoolBackend::run, this);
+}
+
+inline ThreadPoolBackend::~ThreadPoolBackend() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    requested.notify_all();
+    for (std::thread& worker : workers)
+        worker.join();
+}
+
+inline void ThreadPoolBackend::run() noexcept
+{
+    for (;;)
+    {
+        Buffer* buffer;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            requested.wait(lock, [this]() { return stopping || !requests.empty(); });
+            if (stopping)
+                return;
+            buffer = requests.front();
+            requests.pop_front();
+        }
+
+        std::size_t done = 0;
+        buffer->error = 0;
+        while (done < buffer->size)
+        {
+            ssize_t result = pread(buffer->fd, buffer->data + done, buffer->size - done, buffer->offset + static_cast<off_t>(done));
+            if (result < 0 && errno == EINTR)
+                continue;
+            if (result < 0)
+                buffer->error = errno;
+            if (result <= 0)
+                break;
+            done += static_cast<std::size_t>(result);
+        }
+        buffer->size = done;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            completions.push_back(buffer);
+        }
+        completed.notify_one();
+    }
+}
+
+inline void ThreadPoolBackend::submit(Buffer* const buffer)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        requests.push_back(buffer);
+    }
+    requested.notify_one();
+}
+
+inline Buffer* ThreadPoolBackend::complete(const bool block)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    if (block)
+        completed.wait(lock, [this]() { return !completions.empty(); });
+    if (completions.empty())
+        return nullptr;
+    Buffer* buffer = completions.front();
+    completions.pop_front();
+    return buffer;
+}
+
+inline AsyncFileReader::AsyncFileReader(const std::size_t buffer_size, const int buffer_count, const ReadBackendKind kind)
+    : pool(buffer_size, buffer_count)
+{
+    uring = false;
+    outstanding = 0;
+
+    if (kind != ReadBackendKind::thread_pool)
+    {
+        try
+        {
+            backend = UniquePtr<ReadBackend>(new UringBackend(pool, static_cast<unsigned>(buffer_count)));
+            uring = true;
+        }
+        catch (const std::system_error&)
+        {
+            if (kind == ReadBackendKind::io_uring)
+                throw;
+        }
+    }
+    if (!backend)
+        backend = UniquePtr<ReadBackend>(new ThreadPoolBackend(std::min(buffer_count, 4)));
+}
+
+inline bool AsyncFileReader::submit(const int fd, const off_t offset, const std::size_t length, const std::uint64_t tag)
+{
+    Buffer* buffer = pool.acquire();
+    if (buffer == nullptr)
+        return false;
+
+    buffer->fd = fd;
+    buffer->offset = offset;
+    buffer->size = std::min(length, buffer->capacity);
+    buffer->done = 0;
+    buffer->tag = tag;
+    buffer->error = 0;
+
+    backend->submit(buffer);
+    ++outstanding;
+    return true;
+}
+
+inline BufferPtr AsyncFileReader::wait()
+{
+    if (outstanding == 0)
+        return BufferPtr(nullptr, ReturnToPool{&pool});
+
+    Buffer* buffer = backend->complete(true);
+    --outstanding;
+    return BufferPtr(buffer, ReturnToPool{&pool});
+}
+
+inline BufferPtr AsyncFileReader::poll()
+{
+    Buffer* buffer = outstanding == 0 ? nullptr : backend->complete(false);
+    if (buffer)
+        --outstanding;
+    return BufferPtr(buffer, ReturnToPool{&pool});
+}
+
+inline bool AsyncFileReader::uses_io_uring() const noexcept
+{
+    return uring;
+}
+
+inline int AsyncFileReader::in_flight() const noexcept
+{
+    return outstanding;
+}
+
+inline int AsyncFileReader::available() noexcept
+{
+    return pool.available();
+}
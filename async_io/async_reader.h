@@ -0,0 +1,151 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <sys/types.h>
+#include "../unique_ptr/unique.h"
+
+class BufferPool;
+
+class Buffer
+{
+public:
+    std::uint8_t* data;
+    std::size_t capacity;
+    std::size_t size;
+    std::size_t done;
+    off_t offset;
+    std::uint64_t tag;
+    int error;
+    int index;
+    int fd;
+};
+
+class ReturnToPool
+{
+public:
+    BufferPool* pool;
+
+    void operator()(Buffer* buffer) const noexcept;
+};
+
+typedef UniquePtr<Buffer, ReturnToPool> BufferPtr;
+
+// Fixed set of page-aligned buffers. Buffers handed out as BufferPtr come
+// back here when the caller drops them, from whatever thread that happens on.
+class BufferPool
+{
+private:
+    std::vector<Buffer> buffers;
+    std::vector<Buffer*> free_list;
+    std::mutex mutex;
+
+public:
+    BufferPool(std::size_t buffer_size, int buffer_count);
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+    ~BufferPool() noexcept;
+
+    Buffer* acquire() noexcept;
+    void release(Buffer* buffer) noexcept;
+    int available() noexcept;
+    std::vector<Buffer>& all() noexcept;
+};
+
+class ReadBackend
+{
+public:
+    virtual ~ReadBackend() noexcept;
+    virtual void submit(Buffer* buffer) = 0;
+    virtual Buffer* complete(bool block) = 0;
+};
+
+class UringBackend : public ReadBackend
+{
+private:
+    int ring;
+    bool registered;
+    void* sq_map;
+    std::size_t sq_map_size;
+    void* cq_map;
+    std::size_t cq_map_size;
+    void* sqe_map;
+    std::size_t sqe_map_size;
+
+    unsigned* sq_tail;
+    unsigned* sq_mask;
+    unsigned* sq_array;
+    unsigned* cq_head;
+    unsigned* cq_tail;
+    unsigned* cq_mask;
+    void* cqes;
+    unsigned pending;
+
+    void unmap() noexcept;
+
+public:
+    UringBackend(BufferPool& pool, unsigned entries);
+    ~UringBackend() noexcept override;
+
+    void submit(Buffer* buffer) override;
+    Buffer* complete(bool block) override;
+};
+
+class ThreadPoolBackend : public ReadBackend
+{
+private:
+    std::vector<std::thread> workers;
+    std::deque<Buffer*> requests;
+    std::deque<Buffer*> completions;
+    std::mutex mutex;
+    std::condition_variable requested;
+    std::condition_variable completed;
+    bool stopping;
+
+    void run() noexcept;
+
+public:
+    explicit ThreadPoolBackend(int threads);
+    ~ThreadPoolBackend() noexcept override;
+
+    void submit(Buffer* buffer) override;
+    Buffer* complete(bool block) override;
+};
+
+enum class ReadBackendKind
+{
+    automatic,
+    io_uring,
+    thread_pool
+};
+
+// Reads file ranges asynchronously into pooled buffers. Each completed read
+// is handed to the caller as a BufferPtr, and the buffer becomes available
+// for new reads once that pointer is destroyed. BufferPtrs must not outlive
+// the reader.
+class AsyncFileReader
+{
+private:
+    BufferPool pool;
+    UniquePtr<ReadBackend> backend;
+    bool uring;
+    int outstanding;
+
+public:
+    AsyncFileReader(std::size_t buffer_size, int buffer_count, ReadBackendKind kind = ReadBackendKind::automatic);
+
+    bool submit(int fd, off_t offset, std::size_t length, std::uint64_t tag = 0);
+    BufferPtr wait();
+    BufferPtr poll();
+
+    bool uses_io_uring() const noexcept;
+    int in_flight() const noexcept;
+    int available() noexcept;
+};
+
+#include "async_reader-inl.h"
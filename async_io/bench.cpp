@@ -0,0 +1,119 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include "async_reader.h"
+
+
+double seconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+void generate(const char* path, std::size_t size)
+{
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    std::vector<char> block(1 << 20, 'x');
+    for (std::size_t written = 0; written < size; written += block.size())
+    {
+        if (write(fd, block.data(), block.size()) < 0)
+            break;
+    }
+    close(fd);
+}
+
+
+std::uint64_t checksum(const std::uint8_t* data, std::size_t size)
+{
+    std::uint64_t sum = 0;
+    for (std::size_t i = 0; i < size; i += 64)
+        sum += data[i];
+    return sum;
+}
+
+
+std::uint64_t read_pread(const char* path, std::size_t block, std::size_t& bytes)
+{
+    int fd = open(path, O_RDONLY);
+    std::vector<std::uint8_t> buffer(block);
+    std::uint64_t sum = 0;
+    off_t offset = 0;
+    ssize_t got;
+    while ((got = pread(fd, buffer.data(), block, offset)) > 0)
+    {
+        sum += checksum(buffer.data(), static_cast<std::size_t>(got));
+        offset += got;
+    }
+    close(fd);
+    bytes = static_cast<std::size_t>(offset);
+    return sum;
+}
+
+
+std::uint64_t read_async(const char* path, std::size_t block, int depth, ReadBackendKind kind, std::size_t& bytes)
+{
+    int fd = open(path, O_RDONLY);
+    const off_t size = lseek(fd, 0, SEEK_END);
+    AsyncFileReader reader(block, depth, kind);
+
+    std::uint64_t sum = 0;
+    off_t next = 0;
+    bytes = 0;
+    for (;;)
+    {
+        while (next < size && reader.submit(fd, next, block))
+            next += static_cast<off_t>(block);
+        BufferPtr buffer = reader.wait();
+        if (!buffer)
+            break;
+        sum += checksum(buffer->data, buffer->size);
+        bytes += buffer->size;
+    }
+    close(fd);
+    return sum;
+}
+
+
+int main(int argc, char** argv)
+{
+    const std::size_t size = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : (1ull << 30);
+    const char* path = argc > 2 ? argv[2] : "/tmp/async_io_bench.bin";
+    const std::size_t block = 128 << 10;
+    const int depth = 32;
+
+    generate(path, size);
+
+    std::printf("%-14s %10s %10s\n", "mode", "seconds", "GB/s");
+    for (int round = 0; round < 3; ++round)
+    {
+        std::size_t bytes = 0;
+        auto start = std::chrono::steady_clock::now();
+        std::uint64_t expected = read_pread(path, block, bytes);
+        double seconds = seconds_since(start);
+        std::printf("%-14s %10.3f %10.2f\n", "pread", seconds, bytes / seconds / 1e9);
+
+        const ReadBackendKind kinds[] = {ReadBackendKind::io_uring, ReadBackendKind::thread_pool};
+        const char* names[] = {"io_uring", "thread pool"};
+        for (int k = 0; k < 2; ++k)
+        {
+            try
+            {
+                start = std::chrono::steady_clock::now();
+                std::uint64_t sum = read_async(path, block, depth, kinds[k], bytes);
+                seconds = seconds_since(start);
+                std::printf("%-14s %10.3f %10.2f%s\n", names[k], seconds, bytes / seconds / 1e9, sum == expected ? "" : " checksum mismatch");
+            }
+            catch (const std::exception& error)
+            {
+                std::printf("%-14s unavailable: %s\n", names[k], error.what());
+            }
+        }
+    }
+    if (argc <= 2)
+        std::remove(path);
+    return 0;
+}
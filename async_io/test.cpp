@@ -0,0 +1,152 @@
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include "async_reader.h"
+
+
+class AsyncFileReaderTest : public ::testing::TestWithParam<ReadBackendKind>
+{
+protected:
+    std::FILE* file;
+    int fd;
+    std::vector<std::uint8_t> content;
+
+    void SetUp() override
+    {
+        content.resize(1 << 20);
+        for (std::size_t i = 0; i < content.size(); ++i)
+            content[i] = static_cast<std::uint8_t>(i * 7 + i / 4096);
+
+        file = std::tmpfile();
+        ASSERT_NE(file, nullptr);
+        fd = fileno(file);
+        ASSERT_EQ(write(fd, content.data(), content.size()), static_cast<ssize_t>(content.size()));
+    }
+
+    void TearDown() override
+    {
+        std::fclose(file);
+    }
+};
+
+INSTANTIATE_TEST_SUITE_P(Backends, AsyncFileReaderTest,
+                         ::testing::Values(ReadBackendKind::automatic, ReadBackendKind::thread_pool));
+
+
+TEST_P(AsyncFileReaderTest, ReadsWholeFile)
+{
+    const std::size_t chunk = 64 << 10;
+    AsyncFileReader reader(chunk, 4, GetParam());
+
+    std::size_t next = 0;
+    std::size_t verified = 0;
+    while (verified < content.size())
+    {
+        while (next < content.size() && reader.submit(fd, static_cast<off_t>(next), chunk, next))
+            next += chunk;
+
+        BufferPtr buffer = reader.wait();
+        ASSERT_TRUE(buffer);
+        ASSERT_EQ(buffer->error, 0);
+        ASSERT_EQ(buffer->size, chunk);
+        ASSERT_EQ(static_cast<std::size_t>(buffer->offset), buffer->tag);
+        EXPECT_EQ(std::memcmp(buffer->data, content.data() + buffer->tag, chunk), 0);
+        verified += buffer->size;
+    }
+    EXPECT_EQ(reader.in_flight(), 0);
+    EXPECT_FALSE(reader.wait());
+}
+
+
+TEST_P(AsyncFileReaderTest, BufferReturnsToPoolOnDestruction)
+{
+    AsyncFileReader reader(4096, 2, GetParam());
+    EXPECT_EQ(reader.available(), 2);
+
+    ASSERT_TRUE(reader.submit(fd, 0, 4096));
+    ASSERT_TRUE(reader.submit(fd, 4096, 4096));
+    EXPECT_FALSE(reader.submit(fd, 8192, 4096));
+
+    BufferPtr first = reader.wait();
+    BufferPtr second = reader.wait();
+    EXPECT_EQ(reader.available(), 0);
+
+    first.reset();
+    EXPECT_EQ(reader.available(), 1);
+
+    BufferPtr moved(std::move(second));
+    EXPECT_EQ(reader.available(), 1);
+    moved.reset();
+    EXPECT_EQ(reader.available(), 2);
+}
+
+
+TEST_P(AsyncFileReaderTest, ShortReadAtEndOfFile)
+{
+    AsyncFileReader reader(8192, 1, GetParam());
+
+    ASSERT_TRUE(reader.submit(fd, static_cast<off_t>(content.size() - 100), 8192));
+    BufferPtr buffer = reader.wait();
+
+    EXPECT_EQ(buffer->error, 0);
+    EXPECT_EQ(buffer->size, 100u);
+    EXPECT_EQ(std::memcmp(buffer->data, content.data() + content.size() - 100, 100), 0);
+}
+
+
+TEST_P(AsyncFileReaderTest, ErrorIsReported)
+{
+    AsyncFileReader reader(4096, 1, GetParam());
+
+    ASSERT_TRUE(reader.submit(-1, 0, 4096));
+    BufferPtr buffer = reader.wait();
+
+    EXPECT_EQ(buffer->error, EBADF);
+    EXPECT_EQ(buffer->size, 0u);
+}
+
+
+TEST_P(AsyncFileReaderTest, PollDoesNotBlock)
+{
+    AsyncFileReader reader(4096, 1, GetParam());
+    EXPECT_FALSE(reader.poll());
+
+    ASSERT_TRUE(reader.submit(fd, 0, 4096));
+    BufferPtr buffer;
+    while (!(buffer = reader.poll()))
+    {}
+    EXPECT_EQ(buffer->size, 4096u);
+    EXPECT_EQ(reader.in_flight(), 0);
+}
+
+
+TEST(UringBackendTest, ShortReadIsResubmitted)
+{
+    AsyncFileReader reader(8, 1);
+    if (!reader.uses_io_uring())
+        GTEST_SKIP() << "io_uring not available";
+
+    // A pipe hands back whatever it holds, so the first read comes up short
+    // and the rest has to be read once the second half is written.
+    int pipe_fds[2];
+    ASSERT_EQ(pipe(pipe_fds), 0);
+    ASSERT_EQ(write(pipe_fds[1], "abcd", 4), 4);
+
+    ASSERT_TRUE(reader.submit(pipe_fds[0], 0, 8));
+    std::thread writer([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        EXPECT_EQ(write(pipe_fds[1], "efgh", 4), 4);
+    });
+    BufferPtr buffer = reader.wait();
+    writer.join();
+
+    EXPECT_EQ(buffer->error, 0);
+    ASSERT_EQ(buffer->size, 8u);
+    EXPECT_EQ(std::memcmp(buffer->data, "abcdefgh", 8), 0);
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+}
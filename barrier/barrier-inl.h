@@ -0,0 +1,178 @@
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+#include "../tiny_mutex/futex.h"
+
+inline WaitWord::WaitWord(const int value) noexcept
+{
+    this->value.store(value, std::memory_order_relaxed);
+    sleepers.store(0, std::memory_order_relaxed);
+    // Spinning on a single CPU only delays the thread we are waiting for.
+    spin_limit.store(std::thread::hardware_concurrency() > 1 ? 1024 : 0, std::memory_order_relaxed);
+}
+
+inline int WaitWord::load() const noexcept
+{
+    return value.load(std::memory_order_acquire);
+}
+
+inline void WaitWord::wait(const int old) noexcept
+{
+    const int limit = spin_limit.load(std::memory_order_relaxed);
+    for (int i = 0; i < limit; ++i)
+    {
+        if (value.load(std::memory_order_acquire) != old)
+        {
+            if (limit < max_spins)
+                spin_limit.store(limit * 2, std::memory_order_relaxed);
+            return;
+        }
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#else
+        std::this_thread::yield();
+#endif
+    }
+    if (limit > 16)
+        spin_limit.store(limit / 2, std::memory_order_relaxed);
+
+    sleepers.fetch_add(1, std::memory_order_seq_cst);
+    while (value.load(std::memory_order_seq_cst) == old)
+        futex_wait(value, old);
+    sleepers.fetch_sub(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+}
+
+inline void WaitWord::store_and_wake(const int value) noexcept
+{
+    this->value.store(value, std::memory_order_seq_cst);
+    if (sleepers.load(std::memory_order_seq_cst) != 0)
+        futex_wake(this->value);
+}
+
+inline Latch::Latch(const std::ptrdiff_t expected) noexcept : released(expected <= 0 ? 1 : 0)
+{
+    count.store(expected, std::memory_order_relaxed);
+}
+
+inline void Latch::count_down(const std::ptrdiff_t n) noexcept
+{
+    if (count.fetch_sub(n, std::memory_order_acq_rel) == n)
+        released.store_and_wake(1);
+}
+
+inline bool Latch::try_wait() const noexcept
+{
+    return released.load() != 0;
+}
+
+inline void Latch::wait() noexcept
+{
+    while (released.load() == 0)
+        released.wait(0);
+}
+
+inline void Latch::arrive_and_wait(const std::ptrdiff_t n) noexcept
+{
+    count_down(n);
+    wait();
+}
+
+template <typename Completion>
+Barrier<Completion>::Barrier(const std::size_t participants, Completion completion)
+    : nodes(0), completion(std::move(completion))
+{
+    if (participants == 0)
+        throw std::invalid_argument("Barrier needs at least one participant");
+
+    total = participants;
+    leaves = (participants + fan_in - 1) / fan_in;
+
+    std::vector<std::size_t> expected;
+    for (std::size_t i = 0; i < leaves; ++i)
+        expected.push_back(participants / leaves + (i < participants % leaves ? 1 : 0));
+
+    // Levels are laid out one after another, leaves first; the last node is
+    // the root.
+    std::vector<std::size_t> parents;
+    std::size_t level_begin = 0;
+    std::size_t level_size = leaves;
+    while (level_size > 1)
+    {
+        const std::size_t next_size = (level_size + fan_in - 1) / fan_in;
+        const std::size_t next_begin = level_begin + level_size;
+        for (std::size_t i = 0; i < level_size; ++i)
+            parents.push_back(next_begin + i / fan_in);
+        for (std::size_t i = 0; i < next_size; ++i)
+            expected.push_back(std::min(fan_in, level_size - i * fan_in));
+        level_begin = next_begin;
+        level_size = next_size;
+    }
+    parents.push_back(npos);
+
+    nodes = std::vector<Node>(expected.size());
+    for (std::size_t i = 0; i < nodes.size(); ++i)
+    {
+        nodes[i].count.store(0, std::memory_order_relaxed);
+        nodes[i].expected = expected[i];
+        nodes[i].parent = parents[i];
+    }
+}
+
+template <typename Completion>
+std::size_t Barrier<Completion>::slot() noexcept
+{
+    static std::atomic<std::size_t> next(0);
+    static thread_local std::size_t mine = next.fetch_add(1, std::memory_order_relaxed);
+    return mine;
+}
+
+template <typename Completion>
+std::size_t Barrier<Completion>::arrive_at_leaf() noexcept
+{
+    // A full leaf sends the thread on to the next one; the leaves hold
+    // exactly one place per participant, so every arrival finds room.
+    std::size_t leaf = slot() % leaves;
+    for (;;)
+    {
+        Node& node = nodes[leaf];
+        std::size_t count = node.count.load(std::memory_order_relaxed);
+        while (count < node.expected)
+        {
+            if (node.count.compare_exchange_weak(count, count + 1, std::memory_order_acq_rel, std::memory_order_relaxed))
+                return count + 1 == node.expected ? leaf : npos;
+        }
+        leaf = (leaf + 1) % leaves;
+    }
+}
+
+template <typename Completion>
+void Barrier<Completion>::arrive_and_wait()
+{
+    const int current = phase.load();
+
+    std::size_t node = arrive_at_leaf();
+    while (node != npos)
+    {
+        const std::size_t parent = nodes[node].parent;
+        if (parent == npos)
+        {
+            completion();
+            for (Node& each : nodes)
+                each.count.store(0, std::memory_order_relaxed);
+            phase.store_and_wake(static_cast<int>(static_cast<unsigned>(current) + 1));
+            return;
+        }
+        node = nodes[parent].count.fetch_add(1, std::memory_order_acq_rel) + 1 == nodes[parent].expected ? parent : npos;
+    }
+
+    while (phase.load() == current)
+        phase.wait(current);
+}
+
+template <typename Completion>
+std::size_t Barrier<Completion>::participants() const noexcept
+{
+    return total;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// A futex word that waiters watch for a change. A waiter spins for a while
+// before it sleeps; the spin limit grows when spinning catches the change
+// and shrinks when the waiter had to sleep anyway. Wakers only make the
+// wake syscall when somebody is asleep.
+class WaitWord
+{
+private:
+    static const int max_spins = 1 << 14;
+
+    std::atomic<int> value;
+    std::atomic<int> sleepers;
+    std::atomic<int> spin_limit;
+
+public:
+    explicit WaitWord(int value = 0) noexcept;
+    WaitWord(const WaitWord&) = delete;
+    WaitWord& operator=(const WaitWord&) = delete;
+
+    int load() const noexcept;
+    void wait(int old) noexcept;
+    void store_and_wake(int value) noexcept;
+};
+
+// Single-use countdown. wait() returns once count_down has been called
+// often enough to bring the counter to zero.
+class Latch
+{
+private:
+    std::atomic<std::ptrdiff_t> count;
+    WaitWord released;
+
+public:
+    explicit Latch(std::ptrdiff_t expected) noexcept;
+    Latch(const Latch&) = delete;
+    Latch& operator=(const Latch&) = delete;
+
+    void count_down(std::ptrdiff_t n = 1) noexcept;
+    bool try_wait() const noexcept;
+    void wait() noexcept;
+    void arrive_and_wait(std::ptrdiff_t n = 1) noexcept;
+};
+
+struct NoCompletion
+{
+    void operator()() const noexcept
+    {
+    }
+};
+
+// Reusable barrier for a fixed number of participants. Arrivals are
+// counted in a combining tree: a thread lands on one of several leaf
+// counters, each on its own cache line, and only the thread that fills a
+// node moves up to its parent. The thread that fills the root runs the
+// completion, resets the tree and releases everybody by bumping the phase.
+template <typename Completion = NoCompletion>
+class Barrier
+{
+private:
+    static constexpr std::size_t fan_in = 4;
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    struct alignas(64) Node
+    {
+        std::atomic<std::size_t> count;
+        std::size_t expected;
+        std::size_t parent;
+    };
+
+    std::vector<Node> nodes;
+    std::size_t leaves;
+    std::size_t total;
+    Completion completion;
+    WaitWord phase;
+
+    std::size_t arrive_at_leaf() noexcept;
+    static std::size_t slot() noexcept;
+
+public:
+    explicit Barrier(std::size_t participants, Completion completion = Completion());
+    Barrier(const Barrier&) = delete;
+    Barrier& operator=(const Barrier&) = delete;
+
+    void arrive_and_wait();
+    std::size_t participants() const noexcept;
+};
+
+#include "barrier-inl.h"
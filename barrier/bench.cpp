@@ -0,0 +1,75 @@
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "barrier.h"
+
+
+// The mutex and condition variable barrier the phase-parallel jobs use today.
+class CondBarrier
+{
+private:
+    std::mutex mutex;
+    std::condition_variable released;
+    std::size_t total;
+    std::size_t waiting;
+    std::size_t phase;
+
+public:
+    explicit CondBarrier(std::size_t participants)
+    {
+        total = participants;
+        waiting = 0;
+        phase = 0;
+    }
+
+    void arrive_and_wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        const std::size_t current = phase;
+        if (++waiting == total)
+        {
+            waiting = 0;
+            ++phase;
+            released.notify_all();
+            return;
+        }
+        released.wait(lock, [&]() { return phase != current; });
+    }
+};
+
+
+template <typename B>
+double round_trip(int threads, int rounds)
+{
+    B barrier(threads);
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&]() {
+            for (int i = 0; i < rounds; ++i)
+                barrier.arrive_and_wait();
+        });
+    }
+    for (std::thread& worker : workers)
+        worker.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return seconds * 1e9 / rounds;
+}
+
+
+int main(int argc, char** argv)
+{
+    const int max_threads = argc > 1 ? std::atoi(argv[1]) : static_cast<int>(std::max(2u, std::thread::hardware_concurrency()));
+    const int rounds = argc > 2 ? std::atoi(argv[2]) : 20000;
+
+    std::printf("%d rounds, ns per barrier phase\n", rounds);
+    std::printf("%8s %16s %16s\n", "threads", "mutex+condvar", "Barrier");
+    for (int threads = 2; threads <= max_threads; threads *= 2)
+        std::printf("%8d %16.0f %16.0f\n", threads, round_trip<CondBarrier>(threads, rounds), round_trip<Barrier<>>(threads, rounds));
+    return 0;
+}
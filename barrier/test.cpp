@@ -0,0 +1,99 @@
+#include <atomic>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "barrier.h"
+
+
+TEST(LatchTest, ReleasesWhenCountReachesZero)
+{
+    Latch latch(3);
+    EXPECT_FALSE(latch.try_wait());
+    latch.count_down();
+    latch.count_down(1);
+    EXPECT_FALSE(latch.try_wait());
+    latch.count_down();
+    EXPECT_TRUE(latch.try_wait());
+    latch.wait();
+}
+
+
+TEST(LatchTest, ZeroCountStartsReleased)
+{
+    Latch latch(0);
+    EXPECT_TRUE(latch.try_wait());
+    latch.wait();
+}
+
+
+TEST(LatchTest, WaitersSeeWorkDoneBeforeCountDown)
+{
+    Latch done(4);
+    std::vector<int> results(4, 0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t)
+    {
+        workers.emplace_back([&, t]() {
+            results[t] = t + 1;
+            done.count_down();
+        });
+    }
+    done.wait();
+    EXPECT_EQ(results, (std::vector<int>{1, 2, 3, 4}));
+    for (std::thread& worker : workers)
+        worker.join();
+}
+
+
+TEST(BarrierTest, RejectsZeroParticipants)
+{
+    EXPECT_THROW(Barrier<>(0), std::invalid_argument);
+}
+
+
+TEST(BarrierTest, SingleParticipantNeverBlocks)
+{
+    int phases = 0;
+    Barrier<std::function<void()>> barrier(1, [&]() { ++phases; });
+    for (int i = 0; i < 3; ++i)
+        barrier.arrive_and_wait();
+    EXPECT_EQ(phases, 3);
+}
+
+
+TEST(BarrierTest, NoThreadRunsAheadOfAPhase)
+{
+    // 9 participants need a second tree level above three leaves.
+    const int threads = 9;
+    const int rounds = 50;
+    std::atomic<int> arrived(0);
+    std::atomic<int> completions(0);
+    std::atomic<int> early(0);
+    auto completion = [&]() {
+        if (arrived.load() != (completions.load() + 1) * threads)
+            ++early;
+        ++completions;
+    };
+    Barrier<decltype(completion)> barrier(threads, completion);
+    EXPECT_EQ(barrier.participants(), 9u);
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&]() {
+            for (int round = 0; round < rounds; ++round)
+            {
+                ++arrived;
+                barrier.arrive_and_wait();
+                if (arrived.load() < (round + 1) * threads)
+                    ++early;
+            }
+        });
+    }
+    for (std::thread& worker : workers)
+        worker.join();
+    EXPECT_EQ(completions, rounds);
+    EXPECT_EQ(early, 0);
+}
@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "../hdr_histogram/histogram.h"
+#include "broadcast.h"
+
+
+struct Tick
+{
+    std::int64_t sent;
+    long sequence;
+    char payload[240];
+};
+
+
+static std::int64_t now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+struct Result
+{
+    double seconds;
+    HdrHistogram latencies;
+};
+
+
+// Reader loop shared by both variants: drains one queue until every message
+// arrived and records publish-to-receive latency.
+template <typename Receive>
+void drain(long messages, HdrHistogram& latencies, Receive receive)
+{
+    std::int64_t sent = 0;
+    for (long received = 0; received < messages;)
+    {
+        if (!receive(sent))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        latencies.record(static_cast<std::uint64_t>(now_ns() - sent));
+        ++received;
+    }
+}
+
+
+void run_copies(int subscribers, long messages, std::size_t capacity, Result& result)
+{
+    std::vector<SpscQueue<Tick>*> queues;
+    for (int i = 0; i < subscribers; ++i)
+        queues.push_back(new SpscQueue<Tick>(capacity));
+
+    HistogramGroup latencies;
+    std::vector<std::thread> readers;
+    for (int i = 0; i < subscribers; ++i)
+    {
+        readers.emplace_back([&, i]() {
+            Tick tick;
+            drain(messages, latencies.acquire(), [&](std::int64_t& sent) {
+                if (!queues[i]->try_pop(tick))
+                    return false;
+                sent = tick.sent;
+                return true;
+            });
+        });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    Tick tick = {};
+    for (long i = 0; i < messages; ++i)
+    {
+        tick.sequence = i;
+        tick.sent = now_ns();
+        for (SpscQueue<Tick>* queue : queues)
+        {
+            while (!queue->try_push(tick))
+                std::this_thread::yield();
+        }
+    }
+    for (std::thread& reader : readers)
+        reader.join();
+
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    latencies.merge_into(result.latencies);
+    for (SpscQueue<Tick>* queue : queues)
+        delete queue;
+}
+
+
+void run_shared(int subscribers, long messages, std::size_t capacity, Result& result)
+{
+    BroadcastTopic<Tick> topic(capacity);
+    std::vector<SharedPtr<Subscription<Tick>>> subscriptions;
+    for (int i = 0; i < subscribers; ++i)
+        subscriptions.push_back(topic.subscribe(OverflowPolicy::block));
+
+    HistogramGroup latencies;
+    std::vector<std::thread> readers;
+    for (int i = 0; i < subscribers; ++i)
+    {
+        readers.emplace_back([&, i]() {
+            SharedPtr<const Tick> tick;
+            drain(messages, latencies.acquire(), [&](std::int64_t& sent) {
+                if (!subscriptions[i]->try_receive(tick))
+                    return false;
+                sent = tick->sent;
+                return true;
+            });
+        });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < messages; ++i)
+    {
+        Tick* tick = new Tick();
+        tick->sequence = i;
+        tick->sent = now_ns();
+        topic.publish(SharedPtr<const Tick>(tick));
+    }
+    for (std::thread& reader : readers)
+        reader.join();
+
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    latencies.merge_into(result.latencies);
+}
+
+
+static void report(const char* name, const Result& result, long messages)
+{
+    auto percentile = [&](double p) { return static_cast<double>(result.latencies.value_at_percentile(p)) / 1000.0; };
+    std::printf("%-14s %12.0f %10.1f %10.1f %10.1f %10.1f\n", name, messages / result.seconds, percentile(50.0),
+                percentile(99.0), percentile(99.9), static_cast<double>(result.latencies.max()) / 1000.0);
+}
+
+
+int main(int argc, char** argv)
+{
+    const int subscribers = argc > 1 ? std::atoi(argv[1]) : 50;
+    const long messages = argc > 2 ? std::atol(argv[2]) : 20000;
+    const std::size_t capacity = argc > 3 ? std::atol(argv[3]) : 1024;
+
+    std::printf("%d subscribers, %ld messages of %zu bytes, queues of %zu\n", subscribers, messages, sizeof(Tick), capacity);
+    std::printf("%-14s %12s %10s %10s %10s %10s\n", "", "msgs/s", "p50 us", "p99 us", "p99.9 us", "max us");
+    Result copies;
+    run_copies(subscribers, messages, capacity, copies);
+    report("copy per sub", copies, messages);
+    Result shared;
+    run_shared(subscribers, messages, capacity, shared);
+    report("BroadcastTopic", shared, messages);
+    return 0;
+}
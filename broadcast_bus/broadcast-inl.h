@@ -0,0 +1,178 @@
+#include <algorithm>
+#include <thread>
+#include <utility>
+
+template <typename T>
+SpscQueue<T>::SpscQueue(const std::size_t capacity)
+{
+    std::size_t rounded = 1;
+    while (rounded < capacity)
+        rounded *= 2;
+    slots.resize(rounded);
+    mask = rounded - 1;
+    head.store(0, std::memory_order_relaxed);
+    tail.store(0, std::memory_order_relaxed);
+    cached_head = 0;
+    cached_tail = 0;
+}
+
+template <typename T>
+bool SpscQueue<T>::full() noexcept
+{
+    const std::size_t position = tail.load(std::memory_order_relaxed);
+    if (position - cached_head <= mask)
+        return false;
+    cached_head = head.load(std::memory_order_acquire);
+    return position - cached_head > mask;
+}
+
+template <typename T>
+bool SpscQueue<T>::try_push(T&& value)
+{
+    if (full())
+        return false;
+    const std::size_t position = tail.load(std::memory_order_relaxed);
+    slots[position & mask] = std::move(value);
+    tail.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+bool SpscQueue<T>::try_push(const T& value)
+{
+    if (full())
+        return false;
+    const std::size_t position = tail.load(std::memory_order_relaxed);
+    slots[position & mask] = value;
+    tail.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+bool SpscQueue<T>::try_pop(T& value)
+{
+    const std::size_t position = head.load(std::memory_order_relaxed);
+    if (position == cached_tail)
+    {
+        cached_tail = tail.load(std::memory_order_acquire);
+        if (position == cached_tail)
+            return false;
+    }
+    value = std::move(slots[position & mask]);
+    head.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+std::size_t SpscQueue<T>::size() const noexcept
+{
+    return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+}
+
+template <typename T>
+std::size_t SpscQueue<T>::capacity() const noexcept
+{
+    return mask + 1;
+}
+
+template <typename Msg>
+Subscription<Msg>::Subscription(const std::size_t capacity, const OverflowPolicy overflow) : queue(capacity)
+{
+    this->overflow = overflow;
+    dropped_count.store(0, std::memory_order_relaxed);
+    active.store(true, std::memory_order_relaxed);
+}
+
+template <typename Msg>
+bool Subscription<Msg>::try_receive(SharedPtr<const Msg>& message)
+{
+    return queue.try_pop(message);
+}
+
+template <typename Msg>
+std::size_t Subscription<Msg>::backlog() const noexcept
+{
+    return queue.size();
+}
+
+template <typename Msg>
+std::uint64_t Subscription<Msg>::dropped() const noexcept
+{
+    return dropped_count.load(std::memory_order_relaxed);
+}
+
+template <typename Msg>
+OverflowPolicy Subscription<Msg>::policy() const noexcept
+{
+    return overflow;
+}
+
+template <typename Msg>
+BroadcastTopic<Msg>::BroadcastTopic(const std::size_t queue_capacity)
+{
+    this->queue_capacity = queue_capacity;
+}
+
+template <typename Msg>
+SharedPtr<Subscription<Msg>> BroadcastTopic<Msg>::subscribe(const OverflowPolicy overflow)
+{
+    SharedPtr<Subscription<Msg>> subscription(new Subscription<Msg>(queue_capacity, overflow));
+    std::lock_guard<std::mutex> lock(mutex);
+    subscriptions.push_back(subscription);
+    return subscription;
+}
+
+template <typename Msg>
+void BroadcastTopic<Msg>::unsubscribe(const SharedPtr<Subscription<Msg>>& subscription)
+{
+    if (!subscription)
+        return;
+    subscription->active.store(false, std::memory_order_release);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (std::size_t i = 0; i < subscriptions.size(); ++i)
+    {
+        if (subscriptions[i].get() == subscription.get())
+        {
+            subscriptions.erase(subscriptions.begin() + i);
+            break;
+        }
+    }
+}
+
+template <typename Msg>
+std::size_t BroadcastTopic<Msg>::publish(const SharedPtr<const Msg>& message)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    ready.clear();
+    for (const SharedPtr<Subscription<Msg>>& subscription : subscriptions)
+    {
+        Subscription<Msg>& target = *subscription;
+        if (target.queue.full())
+        {
+            if (target.overflow == OverflowPolicy::drop)
+            {
+                target.dropped_count.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            while (target.queue.full() && target.active.load(std::memory_order_acquire))
+                std::this_thread::yield();
+            if (!target.active.load(std::memory_order_acquire))
+                continue;
+        }
+        ready.push_back(&target);
+    }
+
+    // Only the publisher pushes, so a queue that had room still has it.
+    message.retain(static_cast<int>(ready.size()));
+    for (Subscription<Msg>* target : ready)
+        target->queue.try_push(SharedPtr<const Msg>(message, AdoptRef()));
+    return ready.size();
+}
+
+template <typename Msg>
+std::size_t BroadcastTopic<Msg>::subscribers()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return subscriptions.size();
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "../shared_ptr/shared.h"
+
+// Bounded single-producer single-consumer ring. Each side keeps a cached
+// copy of the other side's index and only rereads it when the ring looks
+// full or empty.
+template <typename T>
+class SpscQueue
+{
+private:
+    std::vector<T> slots;
+    std::size_t mask;
+
+    alignas(64) std::atomic<std::size_t> head;
+    std::size_t cached_tail;
+
+    alignas(64) std::atomic<std::size_t> tail;
+    std::size_t cached_head;
+
+public:
+    explicit SpscQueue(std::size_t capacity);
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer side.
+    bool full() noexcept;
+    bool try_push(T&& value);
+    bool try_push(const T& value);
+
+    // Consumer side.
+    bool try_pop(T& value);
+
+    std::size_t size() const noexcept;
+    std::size_t capacity() const noexcept;
+};
+
+// What a publisher does when a subscriber's queue is full: drop the new
+// message for that subscriber (and count it), or wait until it catches up.
+enum class OverflowPolicy
+{
+    drop,
+    block
+};
+
+template <typename Msg>
+class BroadcastTopic;
+
+template <typename Msg>
+class Subscription
+{
+private:
+    SpscQueue<SharedPtr<const Msg>> queue;
+    OverflowPolicy overflow;
+    std::atomic<std::uint64_t> dropped_count;
+    std::atomic<bool> active;
+
+    friend class BroadcastTopic<Msg>;
+
+public:
+    Subscription(std::size_t capacity, OverflowPolicy overflow);
+
+    bool try_receive(SharedPtr<const Msg>& message);
+    std::size_t backlog() const noexcept;
+    std::uint64_t dropped() const noexcept;
+    OverflowPolicy policy() const noexcept;
+};
+
+// One stream of messages fanned out to many subscribers without copying
+// the payload. publish() first finds every queue with room, then takes all
+// the references it needs with a single atomic add and moves one into
+// each queue. There is one publisher per topic at a time; subscribers each
+// drain their own queue from one thread.
+template <typename Msg>
+class BroadcastTopic
+{
+private:
+    std::mutex mutex;
+    std::vector<SharedPtr<Subscription<Msg>>> subscriptions;
+    std::vector<Subscription<Msg>*> ready;
+    std::size_t queue_capacity;
+
+public:
+    explicit BroadcastTopic(std::size_t queue_capacity = 1024);
+    BroadcastTopic(const BroadcastTopic&) = delete;
+    BroadcastTopic& operator=(const BroadcastTopic&) = delete;
+
+    SharedPtr<Subscription<Msg>> subscribe(OverflowPolicy overflow = OverflowPolicy::drop);
+    // Also releases a publisher blocked on this subscriber.
+    void unsubscribe(const SharedPtr<Subscription<Msg>>& subscription);
+
+    // Returns how many subscribers received the message.
+    std::size_t publish(const SharedPtr<const Msg>& message);
+    std::size_t subscribers();
+};
+
+#include "broadcast-inl.h"
@@ -0,0 +1,138 @@
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "broadcast.h"
+
+
+struct Quote
+{
+    long sequence;
+    std::string symbol;
+};
+
+
+TEST(SpscQueueTest, RoundsCapacityAndKeepsOrder)
+{
+    SpscQueue<int> queue(5);
+    EXPECT_EQ(queue.capacity(), 8u);
+    for (int i = 0; i < 8; ++i)
+        EXPECT_TRUE(queue.try_push(i));
+    EXPECT_TRUE(queue.full());
+    EXPECT_FALSE(queue.try_push(8));
+
+    int value = -1;
+    for (int i = 0; i < 8; ++i)
+    {
+        EXPECT_TRUE(queue.try_pop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(queue.try_pop(value));
+}
+
+
+TEST(BroadcastTopicTest, SubscribersShareOnePayload)
+{
+    BroadcastTopic<Quote> topic(16);
+    std::vector<SharedPtr<Subscription<Quote>>> subscriptions;
+    for (int i = 0; i < 5; ++i)
+        subscriptions.push_back(topic.subscribe());
+
+    SharedPtr<const Quote> quote(new Quote{1, "ACME"});
+    EXPECT_EQ(topic.publish(quote), 5u);
+    EXPECT_EQ(quote.use_count(), 6);
+
+    for (SharedPtr<Subscription<Quote>>& subscription : subscriptions)
+    {
+        SharedPtr<const Quote> received;
+        EXPECT_TRUE(subscription->try_receive(received));
+        EXPECT_EQ(received.get(), quote.get());
+    }
+    EXPECT_EQ(quote.use_count(), 1);
+}
+
+
+TEST(BroadcastTopicTest, DropPolicyCountsOverflow)
+{
+    BroadcastTopic<Quote> topic(2);
+    SharedPtr<Subscription<Quote>> slow = topic.subscribe(OverflowPolicy::drop);
+    SharedPtr<Subscription<Quote>> fast = topic.subscribe(OverflowPolicy::drop);
+
+    SharedPtr<const Quote> received;
+    for (long i = 0; i < 5; ++i)
+    {
+        topic.publish(SharedPtr<const Quote>(new Quote{i, "ACME"}));
+        EXPECT_TRUE(fast->try_receive(received));
+    }
+    EXPECT_EQ(slow->backlog(), 2u);
+    EXPECT_EQ(slow->dropped(), 3u);
+    EXPECT_EQ(fast->dropped(), 0u);
+
+    EXPECT_TRUE(slow->try_receive(received));
+    EXPECT_EQ(received->sequence, 0);
+}
+
+
+TEST(BroadcastTopicTest, UnsubscribedQueueStopsReceiving)
+{
+    BroadcastTopic<Quote> topic;
+    SharedPtr<Subscription<Quote>> subscription = topic.subscribe();
+    EXPECT_EQ(topic.subscribers(), 1u);
+    topic.unsubscribe(subscription);
+    EXPECT_EQ(topic.subscribers(), 0u);
+    EXPECT_EQ(topic.publish(SharedPtr<const Quote>(new Quote{0, "ACME"})), 0u);
+    EXPECT_EQ(subscription->backlog(), 0u);
+}
+
+
+TEST(BroadcastTopicTest, BlockPolicyDeliversEverything)
+{
+    BroadcastTopic<Quote> topic(4);
+    const long messages = 2000;
+    std::vector<SharedPtr<Subscription<Quote>>> subscriptions;
+    for (int i = 0; i < 3; ++i)
+        subscriptions.push_back(topic.subscribe(OverflowPolicy::block));
+
+    std::atomic<int> out_of_order(0);
+    std::vector<std::thread> readers;
+    for (SharedPtr<Subscription<Quote>>& subscription : subscriptions)
+    {
+        readers.emplace_back([&, subscription]() {
+            SharedPtr<const Quote> quote;
+            for (long expected = 0; expected < messages;)
+            {
+                if (!subscription->try_receive(quote))
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+                if (quote->sequence != expected)
+                    ++out_of_order;
+                ++expected;
+            }
+        });
+    }
+    for (long i = 0; i < messages; ++i)
+        EXPECT_EQ(topic.publish(SharedPtr<const Quote>(new Quote{i, "ACME"})), 3u);
+    for (std::thread& reader : readers)
+        reader.join();
+
+    EXPECT_EQ(out_of_order, 0);
+    for (SharedPtr<Subscription<Quote>>& subscription : subscriptions)
+        EXPECT_EQ(subscription->dropped(), 0u);
+}
+
+
+TEST(BroadcastTopicTest, UnsubscribeReleasesBlockedPublisher)
+{
+    BroadcastTopic<Quote> topic(1);
+    SharedPtr<Subscription<Quote>> stuck = topic.subscribe(OverflowPolicy::block);
+    topic.publish(SharedPtr<const Quote>(new Quote{0, "ACME"}));
+
+    std::thread publisher([&]() { topic.publish(SharedPtr<const Quote>(new Quote{1, "ACME"})); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    topic.unsubscribe(stuck);
+    publisher.join();
+    EXPECT_EQ(stuck->backlog(), 1u);
+}
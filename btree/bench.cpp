@@ -0,0 +1,212 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <malloc.h>
+#include <map>
+#include <random>
+#include <unistd.h>
+#include <vector>
+#include "../unique_ptr/unique.h"
+#include "btree.h"
+
+
+typedef std::uint64_t Key;
+
+
+// Unbalanced BST with one UniquePtr per child, the pointer-chasing layout
+// the B+tree is meant to replace. Random keys keep it roughly balanced.
+class UniqueTree
+{
+private:
+    struct Node
+    {
+        Key key;
+        Key value;
+        UniquePtr<Node> left;
+        UniquePtr<Node> right;
+    };
+
+    UniquePtr<Node> root;
+
+    template <typename Func>
+    static void visit(const Node* node, Key from, Key to, Func& func)
+    {
+        while (node)
+        {
+            if (node->key < from)
+            {
+                node = node->right.get();
+                continue;
+            }
+            visit(node->left.get(), from, to, func);
+            if (!(node->key < to))
+                return;
+            func(node->key, node->value);
+            node = node->right.get();
+        }
+    }
+
+public:
+    void insert(Key key, Key value)
+    {
+        UniquePtr<Node>* slot = &root;
+        while (*slot)
+        {
+            Node* node = slot->get();
+            if (key == node->key)
+            {
+                node->value = value;
+                return;
+            }
+            slot = key < node->key ? &node->left : &node->right;
+        }
+        *slot = UniquePtr<Node>(new Node{key, value, UniquePtr<Node>(), UniquePtr<Node>()});
+    }
+
+    const Key* find(Key key) const
+    {
+        const Node* node = root.get();
+        while (node && node->key != key)
+            node = key < node->key ? node->left.get() : node->right.get();
+        return node ? &node->value : nullptr;
+    }
+
+    template <typename Func>
+    void scan(Key from, Key to, Func func) const
+    {
+        visit(root.get(), from, to, func);
+    }
+};
+
+
+class StdTree
+{
+private:
+    std::map<Key, Key> map;
+
+public:
+    void insert(Key key, Key value)
+    {
+        map[key] = value;
+    }
+
+    const Key* find(Key key) const
+    {
+        auto it = map.find(key);
+        return it == map.end() ? nullptr : &it->second;
+    }
+
+    template <typename Func>
+    void scan(Key from, Key to, Func func) const
+    {
+        for (auto it = map.lower_bound(from); it != map.end() && it->first < to; ++it)
+            func(it->first, it->second);
+    }
+};
+
+
+class ArenaTree
+{
+private:
+    BPlusTree<Key, Key> tree;
+
+public:
+    void insert(Key key, Key value)
+    {
+        tree.insert(key, value);
+    }
+
+    const Key* find(Key key) const
+    {
+        return tree.find(key);
+    }
+
+    template <typename Func>
+    void scan(Key from, Key to, Func func) const
+    {
+        tree.scan(from, to, func);
+    }
+};
+
+
+std::size_t resident_bytes()
+{
+    long pages = 0;
+    long resident = 0;
+    FILE* file = std::fopen("/proc/self/statm", "r");
+    if (file)
+    {
+        if (std::fscanf(file, "%ld %ld", &pages, &resident) != 2)
+            resident = 0;
+        std::fclose(file);
+    }
+    return static_cast<std::size_t>(resident) * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+}
+
+
+double since(std::chrono::steady_clock::time_point start, std::size_t operations)
+{
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / operations;
+}
+
+
+template <typename Tree>
+void run(const char* name, const std::vector<Key>& keys, std::size_t lookups, std::size_t scans)
+{
+    const std::size_t before = resident_bytes();
+    Tree* tree = new Tree();
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < keys.size(); ++i)
+        tree->insert(keys[i], i);
+    const double insert_ns = since(start, keys.size());
+    const double megabytes = static_cast<double>(resident_bytes() - before) / (1 << 20);
+
+    std::mt19937_64 random(3);
+    Key sink = 0;
+    start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < lookups; ++i)
+        sink += *tree->find(keys[random() % keys.size()]);
+    const double lookup_ns = since(start, lookups);
+
+    // Keys are uniform over 64 bits, so this span holds about 100 keys.
+    const Key span = ~Key(0) / keys.size() * 100;
+    std::size_t visited = 0;
+    start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < scans; ++i)
+    {
+        const Key from = keys[random() % keys.size()];
+        tree->scan(from, from + span, [&](Key, Key value) {
+            sink += value;
+            ++visited;
+        });
+    }
+    const double scan_ns = since(start, visited);
+
+    delete tree;
+    malloc_trim(0);
+    std::printf("%-22s %12.1f %12.1f %14.2f %10.0f\n", name, insert_ns, lookup_ns, scan_ns, megabytes);
+    if (sink == 42)
+        std::printf(" ");
+}
+
+
+int main(int argc, char** argv)
+{
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    const std::size_t lookups = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 5000000;
+    const std::size_t scans = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 50000;
+
+    std::mt19937_64 random(42);
+    std::vector<Key> keys(count);
+    for (Key& key : keys)
+        key = random();
+
+    std::printf("%zu random 64-bit keys, %zu lookups, %zu scans of ~100 keys\n", count, lookups, scans);
+    std::printf("%-22s %12s %12s %14s %10s\n", "tree", "insert ns", "lookup ns", "scan ns/key", "RSS MiB");
+    run<ArenaTree>("BPlusTree (arena)", keys, lookups, scans);
+    run<StdTree>("std::map", keys, lookups, scans);
+    run<UniqueTree>("UniquePtr BST", keys, lookups, scans);
+    return 0;
+}
@@ -0,0 +1,321 @@
+#include <new>
+#include <utility>
+
+template <std::size_t Bytes>
+NodeArena<Bytes>::NodeArena() noexcept
+{
+    cursor = nullptr;
+    limit = nullptr;
+}
+
+template <std::size_t Bytes>
+NodeArena<Bytes>::~NodeArena() noexcept
+{
+    clear();
+}
+
+template <std::size_t Bytes>
+void* NodeArena<Bytes>::allocate()
+{
+    if (cursor == limit)
+    {
+        chunks.reserve(chunks.size() + 1);
+        char* chunk = static_cast<char*>(::operator new(Bytes * chunk_blocks, std::align_val_t(alignment)));
+        chunks.push_back(chunk);
+        cursor = chunk;
+        limit = chunk + Bytes * chunk_blocks;
+    }
+    void* block = cursor;
+    cursor += Bytes;
+    return block;
+}
+
+template <std::size_t Bytes>
+void NodeArena<Bytes>::clear() noexcept
+{
+    for (char* chunk : chunks)
+        ::operator delete(chunk, std::align_val_t(alignment));
+    chunks.clear();
+    cursor = nullptr;
+    limit = nullptr;
+}
+
+template <std::size_t Bytes>
+std::size_t NodeArena<Bytes>::bytes() const noexcept
+{
+    return chunks.size() * Bytes * chunk_blocks;
+}
+
+template <typename K, typename V, std::size_t NodeBytes>
+BPlusTree<K, V, NodeBytes>::BPlusTree() noexcept
+{
+    root = nullptr;
+    levels = 0;
+    count = 0;
+}
+
+template <typename K, typename V, std::size_t NodeBytes>
+BPlusTree<K, V, NodeBytes>::~BPlusTree() noexcept
+{
+    destroy_leaves();
+}
+
+template <typename K, typename V, std::size_t NodeBytes>
+template <std::uint32_t Capacity>
+std::uint32_t BPlusTree<K, V, NodeBytes>::count_less(const K* const keys, const std::uint32_t count, const K key) noexcept
+{
+    std::uint32_t result = 0;
+    for (std::uint32_t i = 0; i < Capacity; ++i)
+        result += static_cast<std::uint32_t>(i < count) & static_cast<std::uint32_t>(keys[i] < key);
+    return result;
+}
+
+template <typename K, typename V, std::size_t NodeBytes>
+template <std::uint32_t Capacity>
+std::uint32_t BPlusTree<K, V, NodeBytes>::count_not_greater(const K* const keys, const std::uint32_t count, const K key) noexcept
+{
+    std::uint32_t result = 0;
+    for (std::uint32_t i = 0; i < Capacity; ++i)
+        result += static_cast<std::uint32_t>(i < count) & static_cast<std::uint32_t>(!(key < keys[i]));
+    return result;
+}
+
+template <typename K, typename V, std::size_t NodeBytes>
+typename BPlusTree<K, V, NodeBytes>::Leaf* BPlusTree<K, V, NodeBytes>::new_leaf()
+{
+    // Value-initialised so the search loops never read indeterminate keys.
+    Leaf* leaf = new (arena.allocate()) Leaf();
+    leaf->next = nullptr;
+    leaf->count = 0;
+    return leaf;
+}
+
+template <typename K, typename V, std::size_t NodeBytes>
+typename BPlusTree<K, V, NodeBytes>::Inner* BPlusTree<K, V, NodeBytes>::new_inner()
+{
+    Inner* inner = new (arena.allocate()) Inner();
+    inner->count = 0;
+    return inner;
+}
+
+template <typename K, typename V, std::size_t NodeBytes>
+const typename BPlusTree<K, V, NodeBytes>::Leaf* BPlusTree<K, V, NodeBytes>::find_leaf(const K& key) const noexcept
+{
+    const void* node = root;
+    for (int level = 1; level < levels; ++level)
+    {
+        const Inner* inner = static_cast<const Inner*>(node);
+        node = inner->children[count_not_greater<inner_capacity>(inner->keys, inner->count, key)];
+    }
+    return static_cast<const Leaf*>(node);
+}
+
+template <typename K, typename V, std::size_t NodeBytes>
+const V* BPlusTree<K, V, NodeBytes>::find(const K& key) const noexcept
+{
+    if (!root)
+        return nullptr;
+    const Leaf* leaf = find_leaf(key);
+    const std::uint32_t position = count_less<leaf_capacity>(leaf->keys, leaf->count, key);
+    if (position == leaf->count || leaf->keys[position] != key)
+        return nullptr;
+    return &leaf->values[position];
+}
+
+template <typename K, typename V, std::size_t NodeBytes>
+bool BPlusTree<K, V, NodeBytes>::contains(const K& key) const noexcept
+{
+    return find(key) != nullptr;
+}
+
+template <typename K, typename V, std::size_t NodeBytes>
+void BPlusTree<K, V, NodeBytes>::insert_into_leaf(Leaf* const leaf, const std::uint32_t position, const K& key, const V& value)
+{
+    for (std::uint32_t i = leaf->count; i > position; --i)
+    {
+        leaf->keys[i] = leaf->keys[i - 1];
+        leaf->values[i] = std::move(leaf->values[i - 1]);
+    }
+    leaf->keys[position] = key;
+    leaf->values[position] = value;
+    ++leaf->count;
+}
+
+template <typename K, typename V, std::size_t NodeBytes>
+bool BPlusTree<K, V, NodeBytes>::insert(const K& key, const V& value)
+{
+    if (!root)
+    {
+        root = new_leaf();
+        levels = 1;
+    }
+
+    Inner* path[max_height];
+    std::uint32_t slots[max_height];
+    void* node = root;
+    for (int level = 0; level < levels - 1; ++level)
+    {
+        Inner* inner = static_cast<Inner*>(node);
+        path[level] = inner;
+        slots[level] = count_not_greater<inner_capacity>(inner->keys, inner->count, key);
+        node = inner->children[slots[level]];
+    }
+
+    Leaf* leaf = static_cast<Leaf*>(node);
+    const std::uint32_t position = count_less<leaf_capacity>(leaf->keys, leaf->count, key);
+    if (position < leaf->count && leaf->keys[position] == key)
+    {
+        leaf->values[position] = value;
+        return false;
+    }
+    if (leaf->count < leaf_capacity)
+    {
+        insert_into_leaf(leaf, position, key, value);
+        ++count;
+        return true;
+    }
+
+    // Split the leaf; the upper half moves to a new right sibling.
+    Leaf* right = new_leaf();
+    const std::uint32_t half = (leaf_capacity + 1) / 2;
+    for (std::uint32_t i = half; i < leaf_capacity; ++i)
+    {
+        right->keys[i - half] = leaf->keys[i];
+        right->values[i - half] = std::move(leaf->values[i]);
+    }
+    right->count = leaf_capacity - half;
+    leaf->count = half;
+    right->next = leaf->next;
+    leaf->next = right;
+    if (position <= half)
+        insert_into_leaf(leaf, position, key, value);
+    else
+        insert_into_leaf(right, position - half, key, value);
+    ++count;
+
+    K separator = right->keys[0];
+    void* child = right;
+    for (int level = levels - 2; level >= 0; --level)
+    {
+        Inner* inner = path[level];
+        const std::uint32_t slot = slots[level];
+        if (inner->count < inner_capacity)
+        {
+            for (std::uint32_t i = inner->count; i > slot; --i)
+            {
+                inner->keys[i] = inner->keys[i - 1];
+                inner->children[i + 1] = inner->children[i];
+            }
+            inner->keys[slot] = separator;
+            inner->children[slot + 1] = child;
+            ++inner->count;
+            return true;
+        }
+
+        // Split a full inner node around its middle key, which moves up.
+        K keys[inner_capacity + 1];
+        void* children[inner_capacity + 2];
+        for (std::uint32_t i = 0, j = 0; i <= inner_capacity; ++i)
+            keys[i] = i == slot ? separator : inner->keys[j++];
+        for (std::uint32_t i = 0, j = 0; i <= inner_capacity + 1; ++i)
+            children[i] = i == slot + 1 ? child : inner->children[j++];
+
+        const std::uint32_t middle = (inner_capacity + 1) / 2;
+        Inner* sibling = new_inner();
+        for (std::uint32_t i = 0; i < middle; ++i)
+            inner->keys[i] = keys[i];
+        for (std::uint32_t i = 0; i <= middle; ++i)
+            inner->children[i] = children[i];
+        inner->count = middle;
+        for (std::uint32_t i = middle + 1; i <= inner_capacity; ++i)
+            sibling->keys[i - middle - 1] = keys[i];
+        for (std::uint32_t i = middle + 1; i <= inner_capacity + 1; ++i)
+            sibling->children[i - middle - 1] = children[i];
+        sibling->count = inner_capacity - middle;
+
+        separator = keys[middle];
+        child = sibling;
+    }
+
+    Inner* top = new_inner();
+    top->keys[0] = separator;
+    top->children[0] = root;
+    top->children[1] = child;
+    top->count = 1;
+    root = top;
+    ++levels;
+    return true;
+}
+
+template <typename K, typename V, std::size_t NodeBytes>
+template <typename Func>
+void BPlusTree<K, V, NodeBytes>::scan(const K& from, const K& to, Func func) const
+{
+    if (!root)
+        return;
+    const Leaf* leaf = find_leaf(from);
+    std::uint32_t position = count_less<leaf_capacity>(leaf->keys, leaf->count, from);
+    while (leaf)
+    {
+        for (; position < leaf->count; ++position)
+        {
+            if (!(leaf->keys[position] < to))
+                return;
+            func(leaf->keys[position], leaf->values[position]);
+        }
+        leaf = leaf->next;
+        position = 0;
+    }
+}
+
+template <typename K, typename V, std::size_t NodeBytes>
+void BPlusTree<K, V, NodeBytes>::destroy_leaves() noexcept
+{
+    // Inner nodes hold only keys and pointers; the arena frees the memory.
+    if (std::is_trivially_destructible<V>::value || !root)
+        return;
+    void* node = root;
+    for (int level = 1; level < levels; ++level)
+        node = static_cast<Inner*>(node)->children[0];
+    Leaf* leaf = static_cast<Leaf*>(node);
+    while (leaf)
+    {
+        Leaf* next = leaf->next;
+        leaf->~Leaf();
+        leaf = next;
+    }
+}
+
+template <typename K, typename V, std::size_t NodeBytes>
+void BPlusTree<K, V, NodeBytes>::clear() noexcept
+{
+    destroy_leaves();
+    arena.clear();
+    root = nullptr;
+    levels = 0;
+    count = 0;
+}
+
+template <typename K, typename V, std::size_t NodeBytes>
+std::size_t BPlusTree<K, V, NodeBytes>::size() const noexcept
+{
+    return count;
+}
+
+template <typename K, typename V, std::size_t NodeBytes>
+bool BPlusTree<K, V, NodeBytes>::empty() const noexcept
+{
+    return count == 0;
+}
+
+template <typename K, typename V, std::size_t NodeBytes>
+int BPlusTree<K, V, NodeBytes>::height() const noexcept
+{
+    return levels;
+}
+
+template <typename K, typename V, std::size_t NodeBytes>
+std::size_t BPlusTree<K, V, NodeBytes>::memory_size() const noexcept
+{
+    return arena.bytes();
+}
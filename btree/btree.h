@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+// Hands out fixed-size, cache-line-aligned blocks carved from large chunks.
+// Blocks are never returned individually; clear() releases everything.
+template <std::size_t Bytes>
+class NodeArena
+{
+public:
+    static constexpr std::size_t alignment = 64;
+    static constexpr std::size_t chunk_blocks = 4096;
+
+    NodeArena() noexcept;
+    NodeArena(const NodeArena&) = delete;
+    NodeArena& operator=(const NodeArena&) = delete;
+    ~NodeArena() noexcept;
+
+    void* allocate();
+    void clear() noexcept;
+    std::size_t bytes() const noexcept;
+
+private:
+    std::vector<char*> chunks;
+    char* cursor;
+    char* limit;
+};
+
+// B+tree keyed by an arithmetic type. Every node is NodeBytes (a multiple of
+// the cache line) and comes from a NodeArena, so children are plain pointers
+// into a few large chunks instead of one heap object per node. Searches
+// inside a node are branchless: they count the keys below the target over
+// the whole node, a fixed-trip loop the compiler can vectorize. Leaves are
+// chained for range scans. There is no erase; clear() drops the whole tree.
+template <typename K, typename V, std::size_t NodeBytes = 256>
+class BPlusTree
+{
+    static_assert(std::is_arithmetic<K>::value, "BPlusTree keys must be arithmetic");
+    static_assert(NodeBytes % 64 == 0, "BPlusTree nodes must be whole cache lines");
+
+public:
+    // Mixed key and value sizes may need up to 8 bytes of padding between
+    // the two arrays.
+    static constexpr std::uint32_t leaf_capacity = static_cast<std::uint32_t>(
+        (NodeBytes - sizeof(void*) - sizeof(std::uint32_t) - (sizeof(K) == sizeof(V) ? 0 : 8)) / (sizeof(K) + sizeof(V)));
+    static constexpr std::uint32_t inner_capacity =
+        static_cast<std::uint32_t>((NodeBytes - sizeof(void*) - sizeof(std::uint32_t)) / (sizeof(K) + sizeof(void*)));
+    static constexpr int max_height = 40;
+
+    BPlusTree() noexcept;
+    BPlusTree(const BPlusTree&) = delete;
+    BPlusTree& operator=(const BPlusTree&) = delete;
+    ~BPlusTree() noexcept;
+
+    // Inserts or overwrites; true if the key was new.
+    bool insert(const K& key, const V& value);
+    const V* find(const K& key) const noexcept;
+    bool contains(const K& key) const noexcept;
+    // Calls func(key, value) for keys in [from, to), in order.
+    template <typename Func>
+    void scan(const K& from, const K& to, Func func) const;
+
+    void clear() noexcept;
+    std::size_t size() const noexcept;
+    bool empty() const noexcept;
+    int height() const noexcept;
+    std::size_t memory_size() const noexcept;
+
+private:
+    struct alignas(64) Leaf
+    {
+        K keys[leaf_capacity];
+        V values[leaf_capacity];
+        Leaf* next;
+        std::uint32_t count;
+    };
+
+    struct alignas(64) Inner
+    {
+        void* children[inner_capacity + 1];
+        K keys[inner_capacity];
+        std::uint32_t count;
+    };
+
+    static_assert(leaf_capacity >= 2 && inner_capacity >= 3, "BPlusTree nodes are too small for these types");
+    static_assert(sizeof(Leaf) <= NodeBytes && sizeof(Inner) <= NodeBytes, "BPlusTree node layout overflows NodeBytes");
+
+    NodeArena<NodeBytes> arena;
+    void* root;
+    int levels;
+    std::size_t count;
+
+    template <std::uint32_t Capacity>
+    static std::uint32_t count_less(const K* keys, std::uint32_t count, K key) noexcept;
+    template <std::uint32_t Capacity>
+    static std::uint32_t count_not_greater(const K* keys, std::uint32_t count, K key) noexcept;
+
+    Leaf* new_leaf();
+    Inner* new_inner();
+    const Leaf* find_leaf(const K& key) const noexcept;
+    static void insert_into_leaf(Leaf* leaf, std::uint32_t position, const K& key, const V& value);
+    void destroy_leaves() noexcept;
+};
+
+#include "btree-inl.h"
@@ -0,0 +1,112 @@
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "btree.h"
+
+
+TEST(NodeArenaTest, BlocksAreAlignedAndDistinct)
+{
+    NodeArena<128> arena;
+    std::vector<char*> blocks;
+    for (std::size_t i = 0; i < NodeArena<128>::chunk_blocks + 10; ++i)
+        blocks.push_back(static_cast<char*>(arena.allocate()));
+    for (std::size_t i = 0; i < blocks.size(); ++i)
+    {
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(blocks[i]) % 64, 0u);
+        if (i > 0 && i % NodeArena<128>::chunk_blocks != 0)
+        {
+            EXPECT_EQ(blocks[i] - blocks[i - 1], 128);
+        }
+    }
+    EXPECT_EQ(arena.bytes(), 2 * 128 * NodeArena<128>::chunk_blocks);
+    arena.clear();
+    EXPECT_EQ(arena.bytes(), 0u);
+}
+
+
+TEST(BPlusTreeTest, NodesFillWholeCacheLines)
+{
+    typedef BPlusTree<std::uint64_t, std::uint64_t> Tree;
+    EXPECT_EQ(Tree::leaf_capacity, 15u);
+    EXPECT_EQ(Tree::inner_capacity, 15u);
+    EXPECT_GE((BPlusTree<std::uint8_t, double, 64>::leaf_capacity), 2u);
+    EXPECT_GE((BPlusTree<std::int32_t, std::int32_t, 512>::inner_capacity), 40u);
+}
+
+
+TEST(BPlusTreeTest, InsertFindOverwrite)
+{
+    BPlusTree<int, int> tree;
+    EXPECT_TRUE(tree.empty());
+    EXPECT_EQ(tree.find(1), nullptr);
+    EXPECT_TRUE(tree.insert(5, 50));
+    EXPECT_TRUE(tree.insert(-3, 30));
+    EXPECT_FALSE(tree.insert(5, 55));
+    EXPECT_EQ(tree.size(), 2u);
+    EXPECT_EQ(*tree.find(5), 55);
+    EXPECT_EQ(*tree.find(-3), 30);
+    EXPECT_FALSE(tree.contains(4));
+}
+
+
+TEST(BPlusTreeTest, MatchesStdMapUnderRandomInserts)
+{
+    BPlusTree<std::int64_t, std::int64_t> tree;
+    std::map<std::int64_t, std::int64_t> expected;
+    std::mt19937_64 random(7);
+    for (int i = 0; i < 200000; ++i)
+    {
+        const std::int64_t key = static_cast<std::int64_t>(random() % 100000) - 50000;
+        EXPECT_EQ(tree.insert(key, i), expected.insert_or_assign(key, i).second);
+    }
+    EXPECT_EQ(tree.size(), expected.size());
+    EXPECT_GE(tree.height(), 3);
+    for (std::int64_t key = -50001; key <= 50001; ++key)
+    {
+        auto it = expected.find(key);
+        const std::int64_t* value = tree.find(key);
+        ASSERT_EQ(value != nullptr, it != expected.end()) << key;
+        if (value)
+        {
+            EXPECT_EQ(*value, it->second);
+        }
+    }
+}
+
+
+TEST(BPlusTreeTest, ScanFollowsLeafChain)
+{
+    BPlusTree<std::uint32_t, std::uint32_t> tree;
+    for (std::uint32_t i = 0; i < 10000; ++i)
+        tree.insert((i * 7919u) % 10000u * 2u, i);
+
+    std::vector<std::uint32_t> keys;
+    tree.scan(1001, 1201, [&keys](std::uint32_t key, std::uint32_t) { keys.push_back(key); });
+    ASSERT_EQ(keys.size(), 100u);
+    for (std::size_t i = 0; i < keys.size(); ++i)
+        EXPECT_EQ(keys[i], 1002u + 2u * i);
+
+    std::size_t total = 0;
+    tree.scan(0, 20000, [&total](std::uint32_t, std::uint32_t) { ++total; });
+    EXPECT_EQ(total, 10000u);
+}
+
+
+TEST(BPlusTreeTest, ValuesAreDestroyedAndClearResets)
+{
+    BPlusTree<int, std::string, 512> tree;
+    for (int i = 0; i < 5000; ++i)
+        tree.insert(i, std::string(40, static_cast<char>('a' + i % 26)));
+    EXPECT_EQ(*tree.find(27), std::string(40, 'b'));
+    EXPECT_GT(tree.memory_size(), 0u);
+
+    tree.clear();
+    EXPECT_TRUE(tree.empty());
+    EXPECT_EQ(tree.memory_size(), 0u);
+    EXPECT_EQ(tree.find(27), nullptr);
+    EXPECT_TRUE(tree.insert(27, "again"));
+    EXPECT_EQ(*tree.find(27), "again");
+}
@@ -0,0 +1,122 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include "buffer_chain.h"
+
+
+struct Totals
+{
+    std::size_t records;
+    std::size_t bytes;
+};
+
+
+void generate(const char* path, std::size_t size)
+{
+    std::FILE* file = std::fopen(path, "wb");
+    std::string line;
+    std::size_t written = 0;
+    unsigned seed = 1;
+    while (written < size)
+    {
+        seed = seed * 1103515245u + 12345u;
+        line.assign(16 + (seed >> 16) % 240, static_cast<char>('a' + seed % 26));
+        line.push_back('\n');
+        std::fwrite(line.data(), 1, line.size(), file);
+        written += line.size();
+    }
+    std::fclose(file);
+}
+
+
+Totals split_copying(const char* path)
+{
+    Totals totals = {0, 0};
+    int fd = open(path, O_RDONLY);
+    std::vector<char> buffer(1 << 20);
+    std::string partial;
+    std::vector<std::string> batch;
+
+    ssize_t got;
+    while ((got = read(fd, buffer.data(), buffer.size())) > 0)
+    {
+        const char* start = buffer.data();
+        const char* end = start + got;
+        while (start < end)
+        {
+            const char* newline = static_cast<const char*>(std::memchr(start, '\n', static_cast<std::size_t>(end - start)));
+            if (newline == nullptr)
+            {
+                partial.append(start, end);
+                break;
+            }
+            partial.append(start, newline + 1);
+            batch.push_back(std::move(partial));
+            partial.clear();
+            start = newline + 1;
+        }
+        for (const std::string& record : batch)
+        {
+            ++totals.records;
+            totals.bytes += record.size();
+        }
+        batch.clear();
+    }
+    close(fd);
+    return totals;
+}
+
+
+Totals split_chained(const char* path)
+{
+    Totals totals = {0, 0};
+    int fd = open(path, O_RDONLY);
+    BufferChain pending;
+    std::vector<BufferChain> batch;
+
+    while (pending.read_from(fd, 64 << 10, 16) > 0)
+    {
+        std::size_t newline;
+        while ((newline = pending.find('\n')) != BufferChain::npos)
+            batch.push_back(pending.split(newline + 1));
+        for (const BufferChain& record : batch)
+        {
+            ++totals.records;
+            totals.bytes += record.size();
+        }
+        batch.clear();
+    }
+    close(fd);
+    return totals;
+}
+
+
+template <typename Func>
+void run(const char* name, Func func, const char* path)
+{
+    auto start = std::chrono::steady_clock::now();
+    Totals totals = func(path);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%-10s %12zu records %8.3f s %8.2f GB/s\n", name, totals.records, seconds, totals.bytes / seconds / 1e9);
+}
+
+
+int main(int argc, char** argv)
+{
+    const std::size_t size = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : (256u << 20);
+    const char* path = argc > 2 ? argv[2] : "/tmp/buffer_chain_bench.txt";
+
+    generate(path, size);
+    for (int round = 0; round < 3; ++round)
+    {
+        run("copying", split_copying, path);
+        run("chained", split_chained, path);
+    }
+    if (argc <= 2)
+        std::remove(path);
+    return 0;
+}
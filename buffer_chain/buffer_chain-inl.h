@@ -0,0 +1,331 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits.h>
+#include <sys/uio.h>
+
+inline BufferStorage::BufferStorage(const std::size_t capacity)
+{
+    bytes = new std::uint8_t[capacity];
+    this->capacity = capacity;
+}
+
+inline BufferStorage::~BufferStorage() noexcept
+{
+    delete[] bytes;
+}
+
+inline BufferSlice::BufferSlice() noexcept
+{
+    bytes = nullptr;
+    length = 0;
+}
+
+inline BufferSlice::BufferSlice(const SharedPtr<BufferStorage>& storage) noexcept
+    : storage(storage)
+{
+    bytes = storage ? storage->bytes : nullptr;
+    length = storage ? storage->capacity : 0;
+}
+
+inline BufferSlice::BufferSlice(const SharedPtr<BufferStorage>& storage, const std::size_t offset, const std::size_t length) noexcept
+    : storage(storage)
+{
+    bytes = storage->bytes + offset;
+    this->length = length;
+}
+
+inline const std::uint8_t* BufferSlice::data() const noexcept
+{
+    return bytes;
+}
+
+inline std::size_t BufferSlice::size() const noexcept
+{
+    return length;
+}
+
+inline bool BufferSlice::empty() const noexcept
+{
+    return length == 0;
+}
+
+inline BufferSlice BufferSlice::slice(const std::size_t offset, const std::size_t length) const noexcept
+{
+    BufferSlice result(*this);
+    result.bytes += offset;
+    result.length = length;
+    return result;
+}
+
+inline void BufferSlice::trim_front(const std::size_t count) noexcept
+{
+    bytes += count;
+    length -= count;
+}
+
+inline void BufferSlice::trim_back(const std::size_t count) noexcept
+{
+    length -= count;
+}
+
+inline long BufferSlice::use_count() const noexcept
+{
+    return storage.use_count();
+}
+
+inline BufferChain::BufferChain() noexcept
+{
+    head = 0;
+    length = 0;
+}
+
+inline BufferChain::BufferChain(const BufferSlice& slice)
+{
+    head = 0;
+    length = 0;
+    append(slice);
+}
+
+inline void BufferChain::pop_front() noexcept
+{
+    slices[head++] = BufferSlice();
+    if (head == slices.size())
+    {
+        slices.clear();
+        head = 0;
+    }
+    else if (head >= 64 && head * 2 >= slices.size())
+    {
+        slices.erase(slices.begin(), slices.begin() + static_cast<std::ptrdiff_t>(head));
+        head = 0;
+    }
+}
+
+inline std::size_t BufferChain::size() const noexcept
+{
+    return length;
+}
+
+inline bool BufferChain::empty() const noexcept
+{
+    return length == 0;
+}
+
+inline std::size_t BufferChain::slice_count() const noexcept
+{
+    return slices.size() - head;
+}
+
+inline const BufferSlice& BufferChain::slice_at(const std::size_t index) const noexcept
+{
+    return slices[head + index];
+}
+
+inline void BufferChain::append(const BufferSlice& slice)
+{
+    if (slice.empty())
+        return;
+    slices.push_back(slice);
+    length += slice.size();
+}
+
+inline void BufferChain::append(BufferChain&& other)
+{
+    if (&other == this)
+        return;
+    for (std::size_t i = other.head; i < other.slices.size(); ++i)
+        slices.push_back(std::move(other.slices[i]));
+    length += other.length;
+    other.clear();
+}
+
+inline BufferChain BufferChain::split(std::size_t count)
+{
+    BufferChain front;
+    count = std::min(count, length);
+    while (count > 0)
+    {
+        BufferSlice& slice = slices[head];
+        if (slice.size() <= count)
+        {
+            count -= slice.size();
+            length -= slice.size();
+            front.length += slice.size();
+            front.slices.push_back(std::move(slice));
+            pop_front();
+        }
+        else
+        {
+            front.append(slice.slice(0, count));
+            slice.trim_front(count);
+            length -= count;
+            count = 0;
+        }
+    }
+    return front;
+}
+
+inline BufferChain BufferChain::slice(std::size_t offset, std::size_t count) const
+{
+    BufferChain result;
+    for (std::size_t i = head; i < slices.size(); ++i)
+    {
+        const BufferSlice& slice = slices[i];
+        if (count == 0)
+            break;
+        if (offset >= slice.size())
+        {
+            offset -= slice.size();
+            continue;
+        }
+        std::size_t take = std::min(count, slice.size() - offset);
+        result.append(slice.slice(offset, take));
+        count -= take;
+        offset = 0;
+    }
+    return result;
+}
+
+inline void BufferChain::trim_front(std::size_t count) noexcept
+{
+    count = std::min(count, length);
+    length -= count;
+    while (count > 0)
+    {
+        BufferSlice& slice = slices[head];
+        if (slice.size() <= count)
+        {
+            count -= slice.size();
+            pop_front();
+        }
+        else
+        {
+            slice.trim_front(count);
+            count = 0;
+        }
+    }
+}
+
+inline void BufferChain::clear() noexcept
+{
+    slices.clear();
+    head = 0;
+    length = 0;
+}
+
+inline std::size_t BufferChain::find(const std::uint8_t byte, std::size_t from) const noexcept
+{
+    std::size_t base = 0;
+    for (std::size_t i = head; i < slices.size(); ++i)
+    {
+        const BufferSlice& slice = slices[i];
+        if (from < base + slice.size())
+        {
+            const std::uint8_t* start = slice.data() + (from - base);
+            const void* hit = std::memchr(start, byte, slice.size() - (from - base));
+            if (hit)
+                return base + static_cast<std::size_t>(static_cast<const std::uint8_t*>(hit) - slice.data());
+            from = base + slice.size();
+        }
+        base += slice.size();
+    }
+    return npos;
+}
+
+inline std::size_t BufferChain::copy_to(std::uint8_t* out, std::size_t offset, std::size_t count) const noexcept
+{
+    std::size_t copied = 0;
+    for (std::size_t i = head; i < slices.size(); ++i)
+    {
+        const BufferSlice& slice = slices[i];
+        if (count == 0)
+            break;
+        if (offset >= slice.size())
+        {
+            offset -= slice.size();
+            continue;
+        }
+        std::size_t take = std::min(count, slice.size() - offset);
+        std::memcpy(out + copied, slice.data() + offset, take);
+        copied += take;
+        count -= take;
+        offset = 0;
+    }
+    return copied;
+}
+
+inline std::string BufferChain::to_string() const
+{
+    std::string result(length, '\0');
+    copy_to(reinterpret_cast<std::uint8_t*>(&result[0]), 0, length);
+    return result;
+}
+
+inline ssize_t BufferChain::write_to(const int fd) const
+{
+    std::vector<iovec> vectors;
+    vectors.reserve(std::min<std::size_t>(slice_count(), IOV_MAX));
+
+    std::size_t next = head;
+    std::size_t skip = 0;
+    std::size_t written = 0;
+    while (next < slices.size())
+    {
+        vectors.clear();
+        for (std::size_t i = next; i < slices.size() && vectors.size() < IOV_MAX; ++i)
+        {
+            const BufferSlice& slice = slices[i];
+            std::size_t offset = i == next ? skip : 0;
+            vectors.push_back(iovec{const_cast<std::uint8_t*>(slice.data()) + offset, slice.size() - offset});
+        }
+
+        ssize_t result = writev(fd, vectors.data(), static_cast<int>(vectors.size()));
+        if (result < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        written += static_cast<std::size_t>(result);
+
+        std::size_t done = static_cast<std::size_t>(result) + skip;
+        while (next < slices.size() && done >= slices[next].size())
+        {
+            done -= slices[next].size();
+            ++next;
+        }
+        skip = done;
+    }
+    return static_cast<ssize_t>(written);
+}
+
+inline ssize_t BufferChain::read_from(const int fd, const std::size_t block_size, const int blocks)
+{
+    std::vector<SharedPtr<BufferStorage>> storages;
+    std::vector<iovec> vectors;
+    for (int i = 0; i < blocks && i < IOV_MAX; ++i)
+    {
+        storages.emplace_back(new BufferStorage(block_size));
+        vectors.push_back(iovec{storages.back()->bytes, block_size});
+    }
+
+    ssize_t result;
+    do
+    {
+        result = readv(fd, vectors.data(), static_cast<int>(vectors.size()));
+    } while (result < 0 && errno == EINTR);
+    if (result <= 0)
+        return result;
+
+    std::size_t remaining = static_cast<std::size_t>(result);
+    for (const SharedPtr<BufferStorage>& storage : storages)
+    {
+        if (remaining == 0)
+            break;
+        std::size_t filled = std::min(remaining, block_size);
+        append(BufferSlice(storage, 0, filled));
+        remaining -= filled;
+    }
+    return result;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+#include "../shared_ptr/shared.h"
+
+class BufferStorage
+{
+public:
+    std::uint8_t* bytes;
+    std::size_t capacity;
+
+    explicit BufferStorage(std::size_t capacity);
+    BufferStorage(const BufferStorage&) = delete;
+    BufferStorage& operator=(const BufferStorage&) = delete;
+    ~BufferStorage() noexcept;
+};
+
+// A view of part of a refcounted storage block. Copies share the block.
+class BufferSlice
+{
+private:
+    SharedPtr<BufferStorage> storage;
+    const std::uint8_t* bytes;
+    std::size_t length;
+
+public:
+    BufferSlice() noexcept;
+    explicit BufferSlice(const SharedPtr<BufferStorage>& storage) noexcept;
+    BufferSlice(const SharedPtr<BufferStorage>& storage, std::size_t offset, std::size_t length) noexcept;
+
+    const std::uint8_t* data() const noexcept;
+    std::size_t size() const noexcept;
+    bool empty() const noexcept;
+    BufferSlice slice(std::size_t offset, std::size_t length) const noexcept;
+    void trim_front(std::size_t count) noexcept;
+    void trim_back(std::size_t count) noexcept;
+    long use_count() const noexcept;
+};
+
+// A sequence of slices read as one byte string. split, slice and append
+// never copy payload bytes; they only move or share slices.
+class BufferChain
+{
+private:
+    std::vector<BufferSlice> slices;
+    std::size_t head;
+    std::size_t length;
+
+    void pop_front() noexcept;
+
+public:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    BufferChain() noexcept;
+    explicit BufferChain(const BufferSlice& slice);
+
+    std::size_t size() const noexcept;
+    bool empty() const noexcept;
+    std::size_t slice_count() const noexcept;
+    const BufferSlice& slice_at(std::size_t index) const noexcept;
+
+    void append(const BufferSlice& slice);
+    void append(BufferChain&& other);
+    BufferChain split(std::size_t count);
+    BufferChain slice(std::size_t offset, std::size_t count) const;
+    void trim_front(std::size_t count) noexcept;
+    void clear() noexcept;
+
+    std::size_t find(std::uint8_t byte, std::size_t from = 0) const noexcept;
+    std::size_t copy_to(std::uint8_t* out, std::size_t offset, std::size_t count) const noexcept;
+    std::string to_string() const;
+
+    ssize_t write_to(int fd) const;
+    ssize_t read_from(int fd, std::size_t block_size, int blocks);
+};
+
+#include "buffer_chain-inl.h"
@@ -0,0 +1,164 @@
+#include <cstdio>
+#include <string>
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include "buffer_chain.h"
+
+
+SharedPtr<BufferStorage> make_storage(const std::string& text)
+{
+    SharedPtr<BufferStorage> storage(new BufferStorage(text.size()));
+    std::memcpy(storage->bytes, text.data(), text.size());
+    return storage;
+}
+
+
+BufferChain make_chain(std::initializer_list<std::string> parts)
+{
+    BufferChain chain;
+    for (const std::string& part : parts)
+        chain.append(BufferSlice(make_storage(part)));
+    return chain;
+}
+
+
+TEST(BufferSliceTest, SliceSharesStorage)
+{
+    BufferSlice whole(make_storage("hello world"));
+    BufferSlice word = whole.slice(6, 5);
+
+    EXPECT_EQ(word.size(), 5u);
+    EXPECT_EQ(word.data(), whole.data() + 6);
+    EXPECT_EQ(whole.use_count(), 2);
+}
+
+
+TEST(BufferSliceTest, StorageReleasedWithLastSlice)
+{
+    SharedPtr<BufferStorage> storage = make_storage("abc");
+    {
+        BufferChain chain(BufferSlice(storage, 0, 3));
+        BufferChain copy = chain.slice(1, 2);
+        EXPECT_EQ(storage.use_count(), 3);
+    }
+    EXPECT_EQ(storage.use_count(), 1);
+}
+
+
+TEST(BufferChainTest, AppendAndToString)
+{
+    BufferChain chain = make_chain({"ab", "cde", "", "f"});
+
+    EXPECT_EQ(chain.size(), 6u);
+    EXPECT_EQ(chain.slice_count(), 3u);
+    EXPECT_EQ(chain.to_string(), "abcdef");
+}
+
+
+TEST(BufferChainTest, AppendChainMovesSlices)
+{
+    BufferChain chain = make_chain({"ab"});
+    BufferChain other = make_chain({"cd", "ef"});
+
+    chain.append(std::move(other));
+
+    EXPECT_EQ(chain.to_string(), "abcdef");
+    EXPECT_TRUE(other.empty());
+    EXPECT_EQ(other.slice_count(), 0u);
+
+    chain.append(std::move(chain));
+    EXPECT_EQ(chain.to_string(), "abcdef");
+}
+
+
+TEST(BufferChainTest, SplitWithinAndAcrossSlices)
+{
+    BufferChain chain = make_chain({"abc", "defg", "hi"});
+    const std::uint8_t* base = chain.slice_at(1).data();
+
+    BufferChain front = chain.split(5);
+
+    EXPECT_EQ(front.to_string(), "abcde");
+    EXPECT_EQ(chain.to_string(), "fghi");
+    EXPECT_EQ(chain.slice_at(0).data(), base + 2);
+    EXPECT_EQ(front.slice_at(1).data(), base);
+
+    BufferChain rest = chain.split(100);
+    EXPECT_EQ(rest.to_string(), "fghi");
+    EXPECT_TRUE(chain.empty());
+}
+
+
+TEST(BufferChainTest, SliceLeavesChainIntact)
+{
+    BufferChain chain = make_chain({"abc", "defg", "hi"});
+
+    EXPECT_EQ(chain.slice(2, 5).to_string(), "cdefg");
+    EXPECT_EQ(chain.slice(7, 10).to_string(), "hi");
+    EXPECT_EQ(chain.slice(9, 1).to_string(), "");
+    EXPECT_EQ(chain.to_string(), "abcdefghi");
+}
+
+
+TEST(BufferChainTest, TrimFront)
+{
+    BufferChain chain = make_chain({"abc", "defg"});
+
+    chain.trim_front(4);
+
+    EXPECT_EQ(chain.to_string(), "efg");
+    EXPECT_EQ(chain.slice_count(), 1u);
+}
+
+
+TEST(BufferChainTest, FindAcrossSlices)
+{
+    BufferChain chain = make_chain({"ab\n", "cd", "e\nf"});
+
+    EXPECT_EQ(chain.find('\n'), 2u);
+    EXPECT_EQ(chain.find('\n', 3), 6u);
+    EXPECT_EQ(chain.find('\n', 7), BufferChain::npos);
+    EXPECT_EQ(chain.find('z'), BufferChain::npos);
+}
+
+
+TEST(BufferChainTest, WriteAndReadThroughPipe)
+{
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+
+    BufferChain out = make_chain({"hello ", "gather ", "write"});
+    EXPECT_EQ(out.write_to(fds[1]), static_cast<ssize_t>(out.size()));
+    close(fds[1]);
+
+    BufferChain in;
+    ssize_t got;
+    while ((got = in.read_from(fds[0], 4, 3)) > 0)
+    {}
+    close(fds[0]);
+
+    EXPECT_EQ(got, 0);
+    EXPECT_EQ(in.to_string(), "hello gather write");
+    EXPECT_GE(in.slice_count(), 5u);
+}
+
+
+TEST(BufferChainTest, WriteManySlices)
+{
+    std::FILE* file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    int fd = fileno(file);
+
+    BufferChain out;
+    SharedPtr<BufferStorage> storage = make_storage("0123456789");
+    for (int i = 0; i < 3000; ++i)
+        out.append(BufferSlice(storage, static_cast<std::size_t>(i % 10), 1));
+    EXPECT_EQ(out.write_to(fd), 3000);
+
+    lseek(fd, 0, SEEK_SET);
+    BufferChain in;
+    while (in.read_from(fd, 1024, 2) > 0)
+    {}
+    EXPECT_EQ(in.to_string(), out.to_string());
+    std::fclose(file);
+}
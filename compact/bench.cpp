@@ -0,0 +1,84 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "compact.h"
+
+
+// Owners point into one preallocated array so every trial can rebuild the
+// same pattern of nulls cheaply.
+struct NoDelete
+{
+    void operator()(long*) const noexcept
+    {
+    }
+};
+
+typedef UniquePtr<long, NoDelete> Owner;
+
+
+static void build(std::vector<Owner>& items, const std::vector<long*>& pattern)
+{
+    items.clear();
+    for (long* pointer : pattern)
+        items.emplace_back(pointer);
+}
+
+
+template <typename Compact>
+double trial(std::vector<Owner>& items, const std::vector<long*>& pattern, std::size_t expected, Compact compact)
+{
+    double best = 1e30;
+    for (int repeat = 0; repeat < 3; ++repeat)
+    {
+        build(items, pattern);
+        auto start = std::chrono::steady_clock::now();
+        compact(items);
+        best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        if (items.size() != expected)
+            std::printf("wrong size %zu, expected %zu\n", items.size(), expected);
+    }
+    return best * 1e3;
+}
+
+
+int main(int argc, char** argv)
+{
+    const std::size_t size = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    std::vector<long> storage(size);
+    std::vector<Owner> items;
+    items.reserve(size);
+
+    std::printf("%zu owners, best of 3, ms\n", size);
+    std::printf("%8s %12s %12s %12s %12s\n", "nulls", "remove_if", "scalar", "avx2", "avx512");
+    const int densities[] = {0, 1, 10, 50, 90, 99};
+    for (int density : densities)
+    {
+        std::vector<long*> pattern(size);
+        std::size_t expected = 0;
+        unsigned seed = 12345;
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            const bool null = static_cast<int>((seed >> 8) % 100) < density;
+            pattern[i] = null ? nullptr : &storage[i];
+            expected += !null;
+        }
+
+        const double baseline = trial(items, pattern, expected, [](std::vector<Owner>& owners) {
+            owners.erase(std::remove_if(owners.begin(), owners.end(), [](const Owner& owner) { return !owner; }),
+                         owners.end());
+        });
+        double kernels[3];
+        const CompactKernel kinds[3] = {CompactKernel::scalar, CompactKernel::avx2, CompactKernel::avx512};
+        for (int k = 0; k < 3; ++k)
+        {
+            kernels[k] = NullCompactor::supported(kinds[k])
+                             ? trial(items, pattern, expected, [&](std::vector<Owner>& owners) { compact_nulls(owners, kinds[k]); })
+                             : 0.0;
+        }
+        std::printf("%7d%% %12.2f %12.2f %12.2f %12.2f\n", density, baseline, kernels[0], kernels[1], kernels[2]);
+    }
+    return 0;
+}
@@ -0,0 +1,148 @@
+#include <cstring>
+#include <type_traits>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+inline std::size_t NullCompactor::scalar(std::uintptr_t* const words, const std::size_t count) noexcept
+{
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const std::uintptr_t word = words[i];
+        words[kept] = word;
+        kept += word != 0;
+    }
+    return kept;
+}
+
+#if defined(__x86_64__)
+__attribute__((target("avx2"))) inline std::size_t NullCompactor::avx2(std::uintptr_t* const words,
+                                                                        const std::size_t count) noexcept
+{
+    // For each 4-bit mask of non-null lanes, the 32-bit lane indices that
+    // move those 64-bit lanes to the front.
+    alignas(32) static const std::uint32_t table[16][8] = {
+        {0, 1, 2, 3, 4, 5, 6, 7}, {0, 1, 0, 1, 0, 1, 0, 1}, {2, 3, 0, 1, 0, 1, 0, 1}, {0, 1, 2, 3, 0, 1, 0, 1},
+        {4, 5, 0, 1, 0, 1, 0, 1}, {0, 1, 4, 5, 0, 1, 0, 1}, {2, 3, 4, 5, 0, 1, 0, 1}, {0, 1, 2, 3, 4, 5, 0, 1},
+        {6, 7, 0, 1, 0, 1, 0, 1}, {0, 1, 6, 7, 0, 1, 0, 1}, {2, 3, 6, 7, 0, 1, 0, 1}, {0, 1, 2, 3, 6, 7, 0, 1},
+        {4, 5, 6, 7, 0, 1, 0, 1}, {0, 1, 4, 5, 6, 7, 0, 1}, {2, 3, 4, 5, 6, 7, 0, 1}, {0, 1, 2, 3, 4, 5, 6, 7}};
+
+    const __m256i zero = _mm256_setzero_si256();
+    std::size_t kept = 0;
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m256i lanes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i));
+        const int nulls = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(lanes, zero)));
+        const int mask = ~nulls & 0xf;
+        const __m256i order = _mm256_load_si256(reinterpret_cast<const __m256i*>(table[mask]));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(words + kept), _mm256_permutevar8x32_epi32(lanes, order));
+        kept += static_cast<std::size_t>(__builtin_popcount(mask));
+    }
+    for (; i < count; ++i)
+    {
+        const std::uintptr_t word = words[i];
+        words[kept] = word;
+        kept += word != 0;
+    }
+    return kept;
+}
+
+__attribute__((target("avx512f"))) inline std::size_t NullCompactor::avx512(std::uintptr_t* const words,
+                                                                             const std::size_t count) noexcept
+{
+    std::size_t kept = 0;
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m512i lanes = _mm512_loadu_si512(words + i);
+        const __mmask8 mask = _mm512_test_epi64_mask(lanes, lanes);
+        // A full-width store of the packed register is much cheaper than a
+        // masked compress store on several cores, and the lanes it writes
+        // past the survivors were already read.
+        _mm512_storeu_si512(words + kept, _mm512_maskz_compress_epi64(mask, lanes));
+        kept += static_cast<std::size_t>(__builtin_popcount(mask));
+    }
+    if (i < count)
+    {
+        const __mmask8 tail = static_cast<__mmask8>((1u << (count - i)) - 1);
+        const __m512i lanes = _mm512_maskz_loadu_epi64(tail, words + i);
+        const __mmask8 mask = _mm512_test_epi64_mask(lanes, lanes);
+        _mm512_mask_compressstoreu_epi64(words + kept, mask, lanes);
+        kept += static_cast<std::size_t>(__builtin_popcount(mask));
+    }
+    return kept;
+}
+#endif
+
+inline bool NullCompactor::supported(const CompactKernel kernel) noexcept
+{
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    switch (kernel)
+    {
+    case CompactKernel::avx512:
+        return __builtin_cpu_supports("avx512f");
+    case CompactKernel::avx2:
+        return __builtin_cpu_supports("avx2");
+    default:
+        return true;
+    }
+#else
+    return kernel != CompactKernel::avx2 && kernel != CompactKernel::avx512;
+#endif
+}
+
+inline CompactKernel NullCompactor::best() noexcept
+{
+    static const CompactKernel chosen = supported(CompactKernel::avx512) ? CompactKernel::avx512
+                                        : supported(CompactKernel::avx2) ? CompactKernel::avx2
+                                                                          : CompactKernel::scalar;
+    return chosen;
+}
+
+inline NullCompactor::Kernel NullCompactor::kernel(CompactKernel kernel) noexcept
+{
+    if (kernel == CompactKernel::automatic || !supported(kernel))
+        kernel = best();
+#if defined(__x86_64__)
+    switch (kernel)
+    {
+    case CompactKernel::avx512:
+        return &NullCompactor::avx512;
+    case CompactKernel::avx2:
+        return &NullCompactor::avx2;
+    default:
+        return &NullCompactor::scalar;
+    }
+#else
+    return &NullCompactor::scalar;
+#endif
+}
+
+inline std::size_t NullCompactor::compact(std::uintptr_t* const words, const std::size_t count, const CompactKernel kernel)
+{
+    return NullCompactor::kernel(kernel)(words, count);
+}
+
+template <typename T, typename Deleter>
+std::size_t compact_nulls(std::vector<UniquePtr<T, Deleter>>& items, const CompactKernel kernel)
+{
+    typedef UniquePtr<T, Deleter> Owner;
+    static_assert(sizeof(Owner) == sizeof(std::uintptr_t), "compact_nulls needs pointer-sized owners");
+    static_assert(std::is_empty<Deleter>::value, "compact_nulls needs a stateless deleter");
+    static_assert(std::is_standard_layout<Owner>::value, "compact_nulls reads owners as pointer words");
+
+    if (items.empty())
+        return 0;
+
+    std::uintptr_t* words = reinterpret_cast<std::uintptr_t*>(items.data());
+    const std::size_t kept = NullCompactor::compact(words, items.size(), kernel);
+    // The words past the survivors are stale copies of owners that moved
+    // forward; clear them so shrinking the vector destroys only nulls.
+    std::memset(static_cast<void*>(words + kept), 0, (items.size() - kept) * sizeof(std::uintptr_t));
+    const std::size_t removed = items.size() - kept;
+    items.resize(kept);
+    return removed;
+}
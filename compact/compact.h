@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "../unique_ptr/unique.h"
+
+enum class CompactKernel
+{
+    automatic,
+    scalar,
+    avx2,
+    avx512
+};
+
+// Squeezes zero words out of an array of pointer words, keeping the order
+// of the rest. The SIMD kernels compare a vector of words against zero and
+// pack the survivors to the front of the output with one permute (AVX2,
+// through a lookup table) or one compress (AVX-512). Output never overtakes
+// input, so the work is done in place. The SIMD kernels exist on x86-64
+// only; elsewhere every request falls back to the scalar kernel.
+class NullCompactor
+{
+public:
+    typedef std::size_t (*Kernel)(std::uintptr_t* words, std::size_t count);
+
+    static std::size_t compact(std::uintptr_t* words, std::size_t count, CompactKernel kernel = CompactKernel::automatic);
+    static bool supported(CompactKernel kernel) noexcept;
+    static CompactKernel best() noexcept;
+
+    static std::size_t scalar(std::uintptr_t* words, std::size_t count) noexcept;
+#if defined(__x86_64__)
+    static std::size_t avx2(std::uintptr_t* words, std::size_t count) noexcept;
+    static std::size_t avx512(std::uintptr_t* words, std::size_t count) noexcept;
+#endif
+
+private:
+    static Kernel kernel(CompactKernel kernel) noexcept;
+};
+
+// Removes the null owners from items, keeping the order of the others, and
+// returns how many were removed. No deleter runs and no owner is moved
+// through its move constructor: the pointer words are packed directly,
+// which is only valid because UniquePtr with an empty deleter is exactly
+// one pointer.
+template <typename T, typename Deleter>
+std::size_t compact_nulls(std::vector<UniquePtr<T, Deleter>>& items, CompactKernel kernel = CompactKernel::automatic);
+
+#include "compact-inl.h"
@@ -0,0 +1,103 @@
+#include <cstdint>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include "compact.h"
+
+
+struct Tracked
+{
+    static int destroyed;
+    int id;
+
+    explicit Tracked(int id) : id(id) {}
+    ~Tracked() { ++destroyed; }
+};
+
+int Tracked::destroyed = 0;
+
+
+class CompactNullsTest : public ::testing::TestWithParam<CompactKernel>
+{
+protected:
+    void SetUp() override
+    {
+        if (!NullCompactor::supported(GetParam()))
+            GTEST_SKIP() << "kernel not supported on this CPU";
+    }
+};
+
+
+TEST_P(CompactNullsTest, KeepsOrderAndOwnership)
+{
+    // Sizes around the vector widths exercise every tail length.
+    for (int size = 0; size < 40; ++size)
+    {
+        std::vector<UniquePtr<Tracked>> items;
+        std::vector<int> expected;
+        for (int i = 0; i < size; ++i)
+        {
+            if (i % 3 == 1 || i % 7 == 0)
+            {
+                items.emplace_back();
+            }
+            else
+            {
+                items.emplace_back(new Tracked(i));
+                expected.push_back(i);
+            }
+        }
+
+        Tracked::destroyed = 0;
+        EXPECT_EQ(compact_nulls(items, GetParam()), static_cast<std::size_t>(size) - expected.size());
+        EXPECT_EQ(Tracked::destroyed, 0);
+
+        std::vector<int> ids;
+        for (const UniquePtr<Tracked>& item : items)
+            ids.push_back(item->id);
+        EXPECT_EQ(ids, expected) << size;
+
+        items.clear();
+        EXPECT_EQ(Tracked::destroyed, static_cast<int>(expected.size()));
+    }
+}
+
+
+TEST_P(CompactNullsTest, MatchesScalarOnRandomWords)
+{
+    std::mt19937_64 random(GetParam() == CompactKernel::avx512 ? 1 : 2);
+    for (int density = 0; density <= 100; density += 25)
+    {
+        std::vector<std::uintptr_t> words(1003);
+        for (std::uintptr_t& word : words)
+            word = static_cast<int>(random() % 100) < density ? 0 : (random() | 1);
+        std::vector<std::uintptr_t> reference = words;
+
+        const std::size_t expected = NullCompactor::scalar(reference.data(), reference.size());
+        const std::size_t kept = NullCompactor::compact(words.data(), words.size(), GetParam());
+        ASSERT_EQ(kept, expected);
+        words.resize(kept);
+        reference.resize(expected);
+        EXPECT_EQ(words, reference) << density;
+    }
+}
+
+
+TEST_P(CompactNullsTest, AllNullAndNoNull)
+{
+    std::vector<UniquePtr<int>> empty(100);
+    EXPECT_EQ(compact_nulls(empty, GetParam()), 100u);
+    EXPECT_TRUE(empty.empty());
+
+    std::vector<UniquePtr<int>> full;
+    for (int i = 0; i < 100; ++i)
+        full.emplace_back(new int(i));
+    EXPECT_EQ(compact_nulls(full, GetParam()), 0u);
+    ASSERT_EQ(full.size(), 100u);
+    EXPECT_EQ(*full[99], 99);
+}
+
+
+INSTANTIATE_TEST_SUITE_P(Kernels, CompactNullsTest,
+                         ::testing::Values(CompactKernel::scalar, CompactKernel::avx2, CompactKernel::avx512,
+                                           CompactKernel::automatic));
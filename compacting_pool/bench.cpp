@@ -0,0 +1,86 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <unistd.h>
+#include <vector>
+#include "pool.h"
+
+
+struct Entity
+{
+    double position[3];
+    double velocity[3];
+    long id;
+    long flags;
+};
+
+
+std::size_t resident_bytes()
+{
+    long pages = 0;
+    long resident = 0;
+    FILE* file = std::fopen("/proc/self/statm", "r");
+    if (file)
+    {
+        if (std::fscanf(file, "%ld %ld", &pages, &resident) != 2)
+            resident = 0;
+        std::fclose(file);
+    }
+    return static_cast<std::size_t>(resident) * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+}
+
+
+double iterate(CompactingPool<Entity>& pool, int passes)
+{
+    double sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < passes; ++pass)
+        pool.for_each([&sum](Entity& entity) { sum += entity.position[0] + entity.velocity[0]; });
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    if (sum == 42)
+        std::printf(" ");
+    return ns / passes / static_cast<double>(pool.size());
+}
+
+
+void report(const char* stage, CompactingPool<Entity>& pool, std::size_t baseline)
+{
+    const double mib = 1 << 20;
+    std::printf("%-22s %10zu %14.1f %12.1f %14.2f\n", stage, pool.size(), pool.footprint() / mib,
+                (resident_bytes() - baseline) / mib, iterate(pool, 5));
+}
+
+
+int main(int argc, char** argv)
+{
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4000000;
+    const int keep_percent = argc > 2 ? std::atoi(argv[2]) : 10;
+
+    const std::size_t baseline = resident_bytes();
+    CompactingPool<Entity> pool(count);
+    std::vector<PoolHandle> handles;
+    handles.reserve(count);
+    for (std::size_t i = 0; i < count; ++i)
+        handles.push_back(pool.create(Entity{{1.0, 2.0, 3.0}, {0.5, 0.5, 0.5}, static_cast<long>(i), 0}));
+
+    std::printf("%zu entities of %zu bytes, keeping %d%% after the spike\n", count, sizeof(Entity), keep_percent);
+    std::printf("%-22s %10s %14s %12s %14s\n", "stage", "live", "footprint MiB", "RSS MiB", "iterate ns/obj");
+    report("after spike", pool, baseline);
+
+    // The spike drains, leaving survivors scattered over every page.
+    std::mt19937_64 random(42);
+    std::shuffle(handles.begin(), handles.end(), random);
+    const std::size_t survivors = count * static_cast<std::size_t>(keep_percent) / 100;
+    for (std::size_t i = survivors; i < count; ++i)
+        pool.destroy(handles[i]);
+    report("after churn", pool, baseline);
+
+    auto start = std::chrono::steady_clock::now();
+    const std::size_t released = pool.compact();
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    report("after compact", pool, baseline);
+    std::printf("compact() took %.1f ms and released %.1f MiB\n", ms, released / double(1 << 20));
+    return 0;
+}
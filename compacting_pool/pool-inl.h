@@ -0,0 +1,177 @@
+#include <cerrno>
+#include <new>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <sys/mman.h>
+#include <unistd.h>
+
+template <typename T>
+std::size_t CompactingPool<T>::page_round_up(const std::size_t bytes) noexcept
+{
+    static const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    return (bytes + page - 1) / page * page;
+}
+
+template <typename T>
+CompactingPool<T>::CompactingPool(const std::size_t max_objects)
+{
+    static_assert(std::is_nothrow_move_constructible<T>::value, "CompactingPool relocates objects by moving them");
+
+    reserved = max_objects;
+    mapped = page_round_up(max_objects * sizeof(T));
+    live = 0;
+    void* base = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (base == MAP_FAILED)
+        throw std::system_error(errno, std::generic_category(), "mmap");
+    slots = static_cast<T*>(base);
+}
+
+template <typename T>
+CompactingPool<T>::~CompactingPool() noexcept
+{
+    for (std::size_t slot = 0; slot < owners.size(); ++slot)
+    {
+        if (owners[slot] != npos)
+            slots[slot].~T();
+    }
+    munmap(slots, mapped);
+}
+
+template <typename T>
+template <typename Vector>
+void CompactingPool<T>::make_room(Vector& vector, const std::size_t size)
+{
+    if (vector.capacity() < size)
+        vector.reserve(size * 2 > 64 ? size * 2 : 64);
+}
+
+template <typename T>
+template <typename... Args>
+PoolHandle CompactingPool<T>::create(Args&&... args)
+{
+    if (live == reserved)
+        throw std::bad_alloc();
+
+    // Everything that can throw happens before any state changes. The free
+    // lists can never outgrow the tables, so destroy() can push onto them
+    // without allocating.
+    const std::uint32_t slot = free_slots.empty() ? static_cast<std::uint32_t>(owners.size()) : free_slots.back();
+    const std::uint32_t index = free_handles.empty() ? static_cast<std::uint32_t>(handles.size()) : free_handles.back();
+    make_room(owners, slot + std::size_t(1));
+    make_room(free_slots, owners.capacity());
+    make_room(handles, index + std::size_t(1));
+    make_room(free_handles, handles.capacity());
+    new (&slots[slot]) T(std::forward<Args>(args)...);
+
+    if (slot == owners.size())
+        owners.push_back(index);
+    else
+    {
+        free_slots.pop_back();
+        owners[slot] = index;
+    }
+    if (index == handles.size())
+        handles.push_back(HandleEntry{slot, 0});
+    else
+    {
+        free_handles.pop_back();
+        handles[index].slot = slot;
+    }
+    ++live;
+    return PoolHandle{index, handles[index].generation};
+}
+
+template <typename T>
+bool CompactingPool<T>::destroy(const PoolHandle handle) noexcept
+{
+    if (!get(handle))
+        return false;
+
+    HandleEntry& entry = handles[handle.index];
+    slots[entry.slot].~T();
+    owners[entry.slot] = npos;
+    free_slots.push_back(entry.slot);
+    free_handles.push_back(handle.index);
+    entry.slot = npos;
+    ++entry.generation;
+    --live;
+    return true;
+}
+
+template <typename T>
+T* CompactingPool<T>::get(const PoolHandle handle) const noexcept
+{
+    if (handle.index >= handles.size())
+        return nullptr;
+    const HandleEntry& entry = handles[handle.index];
+    if (entry.generation != handle.generation || entry.slot == npos)
+        return nullptr;
+    return &slots[entry.slot];
+}
+
+template <typename T>
+template <typename Func>
+void CompactingPool<T>::for_each(Func func)
+{
+    const std::size_t end = owners.size();
+    for (std::size_t slot = 0; slot < end; ++slot)
+    {
+        if (owners[slot] != npos)
+            func(slots[slot]);
+    }
+}
+
+template <typename T>
+std::size_t CompactingPool<T>::compact()
+{
+    // Every hole below the live count is filled from the top, so the live
+    // objects end up in slots [0, live).
+    std::size_t top = owners.size();
+    for (std::size_t hole = 0; hole < live; ++hole)
+    {
+        if (owners[hole] != npos)
+            continue;
+        do
+            --top;
+        while (owners[top] == npos);
+
+        new (&slots[hole]) T(std::move(slots[top]));
+        slots[top].~T();
+        owners[hole] = owners[top];
+        owners[top] = npos;
+        handles[owners[hole]].slot = static_cast<std::uint32_t>(hole);
+    }
+
+    const std::size_t keep = page_round_up(live * sizeof(T));
+    const std::size_t touched = page_round_up(owners.size() * sizeof(T));
+    // The slot bookkeeping shrinks with the slots; a fresh free list keeps
+    // its capacity invariant without touching any of its pages yet.
+    owners.resize(live);
+    owners.shrink_to_fit();
+    std::vector<std::uint32_t>().swap(free_slots);
+    free_slots.reserve(owners.capacity());
+    if (touched <= keep)
+        return 0;
+    if (madvise(reinterpret_cast<char*>(slots) + keep, touched - keep, MADV_DONTNEED) != 0)
+        throw std::system_error(errno, std::generic_category(), "madvise");
+    return touched - keep;
+}
+
+template <typename T>
+std::size_t CompactingPool<T>::size() const noexcept
+{
+    return live;
+}
+
+template <typename T>
+std::size_t CompactingPool<T>::capacity() const noexcept
+{
+    return reserved;
+}
+
+template <typename T>
+std::size_t CompactingPool<T>::footprint() const noexcept
+{
+    return owners.size() * sizeof(T);
+}
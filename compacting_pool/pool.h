@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct PoolHandle
+{
+    std::uint32_t index;
+    std::uint32_t generation;
+};
+
+// Object pool whose objects are reached through handles, so it is free to
+// move them. Slots live in one reserved anonymous mapping and are reused
+// through a free list, which after heavy churn leaves live objects spread
+// thinly over many touched pages. compact() slides the highest live objects
+// down into the lowest holes, rewrites their handle-table entries, and gives
+// every page above the dense prefix back to the kernel with MADV_DONTNEED.
+//
+// Raw pointers from get() stay valid until the object is destroyed or the
+// next compact().
+template <typename T>
+class CompactingPool
+{
+public:
+    static constexpr std::uint32_t npos = 0xffffffffu;
+
+    // Reserves address space for max_objects; pages are only touched as
+    // slots are used.
+    explicit CompactingPool(std::size_t max_objects);
+    CompactingPool(const CompactingPool&) = delete;
+    CompactingPool& operator=(const CompactingPool&) = delete;
+    ~CompactingPool() noexcept;
+
+    // Throws std::bad_alloc once max_objects are live.
+    template <typename... Args>
+    PoolHandle create(Args&&... args);
+    // False for a stale handle.
+    bool destroy(PoolHandle handle) noexcept;
+    // Null for a stale handle.
+    T* get(PoolHandle handle) const noexcept;
+
+    template <typename Func>
+    void for_each(Func func);
+    // Returns the number of bytes handed back to the kernel.
+    std::size_t compact();
+
+    std::size_t size() const noexcept;
+    std::size_t capacity() const noexcept;
+    // Bytes of slots touched since the last compaction.
+    std::size_t footprint() const noexcept;
+
+private:
+    struct HandleEntry
+    {
+        std::uint32_t slot;
+        std::uint32_t generation;
+    };
+
+    T* slots;
+    std::size_t reserved;
+    std::size_t mapped;
+    std::size_t live;
+    // Slot -> handle index, npos for free slots; its size is the high-water
+    // mark of used slots.
+    std::vector<std::uint32_t> owners;
+    std::vector<std::uint32_t> free_slots;
+    std::vector<HandleEntry> handles;
+    std::vector<std::uint32_t> free_handles;
+
+    static std::size_t page_round_up(std::size_t bytes) noexcept;
+    template <typename Vector>
+    static void make_room(Vector& vector, std::size_t size);
+};
+
+#include "pool-inl.h"
@@ -0,0 +1,122 @@
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "pool.h"
+
+
+struct Particle
+{
+    static int alive;
+
+    long id;
+    std::string tag;
+
+    Particle(long id, const std::string& tag) : id(id), tag(tag)
+    {
+        if (id < 0)
+            throw std::invalid_argument("negative id");
+        ++alive;
+    }
+
+    Particle(Particle&& other) noexcept : id(other.id), tag(std::move(other.tag))
+    {
+        ++alive;
+    }
+
+    ~Particle()
+    {
+        --alive;
+    }
+};
+
+int Particle::alive = 0;
+
+
+TEST(CompactingPoolTest, CreateGetDestroy)
+{
+    CompactingPool<Particle> pool(1000);
+    PoolHandle a = pool.create(1, "a");
+    PoolHandle b = pool.create(2, "b");
+    EXPECT_EQ(pool.size(), 2u);
+    EXPECT_EQ(pool.get(a)->tag, "a");
+    EXPECT_EQ(pool.get(b)->id, 2);
+
+    EXPECT_TRUE(pool.destroy(a));
+    EXPECT_FALSE(pool.destroy(a));
+    EXPECT_EQ(pool.get(a), nullptr);
+    PoolHandle c = pool.create(3, "c");
+    EXPECT_EQ(c.index, a.index);
+    EXPECT_EQ(pool.get(a), nullptr);
+    EXPECT_EQ(pool.get(c)->tag, "c");
+    EXPECT_EQ(pool.get(PoolHandle{77, 0}), nullptr);
+}
+
+
+TEST(CompactingPoolTest, FullPoolAndThrowingConstructorLeaveStateIntact)
+{
+    CompactingPool<Particle> pool(2);
+    PoolHandle a = pool.create(1, "a");
+    EXPECT_THROW(pool.create(-1, "bad"), std::invalid_argument);
+    EXPECT_EQ(pool.size(), 1u);
+    PoolHandle b = pool.create(2, "b");
+    EXPECT_THROW(pool.create(3, "c"), std::bad_alloc);
+    EXPECT_EQ(pool.get(a)->tag, "a");
+    EXPECT_EQ(pool.get(b)->tag, "b");
+}
+
+
+TEST(CompactingPoolTest, CompactionKeepsHandlesAndValues)
+{
+    const int alive_before = Particle::alive;
+    {
+        CompactingPool<Particle> pool(100000);
+        std::vector<PoolHandle> handles;
+        for (long i = 0; i < 50000; ++i)
+            handles.push_back(pool.create(i, std::to_string(i)));
+        const std::size_t before = pool.footprint();
+        for (long i = 0; i < 50000; ++i)
+        {
+            if (i % 10 != 0)
+                pool.destroy(handles[i]);
+        }
+        EXPECT_EQ(pool.footprint(), before);
+
+        const std::size_t released = pool.compact();
+        EXPECT_GT(released, before / 2);
+        EXPECT_EQ(pool.footprint(), 5000 * sizeof(Particle));
+        for (long i = 0; i < 50000; i += 10)
+        {
+            ASSERT_NE(pool.get(handles[i]), nullptr);
+            EXPECT_EQ(pool.get(handles[i])->id, i);
+            EXPECT_EQ(pool.get(handles[i])->tag, std::to_string(i));
+        }
+        EXPECT_EQ(pool.get(handles[1]), nullptr);
+
+        long sum = 0;
+        pool.for_each([&sum](Particle& particle) { sum += particle.id; });
+        EXPECT_EQ(sum, 5000L * 24995);
+        EXPECT_EQ(pool.compact(), 0u);
+
+        PoolHandle fresh = pool.create(7, "fresh");
+        EXPECT_EQ(pool.get(fresh)->tag, "fresh");
+        EXPECT_EQ(Particle::alive - alive_before, 5001);
+    }
+    EXPECT_EQ(Particle::alive, alive_before);
+}
+
+
+TEST(CompactingPoolTest, ReleasedPagesAreReusable)
+{
+    CompactingPool<long> pool(1 << 20);
+    std::vector<PoolHandle> handles;
+    for (long i = 0; i < (1 << 18); ++i)
+        handles.push_back(pool.create(i));
+    for (std::size_t i = 1; i < handles.size(); ++i)
+        pool.destroy(handles[i]);
+    EXPECT_GT(pool.compact(), 0u);
+    for (long i = 0; i < (1 << 18); ++i)
+        handles[static_cast<std::size_t>(i)] = pool.create(-i);
+    for (long i = 0; i < (1 << 18); i += 4097)
+        EXPECT_EQ(*pool.get(handles[static_cast<std::size_t>(i)]), -i);
+}
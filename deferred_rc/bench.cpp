@@ -0,0 +1,58 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "../shared_ptr/shared.h"
+#include "deferred.h"
+
+
+template <typename Ptr>
+void copy_loop(Ptr& source, long copies)
+{
+    for (long i = 0; i < copies; ++i)
+    {
+        Ptr local = source;
+        Ptr other = local;
+    }
+}
+
+
+template <typename Ptr, typename Sync>
+double run(int threads, long copies, Sync sync)
+{
+    Ptr source(new long(42));
+    std::vector<std::thread> workers;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&source, copies, sync]() {
+            Ptr mine = source;
+            copy_loop(mine, copies);
+            sync();
+        });
+    }
+    for (std::thread& worker : workers)
+        worker.join();
+    sync();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    return 2.0 * copies * threads / elapsed.count();
+}
+
+
+int main(int argc, char** argv)
+{
+    const int max_threads = argc > 1 ? std::atoi(argv[1]) : static_cast<int>(std::thread::hardware_concurrency());
+    const long copies = argc > 2 ? std::atol(argv[2]) : 5000000;
+
+    std::printf("%8s %18s %18s\n", "threads", "SharedPtr ops/s", "DeferredPtr ops/s");
+    for (int threads = 1; threads <= max_threads; threads *= 2)
+    {
+        double eager = run<SharedPtr<long>>(threads, copies, []() {});
+        double deferred = run<DeferredPtr<long>>(threads, copies, []() { DeferredRc::safepoint(); });
+        std::printf("%8d %18.0f %18.0f\n", threads, eager, deferred);
+    }
+    return 0;
+}
@@ -0,0 +1,259 @@
+#include <algorithm>
+
+template <typename T>
+DeferredControl<T>::DeferredControl(T* const pointer) noexcept
+{
+    this->pointer = pointer;
+    count.store(1, std::memory_order_relaxed);
+    destroy = &DeferredControl<T>::destroy_block;
+}
+
+template <typename T>
+void DeferredControl<T>::destroy_block(DeferredBlock* const block) noexcept
+{
+    DeferredControl<T>* control = static_cast<DeferredControl<T>*>(block);
+    delete control->pointer;
+    delete control;
+}
+
+inline DeferredRcLog::DeferredRcLog()
+{
+    entries.reserve(DeferredRc::log_capacity);
+
+    DeferredRc::State& state = DeferredRc::state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    epoch = state.epoch;
+    state.threads.push_back(this);
+}
+
+inline DeferredRcLog::~DeferredRcLog()
+{
+    // Objects are never destroyed here: their destructors could log into
+    // this thread's log, which is already going away.
+    DeferredRc::State& state = DeferredRc::state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    DeferredRc::submit(state, *this);
+    state.threads.erase(std::find(state.threads.begin(), state.threads.end(), this));
+}
+
+inline DeferredRc::State& DeferredRc::state() noexcept
+{
+    static State state;
+    return state;
+}
+
+inline DeferredRcLog& DeferredRc::local()
+{
+    static thread_local DeferredRcLog log;
+    return log;
+}
+
+inline void DeferredRc::log(DeferredBlock* const block, const int delta)
+{
+    DeferredRcLog& log = local();
+    log.entries.push_back(DeferredEntry{block, delta});
+    if (log.entries.size() >= log_capacity)
+        flush(log);
+}
+
+inline void DeferredRc::safepoint()
+{
+    flush(local());
+}
+
+inline std::size_t DeferredRc::pending() noexcept
+{
+    State& state = DeferredRc::state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    return state.pending;
+}
+
+inline void DeferredRc::submit(State& state, DeferredRcLog& log)
+{
+    if (log.entries.empty())
+        return;
+
+    Batch batch;
+    batch.epoch = state.epoch;
+    for (const DeferredEntry& entry : log.entries)
+    {
+        if (entry.delta > 0)
+            entry.block->count.fetch_add(entry.delta, std::memory_order_relaxed);
+        else
+            batch.decrements.push_back(entry);
+    }
+    log.entries.clear();
+
+    if (batch.decrements.empty())
+        return;
+    state.pending += batch.decrements.size();
+    state.batches.push_back(std::move(batch));
+}
+
+inline bool DeferredRc::advance(State& state) noexcept
+{
+    for (const DeferredRcLog* thread : state.threads)
+    {
+        if (thread->epoch != state.epoch)
+            return false;
+    }
+    ++state.epoch;
+    return true;
+}
+
+inline void DeferredRc::reconcile(State& state, std::vector<DeferredBlock*>& dead)
+{
+    while (!state.batches.empty() && state.batches.front().epoch + 2 <= state.epoch)
+    {
+        Batch& batch = state.batches.front();
+        for (const DeferredEntry& entry : batch.decrements)
+        {
+            if (entry.block->count.fetch_add(entry.delta, std::memory_order_relaxed) + entry.delta == 0)
+                dead.push_back(entry.block);
+        }
+        state.pending -= batch.decrements.size();
+        state.batches.pop_front();
+    }
+}
+
+inline void DeferredRc::flush(DeferredRcLog& log)
+{
+    State& state = DeferredRc::state();
+    std::vector<DeferredBlock*> dead;
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        submit(state, log);
+
+        // The calling thread has nothing left in its log, so it can
+        // acknowledge again right after the epoch moves.
+        for (int i = 0; i < 2; ++i)
+        {
+            log.epoch = state.epoch;
+            if (!advance(state))
+                break;
+        }
+        reconcile(state, dead);
+    }
+
+    for (DeferredBlock* block : dead)
+        block->destroy(block);
+}
+
+template <typename T>
+DeferredPtr<T>::DeferredPtr() noexcept
+{
+    this->pointer = nullptr;
+    block = nullptr;
+}
+
+template <typename T>
+DeferredPtr<T>::DeferredPtr(T* const pointer)
+{
+    this->pointer = pointer;
+    block = pointer ? new DeferredControl<T>(pointer) : nullptr;
+}
+
+template <typename T>
+DeferredPtr<T>::DeferredPtr(const DeferredPtr& other)
+{
+    pointer = other.pointer;
+    block = other.block;
+    if (block)
+        DeferredRc::log(block, 1);
+}
+
+template <typename T>
+DeferredPtr<T>& DeferredPtr<T>::operator=(const DeferredPtr& other)
+{
+    if (this == &other)
+        return *this;
+
+    if (other.block)
+        DeferredRc::log(other.block, 1);
+    if (block)
+        DeferredRc::log(block, -1);
+
+    pointer = other.pointer;
+    block = other.block;
+    return *this;
+}
+
+template <typename T>
+DeferredPtr<T>::DeferredPtr(DeferredPtr&& other) noexcept
+{
+    pointer = other.pointer;
+    block = other.block;
+
+    other.pointer = nullptr;
+    other.block = nullptr;
+}
+
+template <typename T>
+DeferredPtr<T>& DeferredPtr<T>::operator=(DeferredPtr&& other)
+{
+    if (this == &other)
+        return *this;
+
+    if (block)
+        DeferredRc::log(block, -1);
+
+    pointer = other.pointer;
+    block = other.block;
+
+    other.pointer = nullptr;
+    other.block = nullptr;
+
+    return *this;
+}
+
+template <typename T>
+DeferredPtr<T>::~DeferredPtr()
+{
+    if (block)
+        DeferredRc::log(block, -1);
+}
+
+template <typename T>
+T& DeferredPtr<T>::operator*() const noexcept
+{
+    return *pointer;
+}
+
+template <typename T>
+T* DeferredPtr<T>::operator->() const noexcept
+{
+    return pointer;
+}
+
+template <typename T>
+bool DeferredPtr<T>::operator!() const noexcept
+{
+    return pointer == nullptr;
+}
+
+template <typename T>
+DeferredPtr<T>::operator bool() const noexcept
+{
+    return pointer != nullptr;
+}
+
+template <typename T>
+T* DeferredPtr<T>::get() const noexcept
+{
+    return pointer;
+}
+
+template <typename T>
+void DeferredPtr<T>::reset()
+{
+    if (block)
+        DeferredRc::log(block, -1);
+    pointer = nullptr;
+    block = nullptr;
+}
+
+template <typename T>
+long DeferredPtr<T>::use_count() const noexcept
+{
+    return block ? block->count.load(std::memory_order_relaxed) : 0;
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+class DeferredBlock
+{
+public:
+    std::atomic<long> count;
+    void (*destroy)(DeferredBlock* block) noexcept;
+};
+
+template <typename T>
+class DeferredControl : public DeferredBlock
+{
+public:
+    T* pointer;
+
+    explicit DeferredControl(T* pointer) noexcept;
+    static void destroy_block(DeferredBlock* block) noexcept;
+};
+
+struct DeferredEntry
+{
+    DeferredBlock* block;
+    int delta;
+};
+
+class DeferredRcLog
+{
+public:
+    std::vector<DeferredEntry> entries;
+    std::uint64_t epoch;
+
+    DeferredRcLog();
+    DeferredRcLog(const DeferredRcLog&) = delete;
+    DeferredRcLog& operator=(const DeferredRcLog&) = delete;
+    ~DeferredRcLog();
+};
+
+// Copies and destructions of DeferredPtr only append +1/-1 entries to a
+// per-thread log. Logs are merged into the control blocks at safe points.
+// Increments are applied as soon as they are submitted; a decrement is held
+// back until every registered thread has flushed twice after it, so every
+// increment that happened before it is already counted when it is applied.
+// A thread that holds DeferredPtrs must reach safepoint() regularly (a full
+// log flushes on its own), otherwise nothing is reclaimed.
+class DeferredRc
+{
+public:
+    static const std::size_t log_capacity = 4096;
+
+    static void log(DeferredBlock* block, int delta);
+    static void safepoint();
+    static std::size_t pending() noexcept;
+
+private:
+    struct Batch
+    {
+        std::uint64_t epoch;
+        std::vector<DeferredEntry> decrements;
+    };
+
+    struct State
+    {
+        std::mutex mutex;
+        std::uint64_t epoch = 0;
+        std::vector<DeferredRcLog*> threads;
+        std::deque<Batch> batches;
+        std::size_t pending = 0;
+    };
+
+    static State& state() noexcept;
+    static DeferredRcLog& local();
+    static void submit(State& state, DeferredRcLog& log);
+    static bool advance(State& state) noexcept;
+    static void reconcile(State& state, std::vector<DeferredBlock*>& dead);
+    static void flush(DeferredRcLog& log);
+
+    friend class DeferredRcLog;
+};
+
+template <typename T>
+class DeferredPtr
+{
+private:
+    T* pointer;
+    DeferredBlock* block;
+
+public:
+    DeferredPtr() noexcept;
+    explicit DeferredPtr(T* pointer);
+    DeferredPtr(const DeferredPtr& other);
+    DeferredPtr& operator=(const DeferredPtr& other);
+    DeferredPtr(DeferredPtr&& other) noexcept;
+    DeferredPtr& operator=(DeferredPtr&& other);
+    ~DeferredPtr();
+
+    T& operator*() const noexcept;
+    T* operator->() const noexcept;
+    bool operator!() const noexcept;
+    explicit operator bool() const noexcept;
+    long use_count() const noexcept;
+    T* get() const noexcept;
+    void reset();
+};
+
+#include "deferred-inl.h"
@@ -0,0 +1,201 @@
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "deferred.h"
+#include "test_helper.h"
+
+
+template <typename T>
+class DeferredPtrTest : public ::testing::Test 
+{};
+
+typedef ::testing::Types<int, std::string> MyTypes;
+
+TYPED_TEST_SUITE(DeferredPtrTest, MyTypes);
+
+
+class Tracked
+{
+public:
+    static std::atomic<int> alive;
+    static std::atomic<int> destroyed;
+
+    Tracked() { alive.fetch_add(1); }
+    ~Tracked() { alive.fetch_sub(1); destroyed.fetch_add(1); }
+};
+
+std::atomic<int> Tracked::alive(0);
+std::atomic<int> Tracked::destroyed(0);
+
+
+TYPED_TEST(DeferredPtrTest, DefaultConstructor)
+{
+    DeferredPtr<TypeParam> ptr;
+    EXPECT_EQ(ptr.get(), nullptr);
+    EXPECT_EQ(ptr.use_count(), 0);
+}
+
+
+TYPED_TEST(DeferredPtrTest, ParameterizedConstructor)
+{
+    DeferredPtr<TypeParam> ptr(new TypeParam(TestHelper::getValue<TypeParam>()));
+    EXPECT_NE(ptr.get(), nullptr);
+    EXPECT_EQ(*ptr, TestHelper::getValue<TypeParam>());
+    EXPECT_EQ(ptr.use_count(), 1);
+}
+
+
+TYPED_TEST(DeferredPtrTest, CopyIsCountedAtSafepoint)
+{
+    DeferredPtr<TypeParam> ptr1(new TypeParam(TestHelper::getValue<TypeParam>()));
+    DeferredPtr<TypeParam> ptr2(ptr1);
+    EXPECT_EQ(ptr1.get(), ptr2.get());
+    EXPECT_EQ(ptr1.use_count(), 1);
+
+    DeferredRc::safepoint();
+    EXPECT_EQ(ptr1.use_count(), 2);
+    EXPECT_EQ(ptr2.use_count(), 2);
+}
+
+
+TYPED_TEST(DeferredPtrTest, MoveConstructor)
+{
+    DeferredPtr<TypeParam> ptr1(new TypeParam(TestHelper::getValue<TypeParam>()));
+    DeferredPtr<TypeParam> ptr2(std::move(ptr1));
+    EXPECT_EQ(ptr1.get(), nullptr);
+    EXPECT_EQ(ptr2.use_count(), 1);
+    EXPECT_EQ(*ptr2, TestHelper::getValue<TypeParam>());
+}
+
+
+TYPED_TEST(DeferredPtrTest, MoveAssignment)
+{
+    DeferredPtr<TypeParam> ptr1(new TypeParam(TestHelper::getValue<TypeParam>()));
+    DeferredPtr<TypeParam> ptr2;
+    ptr2 = std::move(ptr1);
+    EXPECT_EQ(ptr1.get(), nullptr);
+    EXPECT_EQ(ptr2.use_count(), 1);
+    EXPECT_EQ(*ptr2, TestHelper::getValue<TypeParam>());
+}
+
+
+TYPED_TEST(DeferredPtrTest, Reset)
+{
+    DeferredPtr<TypeParam> ptr1(new TypeParam(TestHelper::getValue<TypeParam>()));
+    DeferredPtr<TypeParam> ptr2 = ptr1;
+    ptr2.reset();
+    EXPECT_EQ(ptr2.get(), nullptr);
+    EXPECT_EQ(ptr2.use_count(), 0);
+
+    DeferredRc::safepoint();
+    EXPECT_EQ(ptr1.use_count(), 1);
+    EXPECT_EQ(*ptr1, TestHelper::getValue<TypeParam>());
+}
+
+
+TYPED_TEST(DeferredPtrTest, SelfCopyAssignment)
+{
+    DeferredPtr<TypeParam> ptr(new TypeParam(TestHelper::getValue<TypeParam>()));
+    DeferredPtr<TypeParam>& same = ptr;
+
+    ptr = same;
+    DeferredRc::safepoint();
+
+    EXPECT_EQ(ptr.use_count(), 1);
+    EXPECT_EQ(*ptr, TestHelper::getValue<TypeParam>());
+}
+
+
+TEST(DeferredRcTest, FreedOnlyAtSafepoint)
+{
+    const int destroyed = Tracked::destroyed.load();
+    {
+        DeferredPtr<Tracked> ptr1(new Tracked());
+        DeferredPtr<Tracked> ptr2 = ptr1;
+        DeferredPtr<Tracked> ptr3;
+        ptr3 = ptr2;
+    }
+    EXPECT_EQ(Tracked::destroyed.load(), destroyed);
+
+    DeferredRc::safepoint();
+    EXPECT_EQ(Tracked::destroyed.load(), destroyed + 1);
+    EXPECT_EQ(DeferredRc::pending(), 0u);
+}
+
+
+TEST(DeferredRcTest, CopyAssignmentReleasesOldTarget)
+{
+    const int destroyed = Tracked::destroyed.load();
+    DeferredPtr<Tracked> ptr1(new Tracked());
+    DeferredPtr<Tracked> ptr2(new Tracked());
+
+    ptr1 = ptr2;
+    DeferredRc::safepoint();
+
+    EXPECT_EQ(Tracked::destroyed.load(), destroyed + 1);
+    EXPECT_EQ(ptr2.use_count(), 2);
+}
+
+
+TEST(DeferredRcTest, FullLogFlushesItself)
+{
+    DeferredRc::safepoint();
+    DeferredPtr<int> ptr(new int(1));
+    std::vector<DeferredPtr<int>> copies(DeferredRc::log_capacity, ptr);
+
+    EXPECT_EQ(ptr.use_count(), static_cast<long>(DeferredRc::log_capacity) + 1);
+    copies.clear();
+    DeferredRc::safepoint();
+    EXPECT_EQ(ptr.use_count(), 1);
+}
+
+
+void thread_func_exchange(std::vector<DeferredPtr<Tracked>>& slots, std::mutex& mutex, int rounds)
+{
+    for (int i = 0; i < rounds; ++i)
+    {
+        DeferredPtr<Tracked> local;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            DeferredPtr<Tracked>& slot = slots[i % slots.size()];
+            local = slot;
+            if (i % 7 == 0)
+                slot = DeferredPtr<Tracked>(new Tracked());
+        }
+        DeferredPtr<Tracked> copy1 = local;
+        DeferredPtr<Tracked> copy2(copy1);
+        copy1.reset();
+
+        if (i % 64 == 0)
+            DeferredRc::safepoint();
+    }
+    DeferredRc::safepoint();
+}
+
+
+TEST(DeferredRcTest, ThreadSafty)
+{
+    const int alive = Tracked::alive.load();
+    {
+        std::mutex mutex;
+        std::vector<DeferredPtr<Tracked>> slots;
+        for (int i = 0; i < 16; ++i)
+            slots.emplace_back(new Tracked());
+
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 4; ++i)
+            threads.emplace_back(thread_func_exchange, std::ref(slots), std::ref(mutex), 20000);
+        for (std::thread& thread : threads)
+            thread.join();
+
+        DeferredRc::safepoint();
+        EXPECT_EQ(Tracked::alive.load(), alive + 16);
+        for (const DeferredPtr<Tracked>& slot : slots)
+            EXPECT_EQ(slot.use_count(), 1);
+    }
+    DeferredRc::safepoint();
+
+    EXPECT_EQ(Tracked::alive.load(), alive);
+    EXPECT_EQ(DeferredRc::pending(), 0u);
+}
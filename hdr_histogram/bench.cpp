@@ -0,0 +1,109 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "histogram.h"
+#include "../shared_ptr/shared.h"
+#include "../unique_ptr/unique.h"
+
+
+// Per-operation tail latency of the smart pointers. The saturated mode
+// times back-to-back operations; the paced mode issues them on a fixed
+// schedule and reports both raw and coordinated-omission corrected tails.
+struct Small
+{
+    long value;
+};
+
+// Final release of this runs a destructor that frees many blocks, the kind
+// of release that shows up only in the far tail.
+struct Large
+{
+    std::vector<UniquePtr<long>> parts;
+
+    explicit Large(int count)
+    {
+        for (int i = 0; i < count; ++i)
+            parts.emplace_back(new long(i));
+    }
+};
+
+
+static std::uint64_t now_ns()
+{
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+
+static void print(const char* name, const HdrHistogram& histogram)
+{
+    std::printf("%-34s %10llu %8llu %8llu %8llu %10llu\n", name, static_cast<unsigned long long>(histogram.count()),
+                static_cast<unsigned long long>(histogram.value_at_percentile(50.0)),
+                static_cast<unsigned long long>(histogram.value_at_percentile(99.0)),
+                static_cast<unsigned long long>(histogram.value_at_percentile(99.9)),
+                static_cast<unsigned long long>(histogram.max()));
+}
+
+
+// Runs setup() untimed and op() timed, either back to back or paced one per
+// interval_ns.
+template <typename Setup, typename Op>
+void measure(const char* name, long operations, std::uint64_t interval_ns, Setup setup, Op op)
+{
+    HdrHistogram raw;
+    HdrHistogram corrected;
+    std::uint64_t next = now_ns();
+    for (long i = 0; i < operations; ++i)
+    {
+        setup();
+        if (interval_ns)
+        {
+            while (now_ns() < next)
+                ;
+            next += interval_ns;
+        }
+        const std::uint64_t start = now_ns();
+        op();
+        const std::uint64_t elapsed = now_ns() - start;
+        raw.record(elapsed);
+        corrected.record_corrected(elapsed, interval_ns);
+    }
+
+    print(name, raw);
+    if (interval_ns)
+    {
+        char label[64];
+        std::snprintf(label, sizeof(label), "  corrected for %lluns pacing", static_cast<unsigned long long>(interval_ns));
+        print(label, corrected);
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    const long operations = argc > 1 ? std::atol(argv[1]) : 200000;
+    const std::uint64_t interval_ns = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 2000;
+    const int large_parts = argc > 3 ? std::atoi(argv[3]) : 1000;
+
+    SharedPtr<Small> source(new Small{1});
+    SharedPtr<Small> copy;
+    SharedPtr<Large> last;
+    UniquePtr<Small> unique;
+
+    std::printf("%-34s %10s %8s %8s %8s %10s\n", "operation (ns)", "count", "p50", "p99", "p99.9", "max");
+    for (int paced = 0; paced < 2; ++paced)
+    {
+        const std::uint64_t interval = paced ? interval_ns : 0;
+        std::printf(paced ? "paced, one operation every %lluns\n" : "saturated\n", static_cast<unsigned long long>(interval));
+        measure("SharedPtr copy", operations, interval, [&]() { copy.reset(); }, [&]() { copy = source; });
+        measure("SharedPtr release (shared)", operations, interval, [&]() { copy = source; }, [&]() { copy.reset(); });
+        measure("SharedPtr final release (large)", operations / 20, interval,
+                [&]() { last = SharedPtr<Large>(new Large(large_parts)); }, [&]() { last.reset(); });
+        measure("UniquePtr new + delete", operations, interval, []() {},
+                [&]() { unique = UniquePtr<Small>(new Small{2}); unique.reset(); });
+    }
+    return 0;
+}
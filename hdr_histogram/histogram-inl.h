@@ -0,0 +1,204 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+inline HdrHistogram::HdrHistogram(const std::uint64_t lowest, const std::uint64_t highest, const int digits)
+{
+    if (lowest < 1 || highest < 2 * lowest || digits < 1 || digits > 5)
+        throw std::invalid_argument("HdrHistogram needs 1 <= lowest, 2 * lowest <= highest and 1..5 digits");
+
+    this->lowest = lowest;
+    this->highest = highest;
+    this->digits = digits;
+
+    const double largest_single_unit = 2.0 * std::pow(10.0, digits);
+    const int sub_bucket_count_magnitude = static_cast<int>(std::ceil(std::log2(largest_single_unit)));
+    sub_bucket_half_count_magnitude = std::max(sub_bucket_count_magnitude, 1) - 1;
+    unit_magnitude = 63 - __builtin_clzll(lowest);
+    sub_bucket_count = std::int64_t(1) << (sub_bucket_half_count_magnitude + 1);
+    sub_bucket_half_count = sub_bucket_count / 2;
+    sub_bucket_mask = static_cast<std::uint64_t>(sub_bucket_count - 1) << unit_magnitude;
+
+    // Each bucket doubles the range the previous one covered.
+    std::uint64_t smallest_untrackable = static_cast<std::uint64_t>(sub_bucket_count) << unit_magnitude;
+    bucket_count = 1;
+    while (smallest_untrackable <= highest)
+    {
+        if (smallest_untrackable > UINT64_MAX / 2)
+        {
+            ++bucket_count;
+            break;
+        }
+        smallest_untrackable <<= 1;
+        ++bucket_count;
+    }
+
+    counts = std::vector<std::atomic<std::uint64_t>>(static_cast<std::size_t>((bucket_count + 1) * sub_bucket_half_count));
+    reset();
+}
+
+inline std::size_t HdrHistogram::index_of(const std::uint64_t value) const noexcept
+{
+    const int pow2_ceiling = 64 - __builtin_clzll(value | sub_bucket_mask);
+    const int bucket = pow2_ceiling - unit_magnitude - (sub_bucket_half_count_magnitude + 1);
+    const std::int64_t sub_bucket = static_cast<std::int64_t>(value >> (bucket + unit_magnitude));
+    return static_cast<std::size_t>((static_cast<std::int64_t>(bucket + 1) << sub_bucket_half_count_magnitude) +
+                                    (sub_bucket - sub_bucket_half_count));
+}
+
+inline std::uint64_t HdrHistogram::value_at_index(const std::size_t index) const noexcept
+{
+    int bucket = static_cast<int>(index >> sub_bucket_half_count_magnitude) - 1;
+    std::int64_t sub_bucket = static_cast<std::int64_t>(index & (sub_bucket_half_count - 1)) + sub_bucket_half_count;
+    if (bucket < 0)
+    {
+        sub_bucket -= sub_bucket_half_count;
+        bucket = 0;
+    }
+    return static_cast<std::uint64_t>(sub_bucket) << (bucket + unit_magnitude);
+}
+
+inline std::uint64_t HdrHistogram::highest_equivalent(const std::uint64_t value) const noexcept
+{
+    const int pow2_ceiling = 64 - __builtin_clzll(value | sub_bucket_mask);
+    const int bucket = pow2_ceiling - unit_magnitude - (sub_bucket_half_count_magnitude + 1);
+    const std::int64_t sub_bucket = static_cast<std::int64_t>(value >> (bucket + unit_magnitude));
+    const int adjusted = bucket + (sub_bucket >= sub_bucket_count ? 1 : 0);
+    const std::uint64_t lowest_equivalent = static_cast<std::uint64_t>(sub_bucket) << (bucket + unit_magnitude);
+    return lowest_equivalent + (std::uint64_t(1) << (unit_magnitude + adjusted)) - 1;
+}
+
+inline void HdrHistogram::add_count(const std::size_t index, const std::uint64_t count) noexcept
+{
+    // Single writer: a plain load and store keeps the counter readable from
+    // other threads without paying for a locked instruction.
+    counts[index].store(counts[index].load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+}
+
+inline void HdrHistogram::record(std::uint64_t value, const std::uint64_t count) noexcept
+{
+    value = std::min(value, highest);
+    add_count(index_of(value), count);
+    total.store(total.load(std::memory_order_relaxed) + count, std::memory_order_release);
+    if (value < min_value.load(std::memory_order_relaxed))
+        min_value.store(value, std::memory_order_relaxed);
+    if (value > max_value.load(std::memory_order_relaxed))
+        max_value.store(value, std::memory_order_relaxed);
+}
+
+inline void HdrHistogram::record_corrected(const std::uint64_t value, const std::uint64_t expected_interval) noexcept
+{
+    record(value);
+    if (expected_interval == 0)
+        return;
+    for (std::uint64_t missing = value; missing > expected_interval;)
+    {
+        missing -= expected_interval;
+        record(missing);
+    }
+}
+
+inline void HdrHistogram::add(const HdrHistogram& other) noexcept
+{
+    for (std::size_t i = 0; i < counts.size() && i < other.counts.size(); ++i)
+    {
+        const std::uint64_t count = other.counts[i].load(std::memory_order_relaxed);
+        if (count)
+            add_count(i, count);
+    }
+    total.store(total.load(std::memory_order_relaxed) + other.count(), std::memory_order_release);
+    if (other.count())
+    {
+        min_value.store(std::min(min(), other.min()), std::memory_order_relaxed);
+        max_value.store(std::max(max(), other.max()), std::memory_order_relaxed);
+    }
+}
+
+inline void HdrHistogram::reset() noexcept
+{
+    for (std::atomic<std::uint64_t>& count : counts)
+        count.store(0, std::memory_order_relaxed);
+    total.store(0, std::memory_order_relaxed);
+    min_value.store(UINT64_MAX, std::memory_order_relaxed);
+    max_value.store(0, std::memory_order_relaxed);
+}
+
+inline std::uint64_t HdrHistogram::value_at_percentile(const double percentile) const noexcept
+{
+    const std::uint64_t recorded = count();
+    if (recorded == 0)
+        return 0;
+
+    const double clamped = std::min(std::max(percentile, 0.0), 100.0);
+    const std::uint64_t wanted = std::max<std::uint64_t>(
+        1, static_cast<std::uint64_t>(clamped / 100.0 * static_cast<double>(recorded) + 0.5));
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < counts.size(); ++i)
+    {
+        seen += counts[i].load(std::memory_order_relaxed);
+        if (seen >= wanted)
+            return std::min(highest_equivalent(value_at_index(i)), max());
+    }
+    return max();
+}
+
+inline std::uint64_t HdrHistogram::count() const noexcept
+{
+    return total.load(std::memory_order_acquire);
+}
+
+inline std::uint64_t HdrHistogram::min() const noexcept
+{
+    return count() ? min_value.load(std::memory_order_relaxed) : 0;
+}
+
+inline std::uint64_t HdrHistogram::max() const noexcept
+{
+    return max_value.load(std::memory_order_relaxed);
+}
+
+inline double HdrHistogram::mean() const noexcept
+{
+    const std::uint64_t recorded = count();
+    if (recorded == 0)
+        return 0.0;
+
+    double sum = 0.0;
+    for (std::size_t i = 0; i < counts.size(); ++i)
+    {
+        const std::uint64_t count = counts[i].load(std::memory_order_relaxed);
+        if (count)
+        {
+            const std::uint64_t low = value_at_index(i);
+            sum += static_cast<double>(count) * (static_cast<double>(low) + static_cast<double>(highest_equivalent(low))) / 2.0;
+        }
+    }
+    return sum / static_cast<double>(recorded);
+}
+
+inline std::size_t HdrHistogram::memory_size() const noexcept
+{
+    return sizeof(*this) + counts.size() * sizeof(std::atomic<std::uint64_t>);
+}
+
+inline HistogramGroup::HistogramGroup(const std::uint64_t lowest, const std::uint64_t highest, const int digits)
+{
+    this->lowest = lowest;
+    this->highest = highest;
+    this->digits = digits;
+}
+
+inline HdrHistogram& HistogramGroup::acquire()
+{
+    UniquePtr<HdrHistogram> histogram(new HdrHistogram(lowest, highest, digits));
+    std::lock_guard<std::mutex> lock(mutex);
+    histograms.push_back(std::move(histogram));
+    return *histograms.back();
+}
+
+inline void HistogramGroup::merge_into(HdrHistogram& result)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const UniquePtr<HdrHistogram>& histogram : histograms)
+        result.add(*histogram);
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "../unique_ptr/unique.h"
+
+// High dynamic range histogram: values are kept to a fixed number of
+// significant decimal digits over the whole range from lowest to highest,
+// using power-of-two buckets split into linear sub-buckets. Only one thread
+// may record into a histogram, but recording uses no locks or atomic
+// read-modify-writes, and other threads may read or merge it at any time.
+class HdrHistogram
+{
+private:
+    std::uint64_t lowest;
+    std::uint64_t highest;
+    int digits;
+    int unit_magnitude;
+    int sub_bucket_half_count_magnitude;
+    std::int64_t sub_bucket_count;
+    std::int64_t sub_bucket_half_count;
+    std::uint64_t sub_bucket_mask;
+    int bucket_count;
+    std::vector<std::atomic<std::uint64_t>> counts;
+    std::atomic<std::uint64_t> total;
+    std::atomic<std::uint64_t> min_value;
+    std::atomic<std::uint64_t> max_value;
+
+    std::size_t index_of(std::uint64_t value) const noexcept;
+    std::uint64_t value_at_index(std::size_t index) const noexcept;
+    std::uint64_t highest_equivalent(std::uint64_t value) const noexcept;
+    void add_count(std::size_t index, std::uint64_t count) noexcept;
+
+public:
+    // Values are typically nanoseconds; the defaults track 1 ns to one hour
+    // at three significant digits.
+    explicit HdrHistogram(std::uint64_t lowest = 1, std::uint64_t highest = 3600000000000ull, int digits = 3);
+    HdrHistogram(const HdrHistogram&) = delete;
+    HdrHistogram& operator=(const HdrHistogram&) = delete;
+
+    // Values above highest are recorded as highest.
+    void record(std::uint64_t value, std::uint64_t count = 1) noexcept;
+    // Coordinated-omission correction for paced loops: a value longer than
+    // the expected interval also stands for the requests that should have
+    // been issued while it was stalled, so those are back-filled.
+    void record_corrected(std::uint64_t value, std::uint64_t expected_interval) noexcept;
+    // Both histograms must share the same layout.
+    void add(const HdrHistogram& other) noexcept;
+    void reset() noexcept;
+
+    std::uint64_t value_at_percentile(double percentile) const noexcept;
+    std::uint64_t count() const noexcept;
+    std::uint64_t min() const noexcept;
+    std::uint64_t max() const noexcept;
+    double mean() const noexcept;
+    std::size_t memory_size() const noexcept;
+};
+
+// Hands every recording thread its own histogram and merges them on
+// demand, so threads never share a cache line while recording.
+class HistogramGroup
+{
+private:
+    std::mutex mutex;
+    std::vector<UniquePtr<HdrHistogram>> histograms;
+    std::uint64_t lowest;
+    std::uint64_t highest;
+    int digits;
+
+public:
+    explicit HistogramGroup(std::uint64_t lowest = 1, std::uint64_t highest = 3600000000000ull, int digits = 3);
+
+    // Call once per thread; the histogram lives as long as the group.
+    HdrHistogram& acquire();
+    void merge_into(HdrHistogram& result);
+};
+
+#include "histogram-inl.h"
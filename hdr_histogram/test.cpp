@@ -0,0 +1,109 @@
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "histogram.h"
+
+
+TEST(HdrHistogramTest, EmptyHistogram)
+{
+    HdrHistogram histogram;
+    EXPECT_EQ(histogram.count(), 0u);
+    EXPECT_EQ(histogram.value_at_percentile(99.0), 0u);
+    EXPECT_EQ(histogram.min(), 0u);
+    EXPECT_EQ(histogram.max(), 0u);
+}
+
+
+TEST(HdrHistogramTest, RejectsBadLayout)
+{
+    EXPECT_THROW(HdrHistogram(0, 100, 3), std::invalid_argument);
+    EXPECT_THROW(HdrHistogram(1, 100, 6), std::invalid_argument);
+}
+
+
+TEST(HdrHistogramTest, PercentilesStayWithinPrecision)
+{
+    HdrHistogram histogram(1, 3600000000000ull, 3);
+    for (std::uint64_t value = 1; value <= 100000; ++value)
+        histogram.record(value * 1000);
+
+    EXPECT_EQ(histogram.count(), 100000u);
+    EXPECT_EQ(histogram.min(), 1000u);
+    EXPECT_EQ(histogram.max(), 100000000u);
+
+    const double percentiles[] = {50.0, 90.0, 99.0, 99.9, 99.99};
+    for (double percentile : percentiles)
+    {
+        const double exact = percentile / 100.0 * 100000.0 * 1000.0;
+        const double reported = static_cast<double>(histogram.value_at_percentile(percentile));
+        EXPECT_NEAR(reported, exact, exact * 0.001) << percentile;
+    }
+    EXPECT_EQ(histogram.value_at_percentile(100.0), 100000000u);
+    EXPECT_NEAR(histogram.mean(), 50000500.0, 50000500.0 * 0.001);
+}
+
+
+TEST(HdrHistogramTest, SmallValuesAreExact)
+{
+    HdrHistogram histogram;
+    for (std::uint64_t value = 0; value < 2048; ++value)
+        histogram.record(value);
+    EXPECT_EQ(histogram.value_at_percentile(50.0), 1023u);
+    EXPECT_EQ(histogram.value_at_percentile(100.0), 2047u);
+}
+
+
+TEST(HdrHistogramTest, ValuesAboveHighestAreClamped)
+{
+    HdrHistogram histogram(1, 1000000, 2);
+    histogram.record(5000000);
+    EXPECT_EQ(histogram.max(), 1000000u);
+}
+
+
+TEST(HdrHistogramTest, CorrectsCoordinatedOmission)
+{
+    // A paced loop issues one request every 10us. A 1ms stall hides 99
+    // requests that would each have waited part of it.
+    HdrHistogram raw;
+    HdrHistogram corrected;
+    for (int i = 0; i < 900; ++i)
+    {
+        raw.record(1000);
+        corrected.record_corrected(1000, 10000);
+    }
+    raw.record(1000000);
+    corrected.record_corrected(1000000, 10000);
+
+    EXPECT_EQ(raw.count(), 901u);
+    EXPECT_EQ(corrected.count(), 1000u);
+    EXPECT_LT(raw.value_at_percentile(99.0), 1100u);
+    EXPECT_GT(corrected.value_at_percentile(99.0), 10000u);
+    EXPECT_EQ(raw.max(), corrected.max());
+}
+
+
+TEST(HdrHistogramTest, GroupMergesPerThreadHistograms)
+{
+    HistogramGroup group;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&group, t]() {
+            HdrHistogram& mine = group.acquire();
+            for (std::uint64_t i = 0; i < 1000; ++i)
+                mine.record(static_cast<std::uint64_t>(t + 1) * 100);
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+
+    HdrHistogram merged;
+    group.merge_into(merged);
+    EXPECT_EQ(merged.count(), 4000u);
+    EXPECT_EQ(merged.min(), 100u);
+    EXPECT_EQ(merged.max(), 400u);
+    EXPECT_EQ(merged.value_at_percentile(50.0), 200u);
+}
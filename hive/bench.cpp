@@ -0,0 +1,149 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <list>
+#include <random>
+#include <vector>
+#include "../unique_ptr/unique.h"
+#include "hive.h"
+
+
+struct Particle
+{
+    double x, y, z;
+    double vx, vy, vz;
+    int alive;
+};
+
+
+struct Timings
+{
+    double insert;
+    double erase;
+    double iterate;
+    double sum;
+};
+
+
+double seconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+Particle make_particle(std::size_t i)
+{
+    double v = static_cast<double>(i);
+    return Particle{v, v, v, 1.0, 1.0, 1.0, static_cast<int>(i % 2)};
+}
+
+
+Timings run_hive(std::size_t count, int passes)
+{
+    Timings timings = {0, 0, 0, 0};
+    Hive<Particle> hive;
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < count; ++i)
+        hive.insert(make_particle(i));
+    timings.insert = seconds_since(start);
+
+    start = std::chrono::steady_clock::now();
+    for (Hive<Particle>::iterator it = hive.begin(); it != hive.end(); )
+        it = it->alive ? std::next(it) : hive.erase(it);
+    for (std::size_t i = 0; i < count / 4; ++i)
+        hive.insert(make_particle(i * 2 + 1));
+    timings.erase = seconds_since(start);
+
+    start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < passes; ++pass)
+    {
+        for (Particle& particle : hive)
+        {
+            particle.x += particle.vx;
+            timings.sum += particle.x;
+        }
+    }
+    timings.iterate = seconds_since(start);
+    return timings;
+}
+
+
+Timings run_vector(std::size_t count, int passes)
+{
+    Timings timings = {0, 0, 0, 0};
+    std::vector<UniquePtr<Particle>> particles;
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < count; ++i)
+        particles.emplace_back(new Particle(make_particle(i)));
+    timings.insert = seconds_since(start);
+
+    start = std::chrono::steady_clock::now();
+    particles.erase(std::remove_if(particles.begin(), particles.end(),
+                                   [](const UniquePtr<Particle>& particle) { return !particle->alive; }),
+                    particles.end());
+    for (std::size_t i = 0; i < count / 4; ++i)
+        particles.emplace_back(new Particle(make_particle(i * 2 + 1)));
+    timings.erase = seconds_since(start);
+
+    start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < passes; ++pass)
+    {
+        for (const UniquePtr<Particle>& particle : particles)
+        {
+            particle->x += particle->vx;
+            timings.sum += particle->x;
+        }
+    }
+    timings.iterate = seconds_since(start);
+    return timings;
+}
+
+
+Timings run_list(std::size_t count, int passes)
+{
+    Timings timings = {0, 0, 0, 0};
+    std::list<Particle> particles;
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < count; ++i)
+        particles.push_back(make_particle(i));
+    timings.insert = seconds_since(start);
+
+    start = std::chrono::steady_clock::now();
+    particles.remove_if([](const Particle& particle) { return !particle.alive; });
+    for (std::size_t i = 0; i < count / 4; ++i)
+        particles.push_back(make_particle(i * 2 + 1));
+    timings.erase = seconds_since(start);
+
+    start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < passes; ++pass)
+    {
+        for (Particle& particle : particles)
+        {
+            particle.x += particle.vx;
+            timings.sum += particle.x;
+        }
+    }
+    timings.iterate = seconds_since(start);
+    return timings;
+}
+
+
+int main(int argc, char** argv)
+{
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4000000;
+    const int passes = argc > 2 ? std::atoi(argv[2]) : 10;
+
+    std::printf("%zu elements, 50%% erased, 25%% reinserted, %d iteration passes\n", count, passes);
+    std::printf("%-24s %10s %14s %10s\n", "container", "insert s", "erase+insert s", "iterate s");
+    Timings timings = run_hive(count, passes);
+    std::printf("%-24s %10.3f %14.3f %10.3f\n", "Hive", timings.insert, timings.erase, timings.iterate);
+    timings = run_vector(count, passes);
+    std::printf("%-24s %10.3f %14.3f %10.3f\n", "vector<UniquePtr>", timings.insert, timings.erase, timings.iterate);
+    timings = run_list(count, passes);
+    std::printf("%-24s %10.3f %14.3f %10.3f\n", "std::list", timings.insert, timings.erase, timings.iterate);
+    return 0;
+}
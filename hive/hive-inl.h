@@ -0,0 +1,410 @@
+#include <new>
+#include <utility>
+
+template <typename T>
+Hive<T>::iterator::iterator() noexcept
+{
+    block = nullptr;
+    index = 0;
+}
+
+template <typename T>
+Hive<T>::iterator::iterator(Block* const block, const std::uint16_t index) noexcept
+{
+    this->block = block;
+    this->index = index;
+}
+
+template <typename T>
+T& Hive<T>::iterator::operator*() const noexcept
+{
+    return block->slots[index].value;
+}
+
+template <typename T>
+T* Hive<T>::iterator::operator->() const noexcept
+{
+    return &block->slots[index].value;
+}
+
+template <typename T>
+typename Hive<T>::iterator& Hive<T>::iterator::operator++() noexcept
+{
+    ++index;
+    index = static_cast<std::uint16_t>(index + block->skip[index]);
+    if (index >= block->end)
+    {
+        block = block->next;
+        index = block ? block->skip[0] : 0;
+    }
+    return *this;
+}
+
+template <typename T>
+typename Hive<T>::iterator Hive<T>::iterator::operator++(int) noexcept
+{
+    iterator previous = *this;
+    ++*this;
+    return previous;
+}
+
+template <typename T>
+bool Hive<T>::iterator::operator==(const iterator& other) const noexcept
+{
+    return block == other.block && index == other.index;
+}
+
+template <typename T>
+bool Hive<T>::iterator::operator!=(const iterator& other) const noexcept
+{
+    return !(*this == other);
+}
+
+template <typename T>
+Hive<T>::Hive() noexcept
+{
+    first = nullptr;
+    last = nullptr;
+    free_blocks = nullptr;
+    count = 0;
+    reserved = 0;
+}
+
+template <typename T>
+Hive<T>::Hive(Hive&& other) noexcept
+{
+    first = other.first;
+    last = other.last;
+    free_blocks = other.free_blocks;
+    count = other.count;
+    reserved = other.reserved;
+
+    other.first = nullptr;
+    other.last = nullptr;
+    other.free_blocks = nullptr;
+    other.count = 0;
+    other.reserved = 0;
+}
+
+template <typename T>
+Hive<T>& Hive<T>::operator=(Hive&& other) noexcept
+{
+    if (this == &other)
+        return *this;
+
+    clear();
+
+    first = other.first;
+    last = other.last;
+    free_blocks = other.free_blocks;
+    count = other.count;
+    reserved = other.reserved;
+
+    other.first = nullptr;
+    other.last = nullptr;
+    other.free_blocks = nullptr;
+    other.count = 0;
+    other.reserved = 0;
+
+    return *this;
+}
+
+template <typename T>
+Hive<T>::~Hive() noexcept
+{
+    clear();
+}
+
+template <typename T>
+typename Hive<T>::Block* Hive<T>::allocate_block(const std::uint16_t capacity)
+{
+    Block* block = new Block;
+    block->slots = nullptr;
+    try
+    {
+        block->slots = std::allocator<Slot>().allocate(capacity);
+        block->skip = new std::uint16_t[capacity + 1u]();
+    }
+    catch (...)
+    {
+        if (block->slots)
+            std::allocator<Slot>().deallocate(block->slots, capacity);
+        delete block;
+        throw;
+    }
+    block->capacity = capacity;
+    block->end = 0;
+    block->size = 0;
+    block->free_head = none;
+    block->previous = last;
+    block->next = nullptr;
+    block->previous_free = nullptr;
+    block->next_free = nullptr;
+
+    if (last)
+        last->next = block;
+    else
+        first = block;
+    last = block;
+    reserved += capacity;
+    return block;
+}
+
+template <typename T>
+void Hive<T>::deallocate_block(Block* const block) noexcept
+{
+    unlink_block(block);
+    if (block->free_head != none)
+        remove_free_block(block);
+
+    reserved -= block->capacity;
+    std::allocator<Slot>().deallocate(block->slots, block->capacity);
+    delete[] block->skip;
+    delete block;
+}
+
+template <typename T>
+void Hive<T>::unlink_block(Block* const block) noexcept
+{
+    if (block->previous)
+        block->previous->next = block->next;
+    else
+        first = block->next;
+    if (block->next)
+        block->next->previous = block->previous;
+    else
+        last = block->previous;
+}
+
+template <typename T>
+void Hive<T>::push_free_block(Block* const block) noexcept
+{
+    block->previous_free = nullptr;
+    block->next_free = free_blocks;
+    if (free_blocks)
+        free_blocks->previous_free = block;
+    free_blocks = block;
+}
+
+template <typename T>
+void Hive<T>::remove_free_block(Block* const block) noexcept
+{
+    if (block->previous_free)
+        block->previous_free->next_free = block->next_free;
+    else
+        free_blocks = block->next_free;
+    if (block->next_free)
+        block->next_free->previous_free = block->previous_free;
+}
+
+template <typename T>
+void Hive<T>::push_free_run(Block* const block, const std::uint16_t start) noexcept
+{
+    FreeLinks& links = block->slots[start].links;
+    links.previous = none;
+    links.next = block->free_head;
+    if (block->free_head != none)
+        block->slots[block->free_head].links.previous = start;
+    else
+        push_free_block(block);
+    block->free_head = start;
+}
+
+template <typename T>
+void Hive<T>::remove_free_run(Block* const block, const std::uint16_t start) noexcept
+{
+    const FreeLinks links = block->slots[start].links;
+    if (links.previous != none)
+        block->slots[links.previous].links.next = links.next;
+    else
+        block->free_head = links.next;
+    if (links.next != none)
+        block->slots[links.next].links.previous = links.previous;
+
+    if (block->free_head == none)
+        remove_free_block(block);
+}
+
+template <typename T>
+std::uint16_t Hive<T>::take_free_slot(Block* const block) noexcept
+{
+    std::uint16_t* skip = block->skip;
+    const std::uint16_t start = block->free_head;
+    const std::uint16_t length = skip[start];
+
+    remove_free_run(block, start);
+    skip[start] = 0;
+    if (length > 1)
+    {
+        const std::uint16_t rest = static_cast<std::uint16_t>(length - 1);
+        skip[start + 1] = rest;
+        skip[start + length - 1] = rest;
+        push_free_run(block, static_cast<std::uint16_t>(start + 1));
+    }
+    return start;
+}
+
+template <typename T>
+void Hive<T>::mark_erased(Block* const block, const std::uint16_t index) noexcept
+{
+    // An erased neighbour on the left is the last slot of its run and one on
+    // the right is the first, so both hold their run lengths.
+    std::uint16_t* skip = block->skip;
+    const std::uint16_t left = index > 0 ? skip[index - 1] : 0;
+    const std::uint16_t right = skip[index + 1];
+
+    if (left == 0 && right == 0)
+    {
+        skip[index] = 1;
+        push_free_run(block, index);
+    }
+    else if (right == 0)
+    {
+        const std::uint16_t length = static_cast<std::uint16_t>(left + 1);
+        skip[index - left] = length;
+        skip[index] = length;
+    }
+    else if (left == 0)
+    {
+        const std::uint16_t length = static_cast<std::uint16_t>(right + 1);
+        remove_free_run(block, static_cast<std::uint16_t>(index + 1));
+        skip[index] = length;
+        skip[index + right] = length;
+        push_free_run(block, index);
+    }
+    else
+    {
+        const std::uint16_t length = static_cast<std::uint16_t>(left + right + 1);
+        remove_free_run(block, static_cast<std::uint16_t>(index + 1));
+        skip[index - left] = length;
+        skip[index + right] = length;
+    }
+}
+
+template <typename T>
+template <typename... Args>
+typename Hive<T>::iterator Hive<T>::emplace(Args&&... args)
+{
+    Block* block;
+    std::uint16_t index;
+    bool reused = false;
+
+    if (free_blocks)
+    {
+        block = free_blocks;
+        index = take_free_slot(block);
+        reused = true;
+    }
+    else
+    {
+        block = last;
+        if (block == nullptr || block->end == block->capacity)
+        {
+            std::size_t capacity = reserved < min_block ? min_block : reserved;
+            block = allocate_block(static_cast<std::uint16_t>(capacity > max_block ? max_block : capacity));
+        }
+        index = block->end++;
+    }
+
+    try
+    {
+        new (&block->slots[index].value) T(std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+        if (reused)
+            mark_erased(block, index);
+        else if (--block->end == 0)
+            deallocate_block(block);
+        throw;
+    }
+
+    ++block->size;
+    ++count;
+    return iterator(block, index);
+}
+
+template <typename T>
+typename Hive<T>::iterator Hive<T>::insert(const T& value)
+{
+    return emplace(value);
+}
+
+template <typename T>
+typename Hive<T>::iterator Hive<T>::insert(T&& value)
+{
+    return emplace(std::move(value));
+}
+
+template <typename T>
+typename Hive<T>::iterator Hive<T>::erase(const iterator position) noexcept
+{
+    Block* block = position.block;
+    const std::uint16_t index = position.index;
+    iterator next = position;
+    ++next;
+
+    block->slots[index].value.~T();
+    --count;
+    if (--block->size == 0)
+        deallocate_block(block);
+    else
+        mark_erased(block, index);
+    return next;
+}
+
+template <typename T>
+void Hive<T>::clear() noexcept
+{
+    while (first)
+    {
+        Block* block = first;
+        for (std::uint16_t i = block->skip[0]; i < block->end; )
+        {
+            block->slots[i].value.~T();
+            ++i;
+            i = static_cast<std::uint16_t>(i + block->skip[i]);
+        }
+        deallocate_block(block);
+    }
+    count = 0;
+}
+
+template <typename T>
+typename Hive<T>::iterator Hive<T>::begin() const noexcept
+{
+    return first ? iterator(first, first->skip[0]) : iterator();
+}
+
+template <typename T>
+typename Hive<T>::iterator Hive<T>::end() const noexcept
+{
+    return iterator();
+}
+
+template <typename T>
+std::size_t Hive<T>::size() const noexcept
+{
+    return count;
+}
+
+template <typename T>
+std::size_t Hive<T>::capacity() const noexcept
+{
+    return reserved;
+}
+
+template <typename T>
+bool Hive<T>::empty() const noexcept
+{
+    return count == 0;
+}
+
+template <typename T>
+std::size_t Hive<T>::block_count() const noexcept
+{
+    std::size_t blocks = 0;
+    for (Block* block = first; block; block = block->next)
+        ++blocks;
+    return blocks;
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+
+// Unordered container that allocates elements in growing contiguous blocks.
+// Insertion and erasure never move other elements, so pointers and
+// iterators to them stay valid. Erased slots are tracked with a jump-counting
+// skipfield: the first and last entries of every run of erased slots hold
+// the run length, which lets iteration hop over the run in one step. Each
+// run is also kept on a per-block free list and reused from its front.
+template <typename T>
+class Hive
+{
+private:
+    static const std::uint16_t none = 0xffff;
+
+    struct FreeLinks
+    {
+        std::uint16_t previous;
+        std::uint16_t next;
+    };
+
+    union Slot
+    {
+        T value;
+        FreeLinks links;
+
+        Slot() noexcept {}
+        ~Slot() noexcept {}
+    };
+
+    struct Block
+    {
+        Slot* slots;
+        std::uint16_t* skip;
+        std::uint16_t capacity;
+        std::uint16_t end;
+        std::uint16_t size;
+        std::uint16_t free_head;
+        Block* previous;
+        Block* next;
+        Block* previous_free;
+        Block* next_free;
+    };
+
+    Block* first;
+    Block* last;
+    Block* free_blocks;
+    std::size_t count;
+    std::size_t reserved;
+
+    Block* allocate_block(std::uint16_t capacity);
+    void deallocate_block(Block* block) noexcept;
+    void unlink_block(Block* block) noexcept;
+    void push_free_block(Block* block) noexcept;
+    void remove_free_block(Block* block) noexcept;
+    void mark_erased(Block* block, std::uint16_t index) noexcept;
+    void push_free_run(Block* block, std::uint16_t start) noexcept;
+    void remove_free_run(Block* block, std::uint16_t start) noexcept;
+    std::uint16_t take_free_slot(Block* block) noexcept;
+
+public:
+    static const std::uint16_t min_block = 8;
+    static const std::uint16_t max_block = 8192;
+
+    class iterator
+    {
+    private:
+        Block* block;
+        std::uint16_t index;
+
+        iterator(Block* block, std::uint16_t index) noexcept;
+
+        friend class Hive;
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef T* pointer;
+        typedef T& reference;
+
+        iterator() noexcept;
+
+        T& operator*() const noexcept;
+        T* operator->() const noexcept;
+        iterator& operator++() noexcept;
+        iterator operator++(int) noexcept;
+        bool operator==(const iterator& other) const noexcept;
+        bool operator!=(const iterator& other) const noexcept;
+    };
+
+    Hive() noexcept;
+    Hive(const Hive&) = delete;
+    Hive& operator=(const Hive&) = delete;
+    Hive(Hive&& other) noexcept;
+    Hive& operator=(Hive&& other) noexcept;
+    ~Hive() noexcept;
+
+    template <typename... Args>
+    iterator emplace(Args&&... args);
+    iterator insert(const T& value);
+    iterator insert(T&& value);
+    iterator erase(iterator position) noexcept;
+    void clear() noexcept;
+
+    iterator begin() const noexcept;
+    iterator end() const noexcept;
+    std::size_t size() const noexcept;
+    std::size_t capacity() const noexcept;
+    bool empty() const noexcept;
+    std::size_t block_count() const noexcept;
+};
+
+#include "hive-inl.h"
@@ -0,0 +1,192 @@
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include "hive.h"
+#include "test_helper.h"
+
+
+template <typename T>
+class HiveTest : public ::testing::Test 
+{};
+
+typedef ::testing::Types<int, std::string> MyTypes;
+
+TYPED_TEST_SUITE(HiveTest, MyTypes);
+
+
+template <typename T>
+std::vector<T> contents(const Hive<T>& hive)
+{
+    std::vector<T> values;
+    for (const T& value : hive)
+        values.push_back(value);
+    return values;
+}
+
+
+TYPED_TEST(HiveTest, InsertAndIterate)
+{
+    Hive<TypeParam> hive;
+    EXPECT_TRUE(hive.empty());
+    EXPECT_EQ(hive.begin(), hive.end());
+
+    for (int i = 0; i < 100; ++i)
+        hive.insert(TestHelper::getValue<TypeParam>());
+
+    EXPECT_EQ(hive.size(), 100u);
+    EXPECT_GE(hive.capacity(), 100u);
+    EXPECT_EQ(contents(hive), std::vector<TypeParam>(100, TestHelper::getValue<TypeParam>()));
+}
+
+
+TYPED_TEST(HiveTest, PointersStayValidAcrossInsertAndErase)
+{
+    Hive<TypeParam> hive;
+    std::vector<TypeParam*> pointers;
+    std::vector<typename Hive<TypeParam>::iterator> iterators;
+    for (int i = 0; i < 1000; ++i)
+    {
+        iterators.push_back(hive.insert(TestHelper::getValue<TypeParam>()));
+        pointers.push_back(&*iterators.back());
+    }
+    for (std::size_t i = 0; i < iterators.size(); i += 2)
+        hive.erase(iterators[i]);
+    for (int i = 0; i < 1000; ++i)
+        hive.insert(TypeParam());
+
+    for (std::size_t i = 1; i < pointers.size(); i += 2)
+        EXPECT_EQ(*pointers[i], TestHelper::getValue<TypeParam>());
+    EXPECT_EQ(hive.size(), 1500u);
+}
+
+
+TEST(HiveSkipfieldTest, EraseMergesNeighbouringRuns)
+{
+    Hive<int> hive;
+    std::vector<Hive<int>::iterator> items;
+    for (int i = 0; i < 8; ++i)
+        items.push_back(hive.insert(i));
+
+    hive.erase(items[2]);
+    hive.erase(items[4]);
+    EXPECT_EQ(contents(hive), (std::vector<int>{0, 1, 3, 5, 6, 7}));
+
+    hive.erase(items[3]);
+    EXPECT_EQ(contents(hive), (std::vector<int>{0, 1, 5, 6, 7}));
+
+    hive.erase(items[1]);
+    hive.erase(items[5]);
+    EXPECT_EQ(contents(hive), (std::vector<int>{0, 6, 7}));
+
+    hive.erase(items[0]);
+    hive.erase(items[7]);
+    EXPECT_EQ(contents(hive), (std::vector<int>{6}));
+    EXPECT_EQ(hive.size(), 1u);
+}
+
+
+TEST(HiveSkipfieldTest, ErasedSlotsAreReused)
+{
+    Hive<int> hive;
+    std::vector<Hive<int>::iterator> items;
+    for (int i = 0; i < 8; ++i)
+        items.push_back(hive.insert(i));
+    int* second = &*items[1];
+    int* third = &*items[2];
+
+    hive.erase(items[1]);
+    hive.erase(items[2]);
+    EXPECT_EQ(&*hive.insert(10), second);
+    EXPECT_EQ(&*hive.insert(11), third);
+    EXPECT_EQ(hive.capacity(), 8u);
+    EXPECT_EQ(contents(hive), (std::vector<int>{0, 10, 11, 3, 4, 5, 6, 7}));
+}
+
+
+TEST(HiveSkipfieldTest, EraseReturnsNextElement)
+{
+    Hive<int> hive;
+    for (int i = 0; i < 20; ++i)
+        hive.insert(i);
+
+    for (Hive<int>::iterator it = hive.begin(); it != hive.end(); )
+    {
+        if (*it % 3 != 0)
+            it = hive.erase(it);
+        else
+            ++it;
+    }
+    EXPECT_EQ(contents(hive), (std::vector<int>{0, 3, 6, 9, 12, 15, 18}));
+}
+
+
+TEST(HiveSkipfieldTest, EmptyBlocksAreReleased)
+{
+    Hive<int> hive;
+    std::vector<Hive<int>::iterator> items;
+    for (int i = 0; i < 24; ++i)
+        items.push_back(hive.insert(i));
+    EXPECT_EQ(hive.block_count(), 3u);
+
+    for (int i = 8; i < 16; ++i)
+        hive.erase(items[static_cast<std::size_t>(i)]);
+    EXPECT_EQ(hive.block_count(), 2u);
+    EXPECT_EQ(hive.capacity(), 24u);
+    EXPECT_EQ(hive.size(), 16u);
+}
+
+
+TEST(HiveSkipfieldTest, RandomOperationsMatchModel)
+{
+    std::mt19937 random(7);
+    Hive<int> hive;
+    std::map<int*, int> model;
+    int next = 0;
+
+    for (int step = 0; step < 20000; ++step)
+    {
+        if (model.empty() || random() % 3 != 0)
+        {
+            Hive<int>::iterator it = hive.insert(next);
+            ASSERT_TRUE(model.emplace(&*it, next).second);
+            ++next;
+        }
+        else
+        {
+            Hive<int>::iterator it = hive.begin();
+            std::advance(it, random() % hive.size());
+            model.erase(&*it);
+            hive.erase(it);
+        }
+
+        if (step % 500 == 0)
+        {
+            std::size_t seen = 0;
+            for (Hive<int>::iterator it = hive.begin(); it != hive.end(); ++it, ++seen)
+                ASSERT_EQ(model.at(&*it), *it);
+            ASSERT_EQ(seen, model.size());
+        }
+    }
+    EXPECT_EQ(hive.size(), model.size());
+}
+
+
+TEST(HiveLifetimeTest, DestroysRemainingElements)
+{
+    std::shared_ptr<int> counter = std::make_shared<int>(0);
+    {
+        Hive<std::shared_ptr<int>> hive;
+        std::vector<Hive<std::shared_ptr<int>>::iterator> items;
+        for (int i = 0; i < 50; ++i)
+            items.push_back(hive.insert(counter));
+        hive.erase(items[10]);
+        EXPECT_EQ(counter.use_count(), 50);
+
+        Hive<std::shared_ptr<int>> moved(std::move(hive));
+        EXPECT_TRUE(hive.empty());
+        EXPECT_EQ(moved.size(), 49u);
+    }
+    EXPECT_EQ(counter.use_count(), 1);
+}
@@ -0,0 +1,180 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <list>
+#include <random>
+#include <unordered_set>
+#include <vector>
+#include "../shared_ptr/shared.h"
+#include "intrusive.h"
+
+
+struct Order
+{
+    long id;
+    char payload[48];
+    ListHook<> queue_hook;
+    SetHook<> index_hook;
+};
+
+struct OrderHash
+{
+    std::size_t operator()(long id) const noexcept
+    {
+        return static_cast<std::size_t>(id) * 0x9e3779b97f4a7c15ull;
+    }
+
+    std::size_t operator()(const Order& order) const noexcept
+    {
+        return (*this)(order.id);
+    }
+
+    std::size_t operator()(const Order* order) const noexcept
+    {
+        return (*this)(order->id);
+    }
+};
+
+struct OrderEqual
+{
+    bool operator()(long id, const Order& order) const noexcept
+    {
+        return id == order.id;
+    }
+
+    bool operator()(const Order& left, const Order& right) const noexcept
+    {
+        return left.id == right.id;
+    }
+
+    bool operator()(const Order* left, const Order* right) const noexcept
+    {
+        return left->id == right->id;
+    }
+};
+
+
+double since(std::chrono::steady_clock::time_point start, std::size_t operations)
+{
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / operations;
+}
+
+
+// Enqueue everything, cancel every other order by identity, drain the rest.
+double intrusive_queue(std::vector<Order>& orders, int rounds)
+{
+    IntrusiveList<Order, &Order::queue_hook> queue;
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round)
+    {
+        for (Order& order : orders)
+            queue.push_back(order);
+        for (std::size_t i = 0; i < orders.size(); i += 2)
+            queue.remove(orders[i]);
+        while (!queue.empty())
+            queue.pop_front();
+    }
+    return since(start, orders.size() * 2 * rounds);
+}
+
+
+double shared_queue(std::vector<SharedPtr<Order>>& orders, int rounds)
+{
+    typedef std::list<SharedPtr<Order>> Queue;
+    Queue queue;
+    std::vector<Queue::iterator> positions(orders.size());
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round)
+    {
+        for (std::size_t i = 0; i < orders.size(); ++i)
+            positions[i] = queue.insert(queue.end(), orders[i]);
+        for (std::size_t i = 0; i < orders.size(); i += 2)
+            queue.erase(positions[i]);
+        while (!queue.empty())
+            queue.pop_front();
+    }
+    return since(start, orders.size() * 2 * rounds);
+}
+
+
+void intrusive_index(std::vector<Order>& orders, const std::vector<long>& probes, double* timings)
+{
+    IntrusiveHashSet<Order, &Order::index_hook, OrderHash, OrderEqual> index(orders.size());
+    auto start = std::chrono::steady_clock::now();
+    for (Order& order : orders)
+        index.insert(order);
+    timings[0] = since(start, orders.size());
+
+    long sink = 0;
+    start = std::chrono::steady_clock::now();
+    for (long id : probes)
+        sink += index.find(id)->payload[0];
+    timings[1] = since(start, probes.size());
+
+    start = std::chrono::steady_clock::now();
+    for (Order& order : orders)
+        index.erase(order);
+    timings[2] = since(start, orders.size());
+    if (sink == 42)
+        std::printf(" ");
+}
+
+
+void pointer_index(std::vector<Order>& orders, const std::vector<long>& probes, double* timings)
+{
+    std::unordered_set<Order*, OrderHash, OrderEqual> index;
+    index.reserve(orders.size());
+    auto start = std::chrono::steady_clock::now();
+    for (Order& order : orders)
+        index.insert(&order);
+    timings[0] = since(start, orders.size());
+
+    long sink = 0;
+    Order probe;
+    start = std::chrono::steady_clock::now();
+    for (long id : probes)
+    {
+        probe.id = id;
+        sink += (*index.find(&probe))->payload[0];
+    }
+    timings[1] = since(start, probes.size());
+
+    start = std::chrono::steady_clock::now();
+    for (Order& order : orders)
+        index.erase(&order);
+    timings[2] = since(start, orders.size());
+    if (sink == 42)
+        std::printf(" ");
+}
+
+
+int main(int argc, char** argv)
+{
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const int rounds = argc > 2 ? std::atoi(argv[2]) : 5;
+
+    std::vector<Order> orders(count);
+    std::vector<SharedPtr<Order>> shared;
+    std::vector<long> probes(count);
+    std::mt19937_64 random(42);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        orders[i].id = static_cast<long>(i);
+        orders[i].payload[0] = 1;
+        shared.emplace_back(new Order());
+        probes[i] = static_cast<long>(random() % count);
+    }
+
+    std::printf("%zu objects; ns per operation\n", count);
+    std::printf("%-28s %10s\n", "queue (push + cancel/pop)", "ns");
+    std::printf("%-28s %10.1f\n", "IntrusiveList", intrusive_queue(orders, rounds));
+    std::printf("%-28s %10.1f\n", "std::list<SharedPtr<T>>", shared_queue(shared, rounds));
+
+    double timings[3];
+    std::printf("%-28s %10s %10s %10s\n", "index", "insert", "find", "erase");
+    intrusive_index(orders, probes, timings);
+    std::printf("%-28s %10.1f %10.1f %10.1f\n", "IntrusiveHashSet", timings[0], timings[1], timings[2]);
+    pointer_index(orders, probes, timings);
+    std::printf("%-28s %10.1f %10.1f %10.1f\n", "std::unordered_set<T*>", timings[0], timings[1], timings[2]);
+    return 0;
+}
@@ -0,0 +1,474 @@
+template <typename T, auto Member>
+std::ptrdiff_t MemberHook<T, Member>::offset() noexcept
+{
+    // Folds to a constant; the storage is never read.
+    alignas(T) static char storage[sizeof(T)];
+    T* object = reinterpret_cast<T*>(storage);
+    return reinterpret_cast<char*>(&(object->*Member)) - reinterpret_cast<char*>(object);
+}
+
+template <typename T, auto Member>
+typename MemberHook<T, Member>::Hook* MemberHook<T, Member>::to_hook(T& object) noexcept
+{
+    return &(object.*Member);
+}
+
+template <typename T, auto Member>
+T* MemberHook<T, Member>::to_object(Hook* const hook) noexcept
+{
+    return reinterpret_cast<T*>(reinterpret_cast<char*>(hook) - offset());
+}
+
+template <HookMode Mode>
+ListHook<Mode>::ListHook() noexcept
+{
+    next = nullptr;
+    prev = nullptr;
+}
+
+template <HookMode Mode>
+ListHook<Mode>::ListHook(const ListHook&) noexcept
+{
+    next = nullptr;
+    prev = nullptr;
+}
+
+template <HookMode Mode>
+ListHook<Mode>& ListHook<Mode>::operator=(const ListHook&) noexcept
+{
+    return *this;
+}
+
+template <HookMode Mode>
+ListHook<Mode>::~ListHook() noexcept
+{
+    if (Mode == HookMode::auto_unlink)
+        unlink();
+}
+
+template <HookMode Mode>
+bool ListHook<Mode>::is_linked() const noexcept
+{
+    return next != nullptr;
+}
+
+template <HookMode Mode>
+void ListHook<Mode>::unlink() noexcept
+{
+    if (!next)
+        return;
+    prev->next = next;
+    next->prev = prev;
+    next = nullptr;
+    prev = nullptr;
+}
+
+template <HookMode Mode>
+void ListHook<Mode>::link_before(ListHook* const position) noexcept
+{
+    next = position;
+    prev = position->prev;
+    prev->next = this;
+    position->prev = this;
+}
+
+template <HookMode Mode>
+SetHook<Mode>::SetHook() noexcept
+{
+    next = nullptr;
+    link = nullptr;
+    hash = 0;
+}
+
+template <HookMode Mode>
+SetHook<Mode>::SetHook(const SetHook&) noexcept
+{
+    next = nullptr;
+    link = nullptr;
+    hash = 0;
+}
+
+template <HookMode Mode>
+SetHook<Mode>& SetHook<Mode>::operator=(const SetHook&) noexcept
+{
+    return *this;
+}
+
+template <HookMode Mode>
+SetHook<Mode>::~SetHook() noexcept
+{
+    if (Mode == HookMode::auto_unlink)
+        unlink();
+}
+
+template <HookMode Mode>
+bool SetHook<Mode>::is_linked() const noexcept
+{
+    return link != nullptr;
+}
+
+template <HookMode Mode>
+void SetHook<Mode>::unlink() noexcept
+{
+    if (!link)
+        return;
+    *link = next;
+    if (next)
+        next->link = link;
+    next = nullptr;
+    link = nullptr;
+}
+
+template <typename T, auto Member>
+IntrusiveList<T, Member>::Iterator::Iterator(Hook* const hook) noexcept
+{
+    this->hook = hook;
+}
+
+template <typename T, auto Member>
+T& IntrusiveList<T, Member>::Iterator::operator*() const noexcept
+{
+    return *Traits::to_object(hook);
+}
+
+template <typename T, auto Member>
+T* IntrusiveList<T, Member>::Iterator::operator->() const noexcept
+{
+    return Traits::to_object(hook);
+}
+
+template <typename T, auto Member>
+typename IntrusiveList<T, Member>::Iterator& IntrusiveList<T, Member>::Iterator::operator++() noexcept
+{
+    hook = hook->next;
+    return *this;
+}
+
+template <typename T, auto Member>
+typename IntrusiveList<T, Member>::Iterator& IntrusiveList<T, Member>::Iterator::operator--() noexcept
+{
+    hook = hook->prev;
+    return *this;
+}
+
+template <typename T, auto Member>
+bool IntrusiveList<T, Member>::Iterator::operator==(const Iterator& other) const noexcept
+{
+    return hook == other.hook;
+}
+
+template <typename T, auto Member>
+bool IntrusiveList<T, Member>::Iterator::operator!=(const Iterator& other) const noexcept
+{
+    return hook != other.hook;
+}
+
+template <typename T, auto Member>
+IntrusiveList<T, Member>::IntrusiveList() noexcept
+{
+    root.next = &root;
+    root.prev = &root;
+}
+
+template <typename T, auto Member>
+IntrusiveList<T, Member>::~IntrusiveList() noexcept
+{
+    clear();
+}
+
+template <typename T, auto Member>
+void IntrusiveList<T, Member>::push_front(T& object) noexcept
+{
+    Traits::to_hook(object)->link_before(root.next);
+}
+
+template <typename T, auto Member>
+void IntrusiveList<T, Member>::push_back(T& object) noexcept
+{
+    Traits::to_hook(object)->link_before(&root);
+}
+
+template <typename T, auto Member>
+void IntrusiveList<T, Member>::pop_front() noexcept
+{
+    root.next->unlink();
+}
+
+template <typename T, auto Member>
+void IntrusiveList<T, Member>::pop_back() noexcept
+{
+    root.prev->unlink();
+}
+
+template <typename T, auto Member>
+T& IntrusiveList<T, Member>::front() const noexcept
+{
+    return *Traits::to_object(root.next);
+}
+
+template <typename T, auto Member>
+T& IntrusiveList<T, Member>::back() const noexcept
+{
+    return *Traits::to_object(root.prev);
+}
+
+template <typename T, auto Member>
+typename IntrusiveList<T, Member>::Iterator IntrusiveList<T, Member>::insert(const Iterator position, T& object) noexcept
+{
+    Hook* hook = Traits::to_hook(object);
+    hook->link_before(position.hook);
+    return Iterator(hook);
+}
+
+template <typename T, auto Member>
+typename IntrusiveList<T, Member>::Iterator IntrusiveList<T, Member>::erase(const Iterator position) noexcept
+{
+    Hook* next = position.hook->next;
+    position.hook->unlink();
+    return Iterator(next);
+}
+
+template <typename T, auto Member>
+void IntrusiveList<T, Member>::remove(T& object) noexcept
+{
+    Traits::to_hook(object)->unlink();
+}
+
+template <typename T, auto Member>
+typename IntrusiveList<T, Member>::Iterator IntrusiveList<T, Member>::iterator_to(T& object) noexcept
+{
+    return Iterator(Traits::to_hook(object));
+}
+
+template <typename T, auto Member>
+void IntrusiveList<T, Member>::clear() noexcept
+{
+    while (root.next != &root)
+        root.next->unlink();
+}
+
+template <typename T, auto Member>
+typename IntrusiveList<T, Member>::Iterator IntrusiveList<T, Member>::begin() const noexcept
+{
+    return Iterator(root.next);
+}
+
+template <typename T, auto Member>
+typename IntrusiveList<T, Member>::Iterator IntrusiveList<T, Member>::end() const noexcept
+{
+    return Iterator(&root);
+}
+
+template <typename T, auto Member>
+bool IntrusiveList<T, Member>::empty() const noexcept
+{
+    return root.next == &root;
+}
+
+template <typename T, auto Member>
+std::size_t IntrusiveList<T, Member>::size() const noexcept
+{
+    std::size_t count = 0;
+    for (const Hook* hook = root.next; hook != &root; hook = hook->next)
+        ++count;
+    return count;
+}
+
+template <typename T, auto Member, typename Hash, typename Equal>
+IntrusiveHashSet<T, Member, Hash, Equal>::Iterator::Iterator(const IntrusiveHashSet* const set, const std::size_t bucket,
+                                                            Hook* const hook) noexcept
+{
+    this->set = set;
+    this->bucket = bucket;
+    this->hook = hook;
+    settle();
+}
+
+template <typename T, auto Member, typename Hash, typename Equal>
+void IntrusiveHashSet<T, Member, Hash, Equal>::Iterator::settle() noexcept
+{
+    while (!hook && bucket < set->buckets.size())
+    {
+        if (++bucket < set->buckets.size())
+            hook = set->buckets[bucket];
+    }
+}
+
+template <typename T, auto Member, typename Hash, typename Equal>
+T& IntrusiveHashSet<T, Member, Hash, Equal>::Iterator::operator*() const noexcept
+{
+    return *Traits::to_object(hook);
+}
+
+template <typename T, auto Member, typename Hash, typename Equal>
+T* IntrusiveHashSet<T, Member, Hash, Equal>::Iterator::operator->() const noexcept
+{
+    return Traits::to_object(hook);
+}
+
+template <typename T, auto Member, typename Hash, typename Equal>
+typename IntrusiveHashSet<T, Member, Hash, Equal>::Iterator& IntrusiveHashSet<T, Member, Hash, Equal>::Iterator::operator++() noexcept
+{
+    hook = hook->next;
+    settle();
+    return *this;
+}
+
+template <typename T, auto Member, typename Hash, typename Equal>
+bool IntrusiveHashSet<T, Member, Hash, Equal>::Iterator::operator==(const Iterator& other) const noexcept
+{
+    return hook == other.hook;
+}
+
+template <typename T, auto Member, typename Hash, typename Equal>
+bool IntrusiveHashSet<T, Member, Hash, Equal>::Iterator::operator!=(const Iterator& other) const noexcept
+{
+    return hook != other.hook;
+}
+
+template <typename T, auto Member, typename Hash, typename Equal>
+IntrusiveHashSet<T, Member, Hash, Equal>::IntrusiveHashSet(const std::size_t bucket_count, const Hash& hash, const Equal& equal)
+    : hasher(hash), equal(equal)
+{
+    mask = 0;
+    rehash(bucket_count);
+}
+
+template <typename T, auto Member, typename Hash, typename Equal>
+IntrusiveHashSet<T, Member, Hash, Equal>::~IntrusiveHashSet() noexcept
+{
+    clear();
+}
+
+template <typename T, auto Member, typename Hash, typename Equal>
+void IntrusiveHashSet<T, Member, Hash, Equal>::link(Hook* const hook, const std::size_t hash) noexcept
+{
+    Hook*& head = buckets[hash & mask];
+    hook->hash = hash;
+    hook->next = head;
+    hook->link = &head;
+    if (head)
+        head->link = &hook->next;
+    head = hook;
+}
+
+template <typename T, auto Member, typename Hash, typename Equal>
+bool IntrusiveHashSet<T, Member, Hash, Equal>::insert(T& object)
+{
+    const std::size_t hash = hasher(object);
+    for (Hook* hook = buckets[hash & mask]; hook; hook = hook->next)
+    {
+        if (hook->hash == hash && equal(object, *Traits::to_object(hook)))
+            return false;
+    }
+    link(Traits::to_hook(object), hash);
+    return true;
+}
+
+template <typename T, auto Member, typename Hash, typename Equal>
+template <typename Key>
+T* IntrusiveHashSet<T, Member, Hash, Equal>::find(const Key& key) const
+{
+    const std::size_t hash = hasher(key);
+    for (Hook* hook = buckets[hash & mask]; hook; hook = hook->next)
+    {
+        if (hook->hash == hash && equal(key, *Traits::to_object(hook)))
+            return Traits::to_object(hook);
+    }
+    return nullptr;
+}
+
+template <typename T, auto Member, typename Hash, typename Equal>
+template <typename Key>
+bool IntrusiveHashSet<T, Member, Hash, Equal>::contains(const Key& key) const
+{
+    return find(key) != nullptr;
+}
+
+template <typename T, auto Member, typename Hash, typename Equal>
+void IntrusiveHashSet<T, Member, Hash, Equal>::erase(T& object) noexcept
+{
+    Traits::to_hook(object)->unlink();
+}
+
+template <typename T, auto Member, typename Hash, typename Equal>
+template <typename Key>
+T* IntrusiveHashSet<T, Member, Hash, Equal>::erase_key(const Key& key)
+{
+    T* object = find(key);
+    if (object)
+        erase(*object);
+    return object;
+}
+
+template <typename T, auto Member, typename Hash, typename Equal>
+void IntrusiveHashSet<T, Member, Hash, Equal>::clear() noexcept
+{
+    for (Hook*& head : buckets)
+    {
+        while (head)
+            head->unlink();
+    }
+}
+
+template <typename T, auto Member, typename Hash, typename Equal>
+void IntrusiveHashSet<T, Member, Hash, Equal>::rehash(const std::size_t bucket_count)
+{
+    std::size_t count = 1;
+    while (count < bucket_count)
+        count <<= 1;
+
+    std::vector<Hook*> old(count, nullptr);
+    old.swap(buckets);
+    mask = count - 1;
+    for (Hook* head : old)
+    {
+        while (head)
+        {
+            Hook* next = head->next;
+            link(head, head->hash);
+            head = next;
+        }
+    }
+}
+
+template <typename T, auto Member, typename Hash, typename Equal>
+typename IntrusiveHashSet<T, Member, Hash, Equal>::Iterator IntrusiveHashSet<T, Member, Hash, Equal>::begin() const noexcept
+{
+    return Iterator(this, 0, buckets[0]);
+}
+
+template <typename T, auto Member, typename Hash, typename Equal>
+typename IntrusiveHashSet<T, Member, Hash, Equal>::Iterator IntrusiveHashSet<T, Member, Hash, Equal>::end() const noexcept
+{
+    return Iterator(this, buckets.size(), nullptr);
+}
+
+template <typename T, auto Member, typename Hash, typename Equal>
+bool IntrusiveHashSet<T, Member, Hash, Equal>::empty() const noexcept
+{
+    for (const Hook* head : buckets)
+    {
+        if (head)
+            return false;
+    }
+    return true;
+}
+
+template <typename T, auto Member, typename Hash, typename Equal>
+std::size_t IntrusiveHashSet<T, Member, Hash, Equal>::size() const noexcept
+{
+    std::size_t count = 0;
+    for (const Hook* head : buckets)
+    {
+        for (; head; head = head->next)
+            ++count;
+    }
+    return count;
+}
+
+template <typename T, auto Member, typename Hash, typename Equal>
+std::size_t IntrusiveHashSet<T, Member, Hash, Equal>::bucket_count() const noexcept
+{
+    return buckets.size();
+}
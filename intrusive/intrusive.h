@@ -0,0 +1,212 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// normal hooks must be unlinked before their owner dies; auto_unlink hooks
+// take themselves out of their container in the destructor. Containers do
+// not keep a count either way (an auto-unlinked hook could not update it),
+// so size() walks.
+enum class HookMode
+{
+    normal,
+    auto_unlink
+};
+
+// Maps between an object and one of its hook members.
+template <typename T, auto Member>
+class MemberHook
+{
+public:
+    typedef typename std::remove_reference<decltype(std::declval<T&>().*Member)>::type Hook;
+
+    static Hook* to_hook(T& object) noexcept;
+    static T* to_object(Hook* hook) noexcept;
+
+private:
+    static std::ptrdiff_t offset() noexcept;
+};
+
+template <HookMode Mode = HookMode::normal>
+class ListHook
+{
+public:
+    ListHook() noexcept;
+    // A copied object starts out in no container.
+    ListHook(const ListHook&) noexcept;
+    ListHook& operator=(const ListHook&) noexcept;
+    ~ListHook() noexcept;
+
+    bool is_linked() const noexcept;
+    void unlink() noexcept;
+
+private:
+    ListHook* next;
+    ListHook* prev;
+
+    void link_before(ListHook* position) noexcept;
+
+    template <typename T, auto Member>
+    friend class IntrusiveList;
+};
+
+template <HookMode Mode = HookMode::normal>
+class SetHook
+{
+public:
+    SetHook() noexcept;
+    SetHook(const SetHook&) noexcept;
+    SetHook& operator=(const SetHook&) noexcept;
+    ~SetHook() noexcept;
+
+    bool is_linked() const noexcept;
+    void unlink() noexcept;
+
+private:
+    SetHook* next;
+    // The pointer that points at this hook: a bucket head or the previous
+    // hook's next, so unlinking needs neither the set nor the hash.
+    SetHook** link;
+    std::size_t hash;
+
+    template <typename T, auto Member, typename Hash, typename Equal>
+    friend class IntrusiveHashSet;
+};
+
+// Doubly-linked list threaded through a ListHook member of T, e.g.
+// IntrusiveList<Task, &Task::queue_hook>. The list never owns or allocates;
+// an object can sit in as many lists as it has hooks.
+template <typename T, auto Member>
+class IntrusiveList
+{
+private:
+    typedef MemberHook<T, Member> Traits;
+    typedef typename Traits::Hook Hook;
+
+public:
+    class Iterator
+    {
+    private:
+        Hook* hook;
+
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef T* pointer;
+        typedef T& reference;
+
+        explicit Iterator(Hook* hook) noexcept;
+
+        T& operator*() const noexcept;
+        T* operator->() const noexcept;
+        Iterator& operator++() noexcept;
+        Iterator& operator--() noexcept;
+        bool operator==(const Iterator& other) const noexcept;
+        bool operator!=(const Iterator& other) const noexcept;
+
+        friend class IntrusiveList;
+    };
+
+    IntrusiveList() noexcept;
+    IntrusiveList(const IntrusiveList&) = delete;
+    IntrusiveList& operator=(const IntrusiveList&) = delete;
+    ~IntrusiveList() noexcept;
+
+    void push_front(T& object) noexcept;
+    void push_back(T& object) noexcept;
+    void pop_front() noexcept;
+    void pop_back() noexcept;
+    T& front() const noexcept;
+    T& back() const noexcept;
+    // Links object before position.
+    Iterator insert(Iterator position, T& object) noexcept;
+    Iterator erase(Iterator position) noexcept;
+    static void remove(T& object) noexcept;
+    static Iterator iterator_to(T& object) noexcept;
+    void clear() noexcept;
+
+    Iterator begin() const noexcept;
+    Iterator end() const noexcept;
+    bool empty() const noexcept;
+    std::size_t size() const noexcept;
+
+private:
+    mutable Hook root;
+};
+
+// Chained hash set threaded through a SetHook member of T. Buckets are only
+// allocated by the constructor and rehash(); insert and erase never
+// allocate, so the caller sizes the table. Lookups take any key that Hash
+// and Equal accept alongside T.
+template <typename T, auto Member, typename Hash = std::hash<T>, typename Equal = std::equal_to<>>
+class IntrusiveHashSet
+{
+private:
+    typedef MemberHook<T, Member> Traits;
+    typedef typename Traits::Hook Hook;
+
+public:
+    class Iterator
+    {
+    private:
+        const IntrusiveHashSet* set;
+        std::size_t bucket;
+        Hook* hook;
+
+        void settle() noexcept;
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef T* pointer;
+        typedef T& reference;
+
+        Iterator(const IntrusiveHashSet* set, std::size_t bucket, Hook* hook) noexcept;
+
+        T& operator*() const noexcept;
+        T* operator->() const noexcept;
+        Iterator& operator++() noexcept;
+        bool operator==(const Iterator& other) const noexcept;
+        bool operator!=(const Iterator& other) const noexcept;
+    };
+
+    explicit IntrusiveHashSet(std::size_t bucket_count = 64, const Hash& hash = Hash(), const Equal& equal = Equal());
+    IntrusiveHashSet(const IntrusiveHashSet&) = delete;
+    IntrusiveHashSet& operator=(const IntrusiveHashSet&) = delete;
+    ~IntrusiveHashSet() noexcept;
+
+    // False, leaving object unlinked, if an equal object is already present.
+    bool insert(T& object);
+    template <typename Key>
+    T* find(const Key& key) const;
+    template <typename Key>
+    bool contains(const Key& key) const;
+    static void erase(T& object) noexcept;
+    template <typename Key>
+    T* erase_key(const Key& key);
+    void clear() noexcept;
+    // Rounds up to a power of two and relinks every element.
+    void rehash(std::size_t bucket_count);
+
+    Iterator begin() const noexcept;
+    Iterator end() const noexcept;
+    bool empty() const noexcept;
+    std::size_t size() const noexcept;
+    std::size_t bucket_count() const noexcept;
+
+private:
+    std::vector<Hook*> buckets;
+    std::size_t mask;
+    Hash hasher;
+    Equal equal;
+
+    void link(Hook* hook, std::size_t hash) noexcept;
+};
+
+#include "intrusive-inl.h"
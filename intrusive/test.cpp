@@ -0,0 +1,214 @@
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "intrusive.h"
+
+
+struct Job
+{
+    int id;
+    ListHook<> queue_hook;
+    ListHook<> owner_hook;
+    SetHook<> index_hook;
+
+    explicit Job(int id) : id(id) {}
+};
+
+struct JobHash
+{
+    std::size_t operator()(const Job& job) const noexcept
+    {
+        return static_cast<std::size_t>(job.id) * 0x9e3779b97f4a7c15ull;
+    }
+
+    std::size_t operator()(int id) const noexcept
+    {
+        return static_cast<std::size_t>(id) * 0x9e3779b97f4a7c15ull;
+    }
+};
+
+struct JobEqual
+{
+    bool operator()(const Job& left, const Job& right) const noexcept
+    {
+        return left.id == right.id;
+    }
+
+    bool operator()(int id, const Job& job) const noexcept
+    {
+        return id == job.id;
+    }
+};
+
+struct Session
+{
+    std::string name;
+    ListHook<HookMode::auto_unlink> lru_hook;
+    SetHook<HookMode::auto_unlink> index_hook;
+};
+
+struct SessionHash
+{
+    std::size_t operator()(const Session& session) const noexcept
+    {
+        return std::hash<std::string>()(session.name);
+    }
+
+    std::size_t operator()(const std::string& name) const noexcept
+    {
+        return std::hash<std::string>()(name);
+    }
+};
+
+struct SessionEqual
+{
+    bool operator()(const Session& left, const Session& right) const noexcept
+    {
+        return left.name == right.name;
+    }
+
+    bool operator()(const std::string& name, const Session& session) const noexcept
+    {
+        return name == session.name;
+    }
+};
+
+typedef IntrusiveList<Job, &Job::queue_hook> JobQueue;
+typedef IntrusiveList<Job, &Job::owner_hook> OwnerList;
+typedef IntrusiveHashSet<Job, &Job::index_hook, JobHash, JobEqual> JobIndex;
+
+
+std::vector<int> ids(const JobQueue& queue)
+{
+    std::vector<int> result;
+    for (const Job& job : queue)
+        result.push_back(job.id);
+    return result;
+}
+
+
+TEST(IntrusiveListTest, PushPopAndIterate)
+{
+    Job a(1), b(2), c(3);
+    JobQueue queue;
+    EXPECT_TRUE(queue.empty());
+    queue.push_back(b);
+    queue.push_front(a);
+    queue.push_back(c);
+    EXPECT_EQ(ids(queue), (std::vector<int>{1, 2, 3}));
+    EXPECT_EQ(queue.size(), 3u);
+    EXPECT_EQ(queue.front().id, 1);
+    EXPECT_EQ(queue.back().id, 3);
+
+    queue.pop_front();
+    EXPECT_FALSE(a.queue_hook.is_linked());
+    queue.pop_back();
+    EXPECT_EQ(ids(queue), (std::vector<int>{2}));
+    queue.clear();
+    EXPECT_TRUE(queue.empty());
+    EXPECT_FALSE(b.queue_hook.is_linked());
+}
+
+
+TEST(IntrusiveListTest, InsertEraseAndRemoveByObject)
+{
+    Job a(1), b(2), c(3), d(4);
+    JobQueue queue;
+    queue.push_back(a);
+    queue.push_back(c);
+    queue.insert(JobQueue::iterator_to(c), b);
+    queue.insert(queue.end(), d);
+    EXPECT_EQ(ids(queue), (std::vector<int>{1, 2, 3, 4}));
+
+    auto next = queue.erase(JobQueue::iterator_to(b));
+    EXPECT_EQ(next->id, 3);
+    JobQueue::remove(d);
+    EXPECT_EQ(ids(queue), (std::vector<int>{1, 3}));
+    --next;
+    EXPECT_EQ(next->id, 1);
+}
+
+
+TEST(IntrusiveListTest, ObjectSitsInSeveralListsWithoutAllocating)
+{
+    std::vector<Job> jobs;
+    for (int i = 0; i < 6; ++i)
+        jobs.emplace_back(i);
+    JobQueue queue;
+    OwnerList even;
+    for (Job& job : jobs)
+    {
+        queue.push_back(job);
+        if (job.id % 2 == 0)
+            even.push_front(job);
+    }
+    JobQueue::remove(jobs[2]);
+    EXPECT_EQ(ids(queue), (std::vector<int>{0, 1, 3, 4, 5}));
+    std::vector<int> owned;
+    for (const Job& job : even)
+        owned.push_back(job.id);
+    EXPECT_EQ(owned, (std::vector<int>{4, 2, 0}));
+    queue.clear();
+    even.clear();
+}
+
+
+TEST(IntrusiveHashSetTest, InsertFindErase)
+{
+    std::vector<Job> jobs;
+    for (int i = 0; i < 100; ++i)
+        jobs.emplace_back(i);
+    JobIndex index(16);
+    for (Job& job : jobs)
+        EXPECT_TRUE(index.insert(job));
+    Job duplicate(42);
+    EXPECT_FALSE(index.insert(duplicate));
+    EXPECT_FALSE(duplicate.index_hook.is_linked());
+    EXPECT_EQ(index.size(), 100u);
+
+    EXPECT_EQ(index.find(42), &jobs[42]);
+    EXPECT_EQ(index.find(100), nullptr);
+    JobIndex::erase(jobs[42]);
+    EXPECT_FALSE(index.contains(42));
+    EXPECT_EQ(index.erase_key(7), &jobs[7]);
+    EXPECT_EQ(index.erase_key(7), nullptr);
+    EXPECT_EQ(index.size(), 98u);
+
+    index.rehash(256);
+    EXPECT_EQ(index.bucket_count(), 256u);
+    int sum = 0;
+    for (const Job& job : index)
+        sum += job.id;
+    EXPECT_EQ(sum, 4950 - 42 - 7);
+    for (int i = 0; i < 100; ++i)
+        EXPECT_EQ(index.contains(i), i != 42 && i != 7);
+    index.clear();
+    EXPECT_TRUE(index.empty());
+    EXPECT_FALSE(jobs[0].index_hook.is_linked());
+}
+
+
+TEST(IntrusiveHashSetTest, AutoUnlinkHooksLeaveOnDestruction)
+{
+    IntrusiveList<Session, &Session::lru_hook> lru;
+    IntrusiveHashSet<Session, &Session::index_hook, SessionHash, SessionEqual> index;
+    Session kept{"kept", {}, {}};
+    lru.push_back(kept);
+    index.insert(kept);
+    {
+        Session temporary{"temporary", {}, {}};
+        lru.push_back(temporary);
+        index.insert(temporary);
+        EXPECT_EQ(lru.size(), 2u);
+        EXPECT_EQ(index.size(), 2u);
+    }
+    EXPECT_EQ(lru.size(), 1u);
+    EXPECT_EQ(&lru.front(), &kept);
+    EXPECT_EQ(index.size(), 1u);
+    EXPECT_EQ(index.find(std::string("temporary")), nullptr);
+    EXPECT_EQ(index.find(std::string("kept")), &kept);
+
+    Session copy = kept;
+    EXPECT_FALSE(copy.lru_hook.is_linked());
+    EXPECT_FALSE(copy.index_hook.is_linked());
+}
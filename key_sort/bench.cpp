@@ -0,0 +1,78 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include "key_sort.h"
+
+
+struct Record
+{
+    std::uint64_t id;
+    double score;
+    char payload[48];
+};
+
+
+std::vector<UniquePtr<Record>> make_records(std::size_t count)
+{
+    std::mt19937_64 random(42);
+    std::vector<UniquePtr<Record>> records(count);
+    // Allocate in shuffled order so neighbours in the vector are far apart in memory.
+    std::vector<std::size_t> slots(count);
+    for (std::size_t i = 0; i < count; ++i)
+        slots[i] = i;
+    std::shuffle(slots.begin(), slots.end(), random);
+    for (std::size_t slot : slots)
+    {
+        Record* record = new Record();
+        record->id = random();
+        record->score = 0.0;
+        records[slot] = UniquePtr<Record>(record);
+    }
+    return records;
+}
+
+
+template <typename Func>
+double time_sort(std::size_t count, Func func)
+{
+    std::vector<UniquePtr<Record>> records = make_records(count);
+    auto start = std::chrono::steady_clock::now();
+    func(records);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    for (std::size_t i = 1; i < records.size(); ++i)
+    {
+        if (records[i]->id < records[i - 1]->id)
+        {
+            std::printf("not sorted\n");
+            break;
+        }
+    }
+    return seconds;
+}
+
+
+int main(int argc, char** argv)
+{
+    std::vector<std::size_t> sizes;
+    for (int i = 1; i < argc; ++i)
+        sizes.push_back(std::strtoull(argv[i], nullptr, 10));
+    if (sizes.empty())
+        sizes = {1000000, 10000000};
+
+    std::printf("%12s %14s %14s\n", "elements", "std::sort s", "sort_by_key s");
+    for (std::size_t count : sizes)
+    {
+        double baseline = time_sort(count, [](std::vector<UniquePtr<Record>>& records) {
+            std::sort(records.begin(), records.end(), [](const UniquePtr<Record>& a, const UniquePtr<Record>& b) {
+                return a->id < b->id;
+            });
+        });
+        double keyed = time_sort(count, [](std::vector<UniquePtr<Record>>& records) {
+            sort_by_key(records, [](const Record& record) { return record.id; });
+        });
+        std::printf("%12zu %14.3f %14.3f\n", count, baseline, keyed);
+    }
+    return 0;
+}
@@ -0,0 +1,217 @@
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+template <typename Func>
+void key_sort_parallel(unsigned threads, Func func)
+{
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threads; ++t)
+        workers.emplace_back(func, t);
+    func(0u);
+    for (std::thread& worker : workers)
+        worker.join();
+}
+
+inline unsigned KeySort::thread_count(const std::size_t size, unsigned threads) noexcept
+{
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t useful = std::max<std::size_t>(1, size >> 16);
+    return static_cast<unsigned>(std::min<std::size_t>(threads, useful));
+}
+
+template <typename K>
+typename std::make_unsigned<K>::type KeySort::radix_bits(const K key, std::true_type) noexcept
+{
+    typedef typename std::make_unsigned<K>::type Bits;
+    Bits bits = static_cast<Bits>(key);
+    if (std::is_signed<K>::value)
+        bits ^= static_cast<Bits>(Bits(1) << (sizeof(Bits) * 8 - 1));
+    return bits;
+}
+
+inline std::uint32_t KeySort::radix_bits(const float key, std::false_type) noexcept
+{
+    std::uint32_t bits;
+    std::memcpy(&bits, &key, sizeof(bits));
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+inline std::uint64_t KeySort::radix_bits(const double key, std::false_type) noexcept
+{
+    std::uint64_t bits;
+    std::memcpy(&bits, &key, sizeof(bits));
+    return (bits & 0x8000000000000000ull) ? ~bits : (bits | 0x8000000000000000ull);
+}
+
+template <typename K>
+void KeySort::radix_sort(std::vector<KeyIndex<K>>& keys, unsigned threads)
+{
+    typedef std::integral_constant<bool, std::is_integral<K>::value> Integral;
+    typedef decltype(radix_bits(K(), Integral())) Bits;
+
+    const std::size_t size = keys.size();
+    threads = thread_count(size, threads);
+
+    std::vector<KeyIndex<K>> buffer(size);
+    std::vector<std::size_t> counts(threads * 256);
+    KeyIndex<K>* from = keys.data();
+    KeyIndex<K>* to = buffer.data();
+
+    for (unsigned shift = 0; shift < sizeof(Bits) * 8; shift += 8)
+    {
+        std::fill(counts.begin(), counts.end(), 0);
+        key_sort_parallel(threads, [&](unsigned t) {
+            std::size_t* local = &counts[t * 256];
+            const std::size_t end = size * (t + 1) / threads;
+            for (std::size_t i = size * t / threads; i < end; ++i)
+                ++local[(radix_bits(from[i].key, Integral()) >> shift) & 0xff];
+        });
+
+        std::size_t offset = 0;
+        bool skip = false;
+        for (unsigned digit = 0; digit < 256 && !skip; ++digit)
+        {
+            std::size_t total = 0;
+            for (unsigned t = 0; t < threads; ++t)
+            {
+                std::size_t count = counts[t * 256 + digit];
+                counts[t * 256 + digit] = offset + total;
+                total += count;
+            }
+            skip = total == size;
+            offset += total;
+        }
+        if (skip)
+            continue;
+
+        key_sort_parallel(threads, [&](unsigned t) {
+            std::size_t* local = &counts[t * 256];
+            const std::size_t end = size * (t + 1) / threads;
+            for (std::size_t i = size * t / threads; i < end; ++i)
+                to[local[(radix_bits(from[i].key, Integral()) >> shift) & 0xff]++] = from[i];
+        });
+        std::swap(from, to);
+    }
+
+    if (from != keys.data())
+        keys.swap(buffer);
+}
+
+template <typename K>
+void KeySort::merge_sort(std::vector<KeyIndex<K>>& keys, unsigned threads)
+{
+    const std::size_t size = keys.size();
+    threads = thread_count(size, threads);
+    auto less = [](const KeyIndex<K>& a, const KeyIndex<K>& b) {
+        return a.key < b.key || (!(b.key < a.key) && a.index < b.index);
+    };
+
+    std::vector<std::size_t> bounds;
+    for (unsigned t = 0; t <= threads; ++t)
+        bounds.push_back(size * t / threads);
+    key_sort_parallel(threads, [&](unsigned t) {
+        std::sort(keys.begin() + static_cast<std::ptrdiff_t>(bounds[t]), keys.begin() + static_cast<std::ptrdiff_t>(bounds[t + 1]), less);
+    });
+    if (threads == 1)
+        return;
+
+    std::vector<KeyIndex<K>> buffer(size);
+    KeyIndex<K>* from = keys.data();
+    KeyIndex<K>* to = buffer.data();
+    while (bounds.size() > 2)
+    {
+        const unsigned runs = static_cast<unsigned>(bounds.size() - 1);
+        key_sort_parallel((runs + 1) / 2, [&](unsigned pair) {
+            const std::size_t first = bounds[pair * 2];
+            const std::size_t middle = bounds[std::min<std::size_t>(pair * 2 + 1, runs)];
+            const std::size_t last = bounds[std::min<std::size_t>(pair * 2 + 2, runs)];
+            std::merge(std::make_move_iterator(from + first), std::make_move_iterator(from + middle),
+                       std::make_move_iterator(from + middle), std::make_move_iterator(from + last),
+                       to + first, less);
+        });
+
+        std::vector<std::size_t> merged;
+        for (std::size_t i = 0; i < bounds.size(); i += 2)
+            merged.push_back(bounds[i]);
+        if (merged.back() != size)
+            merged.push_back(size);
+        bounds.swap(merged);
+        std::swap(from, to);
+    }
+
+    if (from != keys.data())
+        keys.swap(buffer);
+}
+
+template <typename K>
+void KeySort::sort_keys(std::vector<KeyIndex<K>>& keys, const unsigned threads)
+{
+    if (keys.size() < 2)
+        return;
+    if constexpr (std::is_arithmetic<K>::value && !std::is_same<K, bool>::value && sizeof(K) <= 8)
+        radix_sort(keys, threads);
+    else
+        merge_sort(keys, threads);
+}
+
+template <typename Owner>
+void KeySort::permute(std::vector<Owner>& items, std::vector<std::uint32_t>& order) noexcept
+{
+    const std::uint32_t size = static_cast<std::uint32_t>(items.size());
+    for (std::uint32_t i = 0; i < size; ++i)
+    {
+        if (order[i] == i)
+            continue;
+
+        Owner held = std::move(items[i]);
+        std::uint32_t j = i;
+        while (order[j] != i)
+        {
+            std::uint32_t next = order[j];
+            items[j] = std::move(items[next]);
+            order[j] = j;
+            j = next;
+        }
+        items[j] = std::move(held);
+        order[j] = j;
+    }
+}
+
+template <typename T, typename Deleter, typename KeyFunc>
+void KeySort::sort(std::vector<UniquePtr<T, Deleter>>& items, KeyFunc key, unsigned threads)
+{
+    typedef typename std::decay<decltype(key(*items.front()))>::type K;
+
+    const std::size_t size = items.size();
+    if (size < 2)
+        return;
+    if (size > UINT32_MAX)
+        throw std::length_error("KeySort indexes are 32-bit");
+
+    const unsigned workers = thread_count(size, threads);
+    std::vector<KeyIndex<K>> keys(size);
+    key_sort_parallel(workers, [&](unsigned t) {
+        const std::size_t end = size * (t + 1) / workers;
+        for (std::size_t i = size * t / workers; i < end; ++i)
+            keys[i] = KeyIndex<K>{key(*items[i]), static_cast<std::uint32_t>(i)};
+    });
+
+    sort_keys(keys, threads);
+
+    std::vector<std::uint32_t> order(size);
+    for (std::size_t i = 0; i < size; ++i)
+        order[i] = keys[i].index;
+    std::vector<KeyIndex<K>>().swap(keys);
+
+    permute(items, order);
+}
+
+template <typename T, typename Deleter, typename KeyFunc>
+void sort_by_key(std::vector<UniquePtr<T, Deleter>>& items, KeyFunc key, const unsigned threads)
+{
+    KeySort::sort(items, key, threads);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#include "../unique_ptr/unique.h"
+
+template <typename K>
+struct KeyIndex
+{
+    K key;
+    std::uint32_t index;
+};
+
+// Sorts owners by a key without touching the pointees during comparisons:
+// every key is read once into a contiguous (key, index) array, that array is
+// sorted (LSD radix for arithmetic keys, merge sort otherwise, both split
+// across threads), and the owners are then moved along the permutation
+// cycles. The sort is stable.
+class KeySort
+{
+public:
+    template <typename T, typename Deleter, typename KeyFunc>
+    static void sort(std::vector<UniquePtr<T, Deleter>>& items, KeyFunc key, unsigned threads = 0);
+
+    template <typename K>
+    static void sort_keys(std::vector<KeyIndex<K>>& keys, unsigned threads);
+
+    template <typename Owner>
+    static void permute(std::vector<Owner>& items, std::vector<std::uint32_t>& order) noexcept;
+
+private:
+    template <typename K>
+    static typename std::make_unsigned<K>::type radix_bits(K key, std::true_type) noexcept;
+    static std::uint32_t radix_bits(float key, std::false_type) noexcept;
+    static std::uint64_t radix_bits(double key, std::false_type) noexcept;
+
+    template <typename K>
+    static void radix_sort(std::vector<KeyIndex<K>>& keys, unsigned threads);
+    template <typename K>
+    static void merge_sort(std::vector<KeyIndex<K>>& keys, unsigned threads);
+
+    static unsigned thread_count(std::size_t size, unsigned threads) noexcept;
+};
+
+template <typename T, typename Deleter, typename KeyFunc>
+void sort_by_key(std::vector<UniquePtr<T, Deleter>>& items, KeyFunc key, unsigned threads = 0);
+
+#include "key_sort-inl.h"
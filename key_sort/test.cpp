@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <random>
+#include <string>
+#include <gtest/gtest.h>
+#include "key_sort.h"
+
+
+class Record
+{
+public:
+    static int alive;
+
+    long id;
+    double score;
+    std::string name;
+    int position;
+
+    Record(long id, double score, std::string name, int position)
+        : id(id), score(score), name(std::move(name)), position(position)
+    {
+        ++alive;
+    }
+
+    ~Record() { --alive; }
+};
+
+int Record::alive = 0;
+
+
+std::vector<UniquePtr<Record>> make_records(std::size_t count, unsigned seed)
+{
+    std::mt19937 random(seed);
+    std::vector<UniquePtr<Record>> records;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        long id = static_cast<long>(random() % 1000) - 500;
+        double score = std::uniform_real_distribution<double>(-10.0, 10.0)(random);
+        records.emplace_back(new Record(id, score, std::to_string(random() % 5000), static_cast<int>(i)));
+    }
+    return records;
+}
+
+
+template <typename Key>
+void expect_stable_sorted(const std::vector<UniquePtr<Record>>& records, Key key)
+{
+    for (std::size_t i = 1; i < records.size(); ++i)
+    {
+        ASSERT_FALSE(key(*records[i]) < key(*records[i - 1]));
+        if (!(key(*records[i - 1]) < key(*records[i])))
+        {
+            ASSERT_LT(records[i - 1]->position, records[i]->position);
+        }
+    }
+}
+
+
+template <typename T>
+class KeySortTest : public ::testing::Test
+{};
+
+typedef ::testing::Types<std::integral_constant<unsigned, 1>, std::integral_constant<unsigned, 4>> ThreadCounts;
+
+TYPED_TEST_SUITE(KeySortTest, ThreadCounts);
+
+
+TYPED_TEST(KeySortTest, SignedIntegerKeys)
+{
+    std::vector<UniquePtr<Record>> records = make_records(300000, 1);
+    auto key = [](const Record& record) { return record.id; };
+
+    sort_by_key(records, key, TypeParam::value);
+
+    expect_stable_sorted(records, key);
+}
+
+
+TYPED_TEST(KeySortTest, FloatingPointKeys)
+{
+    std::vector<UniquePtr<Record>> records = make_records(300000, 2);
+    records[0]->score = -0.0;
+    records[1]->score = 0.0;
+    auto key = [](const Record& record) { return record.score; };
+
+    sort_by_key(records, key, TypeParam::value);
+
+    expect_stable_sorted(records, key);
+}
+
+
+TYPED_TEST(KeySortTest, StringKeysUseMergeSort)
+{
+    std::vector<UniquePtr<Record>> records = make_records(200000, 3);
+    auto key = [](const Record& record) { return record.name; };
+
+    sort_by_key(records, key, TypeParam::value);
+
+    expect_stable_sorted(records, key);
+}
+
+
+TYPED_TEST(KeySortTest, OwnersArePermutedNotCopied)
+{
+    const int alive = Record::alive;
+    {
+        std::vector<UniquePtr<Record>> records = make_records(100000, 4);
+        std::vector<Record*> addresses;
+        for (const UniquePtr<Record>& record : records)
+            addresses.push_back(record.get());
+
+        sort_by_key(records, [](const Record& record) { return record.id; }, TypeParam::value);
+
+        std::vector<Record*> sorted;
+        for (const UniquePtr<Record>& record : records)
+            sorted.push_back(record.get());
+        std::sort(addresses.begin(), addresses.end());
+        std::sort(sorted.begin(), sorted.end());
+        EXPECT_EQ(addresses, sorted);
+        EXPECT_EQ(Record::alive, alive + 100000);
+    }
+    EXPECT_EQ(Record::alive, alive);
+}
+
+
+TEST(KeySortEdgeTest, EmptyAndSingle)
+{
+    std::vector<UniquePtr<Record>> records;
+    sort_by_key(records, [](const Record& record) { return record.id; });
+    EXPECT_TRUE(records.empty());
+
+    records.emplace_back(new Record(1, 1.0, "a", 0));
+    sort_by_key(records, [](const Record& record) { return record.id; });
+    EXPECT_EQ(records[0]->id, 1);
+}
+
+
+TEST(KeySortEdgeTest, UnsignedExtremes)
+{
+    std::vector<KeyIndex<std::uint64_t>> keys = {{~0ull, 0}, {0, 1}, {1ull << 63, 2}, {5, 3}};
+    KeySort::sort_keys(keys, 1);
+
+    EXPECT_EQ(keys[0].index, 1u);
+    EXPECT_EQ(keys[1].index, 3u);
+    EXPECT_EQ(keys[2].index, 2u);
+    EXPECT_EQ(keys[3].index, 0u);
+}
+
+
+TEST(KeySortEdgeTest, PermuteFollowsCycles)
+{
+    std::vector<UniquePtr<int>> items;
+    for (int i = 0; i < 6; ++i)
+        items.emplace_back(new int(i));
+    std::vector<std::uint32_t> order = {3, 0, 1, 2, 5, 4};
+
+    KeySort::permute(items, order);
+
+    const int expected[] = {3, 0, 1, 2, 5, 4};
+    for (int i = 0; i < 6; ++i)
+        EXPECT_EQ(*items[static_cast<std::size_t>(i)], expected[i]);
+}
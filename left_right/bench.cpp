@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "../hdr_histogram/histogram.h"
+#include "../shared_ptr/shared.h"
+#include "left_right.h"
+
+
+typedef std::unordered_map<std::uint32_t, std::uint32_t> Routes;
+
+
+class LockedRoutes
+{
+private:
+    Routes routes;
+    mutable std::shared_mutex mutex;
+
+public:
+    explicit LockedRoutes(const Routes& routes) : routes(routes) {}
+
+    std::uint32_t lookup(std::uint32_t key) const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto it = routes.find(key);
+        return it == routes.end() ? 0 : it->second;
+    }
+
+    void update(std::uint32_t key, std::uint32_t value)
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        routes[key] = value;
+    }
+};
+
+
+class SnapshotRoutes
+{
+private:
+    SharedPtr<Routes> current;
+    mutable std::mutex mutex;
+
+public:
+    explicit SnapshotRoutes(const Routes& routes) : current(new Routes(routes)) {}
+
+    std::uint32_t lookup(std::uint32_t key) const
+    {
+        SharedPtr<Routes> snapshot;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            snapshot = current;
+        }
+        auto it = snapshot->find(key);
+        return it == snapshot->end() ? 0 : it->second;
+    }
+
+    void update(std::uint32_t key, std::uint32_t value)
+    {
+        SharedPtr<Routes> next(new Routes(*current));
+        (*next)[key] = value;
+        std::lock_guard<std::mutex> lock(mutex);
+        current = next;
+    }
+};
+
+
+class LeftRightRoutes
+{
+private:
+    LeftRight<Routes> routes;
+
+public:
+    explicit LeftRightRoutes(const Routes& routes) : routes(routes) {}
+
+    std::uint32_t lookup(std::uint32_t key) const
+    {
+        return routes.read([key](const Routes& map) {
+            auto it = map.find(key);
+            return it == map.end() ? 0 : it->second;
+        });
+    }
+
+    void update(std::uint32_t key, std::uint32_t value)
+    {
+        routes.write([key, value](Routes& map) { map[key] = value; });
+    }
+};
+
+
+template <typename Table>
+void run(const char* name, const Routes& routes, int readers, int seconds_per_run, int write_interval_us)
+{
+    Table table(routes);
+    const std::uint32_t size = static_cast<std::uint32_t>(routes.size());
+    std::atomic<bool> done(false);
+    HistogramGroup latencies;
+    long writes = 0;
+
+    std::vector<std::thread> threads;
+    for (int r = 0; r < readers; ++r)
+    {
+        threads.emplace_back([&, r]() {
+            HdrHistogram& mine = latencies.acquire();
+            std::uint32_t key = static_cast<std::uint32_t>(r) * 7919u;
+            std::uint64_t sink = 0;
+            while (!done.load(std::memory_order_relaxed))
+            {
+                key = key * 1664525u + 1013904223u;
+                auto start = std::chrono::steady_clock::now();
+                sink += table.lookup(key % size);
+                auto elapsed = std::chrono::steady_clock::now() - start;
+                mine.record(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+            }
+            if (sink == 42)
+                std::printf(" ");
+        });
+    }
+
+    auto end = std::chrono::steady_clock::now() + std::chrono::seconds(seconds_per_run);
+    while (std::chrono::steady_clock::now() < end)
+    {
+        table.update(static_cast<std::uint32_t>(writes) % size, static_cast<std::uint32_t>(writes));
+        ++writes;
+        std::this_thread::sleep_for(std::chrono::microseconds(write_interval_us));
+    }
+    done.store(true);
+    for (std::thread& thread : threads)
+        thread.join();
+
+    HdrHistogram all;
+    latencies.merge_into(all);
+    auto at = [&all](double percentile) { return static_cast<unsigned long long>(all.value_at_percentile(percentile)); };
+    std::printf("%-20s %10llu %8ld %8llu %8llu %8llu %10llu\n", name, static_cast<unsigned long long>(all.count()), writes,
+                at(50.0), at(99.0), at(99.9), static_cast<unsigned long long>(all.max()));
+}
+
+
+int main(int argc, char** argv)
+{
+    const std::size_t size = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+    const int readers = argc > 2 ? std::atoi(argv[2]) : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    const int seconds = argc > 3 ? std::atoi(argv[3]) : 2;
+    const int write_interval_us = argc > 4 ? std::atoi(argv[4]) : 100;
+
+    Routes routes;
+    for (std::uint32_t i = 0; i < size; ++i)
+        routes[i] = i;
+
+    std::printf("%zu routes, %d readers, one write every %d us; latencies in ns\n", size, readers, write_interval_us);
+    std::printf("%-20s %10s %8s %8s %8s %8s %10s\n", "table", "reads", "writes", "p50", "p99", "p99.9", "max");
+    run<LeftRightRoutes>("LeftRight", routes, readers, seconds, write_interval_us);
+    run<LockedRoutes>("shared_mutex", routes, readers, seconds, write_interval_us);
+    run<SnapshotRoutes>("SharedPtr snapshot", routes, readers, seconds, write_interval_us);
+    return 0;
+}
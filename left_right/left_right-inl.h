@@ -0,0 +1,110 @@
+#include <thread>
+
+inline ReadIndicator::ReadIndicator() noexcept
+{
+    for (Counter& counter : counters)
+        counter.readers.store(0, std::memory_order_relaxed);
+}
+
+inline std::size_t ReadIndicator::slot() noexcept
+{
+    static std::atomic<std::size_t> next(0);
+    static thread_local std::size_t mine = next.fetch_add(1, std::memory_order_relaxed) % slots;
+    return mine;
+}
+
+inline void ReadIndicator::arrive() noexcept
+{
+    counters[slot()].readers.fetch_add(1, std::memory_order_seq_cst);
+}
+
+inline void ReadIndicator::depart() noexcept
+{
+    counters[slot()].readers.fetch_sub(1, std::memory_order_release);
+}
+
+inline bool ReadIndicator::empty() const noexcept
+{
+    for (const Counter& counter : counters)
+    {
+        if (counter.readers.load(std::memory_order_seq_cst) != 0)
+            return false;
+    }
+    return true;
+}
+
+template <typename T>
+LeftRight<T>::LeftRight()
+    : instances(), left_right(0), version(0)
+{}
+
+template <typename T>
+LeftRight<T>::LeftRight(const T& value)
+    : instances{value, value}, left_right(0), version(0)
+{}
+
+template <typename T>
+template <typename Func>
+auto LeftRight<T>::read(Func func) const -> decltype(func(std::declval<const T&>()))
+{
+    const int current = version.load(std::memory_order_seq_cst);
+    ReadIndicator& indicator = indicators[current];
+
+    struct Departure
+    {
+        ReadIndicator& indicator;
+        ~Departure() { indicator.depart(); }
+    };
+
+    indicator.arrive();
+    Departure departure{indicator};
+    return func(instances[left_right.load(std::memory_order_seq_cst)]);
+}
+
+template <typename T>
+void LeftRight<T>::wait_for_readers(const ReadIndicator& indicator) const noexcept
+{
+    while (!indicator.empty())
+        std::this_thread::yield();
+}
+
+template <typename T>
+template <typename Func>
+void LeftRight<T>::write(Func func)
+{
+    enqueue(std::move(func));
+    flush();
+}
+
+template <typename T>
+template <typename Func>
+void LeftRight<T>::enqueue(Func func)
+{
+    std::lock_guard<std::mutex> lock(writer);
+    log.emplace_back(std::move(func));
+}
+
+template <typename T>
+void LeftRight<T>::flush()
+{
+    std::lock_guard<std::mutex> lock(writer);
+    if (log.empty())
+        return;
+
+    const int readable = left_right.load(std::memory_order_relaxed);
+    for (std::function<void(T&)>& operation : log)
+        operation(instances[1 - readable]);
+    left_right.store(1 - readable, std::memory_order_seq_cst);
+
+    // Readers that arrived before the switch may still use the old copy;
+    // they registered on one of the two version indicators, so drain both.
+    const int previous = version.load(std::memory_order_relaxed);
+    const int next = 1 - previous;
+    wait_for_readers(indicators[next]);
+    version.store(next, std::memory_order_seq_cst);
+    wait_for_readers(indicators[previous]);
+
+    for (std::function<void(T&)>& operation : log)
+        operation(instances[readable]);
+    log.clear();
+}
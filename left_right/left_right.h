@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// Counts readers that are inside one version. Each thread lands on its own
+// cache-line-padded counter, so arrivals from different threads do not
+// bounce a shared line.
+class ReadIndicator
+{
+private:
+    struct alignas(64) Counter
+    {
+        std::atomic<long> readers;
+    };
+
+    Counter counters[64];
+
+public:
+    static const std::size_t slots = 64;
+
+    ReadIndicator() noexcept;
+    ReadIndicator(const ReadIndicator&) = delete;
+    ReadIndicator& operator=(const ReadIndicator&) = delete;
+
+    void arrive() noexcept;
+    void depart() noexcept;
+    bool empty() const noexcept;
+
+    static std::size_t slot() noexcept;
+};
+
+// Keeps two copies of T. Readers always find one copy that no writer is
+// touching and never block or retry. A writer applies its operations to the
+// copy readers are not using and switches readers over to it. It then waits
+// for the readers still on the old copy to leave and replays the same
+// operations there. Writers are serialized by a mutex.
+template <typename T>
+class LeftRight
+{
+private:
+    T instances[2];
+    mutable ReadIndicator indicators[2];
+    std::atomic<int> left_right;
+    std::atomic<int> version;
+    std::mutex writer;
+    std::vector<std::function<void(T&)>> log;
+
+    void wait_for_readers(const ReadIndicator& indicator) const noexcept;
+
+public:
+    LeftRight();
+    explicit LeftRight(const T& value);
+    LeftRight(const LeftRight&) = delete;
+    LeftRight& operator=(const LeftRight&) = delete;
+
+    template <typename Func>
+    auto read(Func func) const -> decltype(func(std::declval<const T&>()));
+
+    template <typename Func>
+    void write(Func func);
+    template <typename Func>
+    void enqueue(Func func);
+    void flush();
+};
+
+#include "left_right-inl.h"
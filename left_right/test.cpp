@@ -0,0 +1,97 @@
+#include <map>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "left_right.h"
+
+
+TEST(LeftRightTest, ReadSeesWrites)
+{
+    LeftRight<std::map<int, int>> table;
+    EXPECT_EQ(table.read([](const std::map<int, int>& map) { return map.size(); }), 0u);
+
+    table.write([](std::map<int, int>& map) { map[1] = 10; });
+    table.write([](std::map<int, int>& map) { map[2] = 20; });
+
+    EXPECT_EQ(table.read([](const std::map<int, int>& map) { return map.at(1) + map.at(2); }), 30);
+}
+
+
+TEST(LeftRightTest, BothCopiesReceiveEveryOperation)
+{
+    LeftRight<std::vector<int>> values(std::vector<int>{1});
+    for (int i = 2; i <= 5; ++i)
+        values.write([i](std::vector<int>& vector) { vector.push_back(i); });
+
+    // Each write switches readers to the other copy, so consecutive reads
+    // across writes exercise both.
+    for (int i = 0; i < 2; ++i)
+    {
+        EXPECT_EQ(values.read([](const std::vector<int>& vector) { return vector; }), (std::vector<int>{1, 2, 3, 4, 5}));
+        values.write([](std::vector<int>&) {});
+    }
+}
+
+
+TEST(LeftRightTest, EnqueuedOperationsWaitForFlush)
+{
+    LeftRight<std::map<int, int>> table;
+    table.enqueue([](std::map<int, int>& map) { map[1] = 1; });
+    table.enqueue([](std::map<int, int>& map) { map[2] = 2; });
+    EXPECT_EQ(table.read([](const std::map<int, int>& map) { return map.size(); }), 0u);
+
+    table.flush();
+    EXPECT_EQ(table.read([](const std::map<int, int>& map) { return map.size(); }), 2u);
+
+    table.flush();
+    EXPECT_EQ(table.read([](const std::map<int, int>& map) { return map.size(); }), 2u);
+}
+
+
+TEST(LeftRightTest, ReadersNeverSeePartialWrites)
+{
+    LeftRight<std::vector<int>> values(std::vector<int>(64, 0));
+    std::atomic<bool> done(false);
+    std::atomic<long> torn(0);
+    std::atomic<long> reads(0);
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r)
+    {
+        readers.emplace_back([&]() {
+            while (!done.load())
+            {
+                bool consistent = values.read([](const std::vector<int>& vector) {
+                    for (int value : vector)
+                    {
+                        if (value != vector.front())
+                            return false;
+                    }
+                    return true;
+                });
+                if (!consistent)
+                    torn.fetch_add(1);
+                reads.fetch_add(1);
+            }
+        });
+    }
+
+    while (reads.load() == 0)
+        std::this_thread::yield();
+
+    for (int round = 1; round <= 200; ++round)
+    {
+        values.write([round](std::vector<int>& vector) {
+            for (int& value : vector)
+                value = round;
+        });
+        std::this_thread::yield();
+    }
+    done.store(true);
+    for (std::thread& reader : readers)
+        reader.join();
+
+    EXPECT_EQ(torn.load(), 0);
+    EXPECT_GT(reads.load(), 0);
+    EXPECT_EQ(values.read([](const std::vector<int>& vector) { return vector.back(); }), 200);
+}
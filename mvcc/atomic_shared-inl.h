@@ -0,0 +1,55 @@
+#include <mutex>
+#include <utility>
+
+template <typename T>
+AtomicSharedPtr<T>::AtomicSharedPtr() noexcept
+{
+}
+
+template <typename T>
+AtomicSharedPtr<T>::AtomicSharedPtr(SharedPtr<T> initial) noexcept : current(std::move(initial))
+{
+}
+
+template <typename T>
+SharedPtr<T> AtomicSharedPtr<T>::load() const noexcept
+{
+    std::lock_guard<TinyMutex> lock(mutex);
+    return current;
+}
+
+template <typename T>
+void AtomicSharedPtr<T>::store(SharedPtr<T> desired) noexcept
+{
+    // desired leaves with the old value and releases it unlocked.
+    exchange(std::move(desired));
+}
+
+template <typename T>
+SharedPtr<T> AtomicSharedPtr<T>::exchange(SharedPtr<T> desired) noexcept
+{
+    {
+        std::lock_guard<TinyMutex> lock(mutex);
+        std::swap(current, desired);
+    }
+    return desired;
+}
+
+template <typename T>
+bool AtomicSharedPtr<T>::compare_exchange(SharedPtr<T>& expected, SharedPtr<T> desired) noexcept
+{
+    // Assigning to expected may release its object, so that waits until
+    // the lock is dropped.
+    SharedPtr<T> observed;
+    {
+        std::lock_guard<TinyMutex> lock(mutex);
+        if (current.get() == expected.get())
+        {
+            std::swap(current, desired);
+            return true;
+        }
+        observed = current;
+    }
+    expected = std::move(observed);
+    return false;
+}
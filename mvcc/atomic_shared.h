@@ -0,0 +1,31 @@
+#pragma once
+
+#include "../shared_ptr/shared.h"
+#include "../tiny_mutex/tiny_mutex.h"
+
+// A SharedPtr slot that threads can load and replace concurrently. A
+// one-byte TinyMutex covers only the pointer copy or swap; the reference
+// dropped by a store is released after the lock, so destroying the old
+// object never blocks loads.
+template <typename T>
+class AtomicSharedPtr
+{
+private:
+    SharedPtr<T> current;
+    mutable TinyMutex mutex;
+
+public:
+    AtomicSharedPtr() noexcept;
+    explicit AtomicSharedPtr(SharedPtr<T> initial) noexcept;
+    AtomicSharedPtr(const AtomicSharedPtr&) = delete;
+    AtomicSharedPtr& operator=(const AtomicSharedPtr&) = delete;
+
+    SharedPtr<T> load() const noexcept;
+    void store(SharedPtr<T> desired) noexcept;
+    SharedPtr<T> exchange(SharedPtr<T> desired) noexcept;
+    // Installs desired if the slot still holds expected's object; otherwise
+    // loads the current value into expected.
+    bool compare_exchange(SharedPtr<T>& expected, SharedPtr<T> desired) noexcept;
+};
+
+#include "atomic_shared-inl.h"
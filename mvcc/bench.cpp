@@ -0,0 +1,165 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+#include "../hdr_histogram/histogram.h"
+#include "mvcc.h"
+
+
+// Baseline: one map behind a reader-writer lock; readers hold the shared
+// lock for the whole multi-key read so it is just as consistent.
+class LockedStore
+{
+private:
+    std::map<std::uint32_t, std::uint64_t> map;
+    mutable std::shared_mutex mutex;
+
+public:
+    void load(std::uint32_t keys)
+    {
+        for (std::uint32_t key = 0; key < keys; ++key)
+            map[key] = key;
+    }
+
+    std::uint64_t read(const std::uint32_t* keys, int count) const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        std::uint64_t sum = 0;
+        for (int i = 0; i < count; ++i)
+            sum += map.find(keys[i])->second;
+        return sum;
+    }
+
+    void commit(const std::uint32_t* keys, int count, std::uint64_t value)
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        for (int i = 0; i < count; ++i)
+            map[keys[i]] = value;
+    }
+};
+
+
+class VersionedStore
+{
+private:
+    MvccStore<std::uint32_t, std::uint64_t> store;
+
+public:
+    void load(std::uint32_t keys)
+    {
+        MvccStore<std::uint32_t, std::uint64_t>::Transaction transaction;
+        for (std::uint32_t key = 0; key < keys; ++key)
+            transaction.put(key, key);
+        store.commit(transaction);
+    }
+
+    std::uint64_t read(const std::uint32_t* keys, int count) const
+    {
+        MvccStore<std::uint32_t, std::uint64_t>::Snapshot snapshot = store.snapshot();
+        std::uint64_t sum = 0;
+        for (int i = 0; i < count; ++i)
+            sum += *snapshot.find(keys[i]);
+        return sum;
+    }
+
+    void commit(const std::uint32_t* keys, int count, std::uint64_t value)
+    {
+        MvccStore<std::uint32_t, std::uint64_t>::Transaction transaction;
+        for (int i = 0; i < count; ++i)
+            transaction.put(keys[i], value);
+        store.commit(transaction);
+    }
+};
+
+
+template <typename Store>
+void run(const char* name, std::uint32_t keys, int readers, int keys_per_read, int keys_per_commit, int seconds)
+{
+    Store store;
+    store.load(keys);
+    std::atomic<bool> done(false);
+    std::atomic<long> reads(0);
+
+    std::vector<std::thread> threads;
+    for (int r = 0; r < readers; ++r)
+    {
+        threads.emplace_back([&, r]() {
+            std::vector<std::uint32_t> batch(keys_per_read);
+            std::uint32_t seed = static_cast<std::uint32_t>(r) * 7919u + 1;
+            std::uint64_t sink = 0;
+            long mine = 0;
+            while (!done.load(std::memory_order_relaxed))
+            {
+                for (std::uint32_t& key : batch)
+                {
+                    seed = seed * 1664525u + 1013904223u;
+                    key = (seed >> 8) % keys;
+                }
+                sink += store.read(batch.data(), keys_per_read);
+                ++mine;
+            }
+            reads.fetch_add(mine);
+            if (sink == 42)
+                std::printf(" ");
+        });
+    }
+
+    // The writer stops on a timer rather than on its own clock: a reader-
+    // preferring lock can starve it for as long as readers keep overlapping.
+    HdrHistogram commits;
+    std::thread writer([&]() {
+        std::vector<std::uint32_t> batch(keys_per_commit);
+        std::uint32_t seed = 12345;
+        std::uint64_t value = 0;
+        while (!done.load(std::memory_order_relaxed))
+        {
+            for (std::uint32_t& key : batch)
+            {
+                seed = seed * 1664525u + 1013904223u;
+                key = (seed >> 8) % keys;
+            }
+            auto start = std::chrono::steady_clock::now();
+            store.commit(batch.data(), keys_per_commit, ++value);
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            commits.record(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+            // Leave the readers some of the machine.
+            std::this_thread::yield();
+        }
+    });
+
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    done.store(true);
+    writer.join();
+    for (std::thread& thread : threads)
+        thread.join();
+
+    auto at = [&commits](double percentile) {
+        return static_cast<unsigned long long>(commits.value_at_percentile(percentile));
+    };
+    std::printf("%-16s %8d %14.0f %10llu %8llu %8llu %8llu\n", name, readers, static_cast<double>(reads.load()) / seconds,
+                static_cast<unsigned long long>(commits.count()), at(50.0), at(99.0), at(99.9));
+}
+
+
+int main(int argc, char** argv)
+{
+    const std::uint32_t keys = argc > 1 ? static_cast<std::uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 100000;
+    const int max_readers = argc > 2 ? std::atoi(argv[2]) : static_cast<int>(std::max(2u, std::thread::hardware_concurrency()));
+    const int keys_per_read = argc > 3 ? std::atoi(argv[3]) : 16;
+    const int keys_per_commit = argc > 4 ? std::atoi(argv[4]) : 4;
+    const int seconds = argc > 5 ? std::atoi(argv[5]) : 2;
+
+    std::printf("%u keys, %d keys per snapshot read, %d keys per commit, 1 writer; commit latency in ns\n", keys,
+                keys_per_read, keys_per_commit);
+    std::printf("%-16s %8s %14s %10s %8s %8s %8s\n", "store", "readers", "reads/s", "commits", "p50", "p99", "p99.9");
+    for (int readers = 0; readers <= max_readers; readers = readers ? readers * 2 : 1)
+    {
+        run<VersionedStore>("MvccStore", keys, readers, keys_per_read, keys_per_commit, seconds);
+        run<LockedStore>("shared_mutex map", keys, readers, keys_per_read, keys_per_commit, seconds);
+    }
+    return 0;
+}
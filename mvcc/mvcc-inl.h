@@ -0,0 +1,259 @@
+#include <utility>
+
+template <typename K, typename V, typename Less>
+MvccStore<K, V, Less>::Node::Node(const K& key, const V& value, const std::uint64_t priority,
+                                  const SharedPtr<const Node>& left, const SharedPtr<const Node>& right)
+    : key(key), value(value), left(left), right(right)
+{
+    this->priority = priority;
+}
+
+template <typename K, typename V, typename Less>
+MvccStore<K, V, Less>::Version::Version(const std::uint64_t number, const std::size_t size,
+                                        const SharedPtr<const Node>& root)
+    : root(root)
+{
+    this->number = number;
+    this->size = size;
+}
+
+template <typename K, typename V, typename Less>
+MvccStore<K, V, Less>::Snapshot::Snapshot(SharedPtr<const Version> version, const Less& less) noexcept
+    : version(std::move(version)), less(less)
+{
+}
+
+template <typename K, typename V, typename Less>
+std::uint64_t MvccStore<K, V, Less>::Snapshot::number() const noexcept
+{
+    return version->number;
+}
+
+template <typename K, typename V, typename Less>
+std::size_t MvccStore<K, V, Less>::Snapshot::size() const noexcept
+{
+    return version->size;
+}
+
+template <typename K, typename V, typename Less>
+const V* MvccStore<K, V, Less>::Snapshot::find(const K& key) const
+{
+    const Node* node = version->root.get();
+    while (node)
+    {
+        if (less(key, node->key))
+            node = node->left.get();
+        else if (less(node->key, key))
+            node = node->right.get();
+        else
+            return &node->value;
+    }
+    return nullptr;
+}
+
+template <typename K, typename V, typename Less>
+bool MvccStore<K, V, Less>::Snapshot::contains(const K& key) const
+{
+    return find(key) != nullptr;
+}
+
+template <typename K, typename V, typename Less>
+template <typename Func>
+void MvccStore<K, V, Less>::Snapshot::scan_node(const Node* const node, const K& from, const K& to, Func& func) const
+{
+    if (!node)
+        return;
+    const bool above_from = !less(node->key, from);
+    const bool below_to = less(node->key, to);
+    if (above_from)
+        scan_node(node->left.get(), from, to, func);
+    if (above_from && below_to)
+        func(node->key, node->value);
+    if (below_to)
+        scan_node(node->right.get(), from, to, func);
+}
+
+template <typename K, typename V, typename Less>
+template <typename Func>
+void MvccStore<K, V, Less>::Snapshot::scan(const K& from, const K& to, Func func) const
+{
+    scan_node(version->root.get(), from, to, func);
+}
+
+template <typename K, typename V, typename Less>
+template <typename Func>
+void MvccStore<K, V, Less>::Snapshot::for_each(Func func) const
+{
+    // Iterative in-order walk; the treap is balanced only in expectation.
+    std::vector<const Node*> path;
+    const Node* node = version->root.get();
+    while (node || !path.empty())
+    {
+        while (node)
+        {
+            path.push_back(node);
+            node = node->left.get();
+        }
+        node = path.back();
+        path.pop_back();
+        func(node->key, node->value);
+        node = node->right.get();
+    }
+}
+
+template <typename K, typename V, typename Less>
+void MvccStore<K, V, Less>::Transaction::put(const K& key, V value)
+{
+    writes.push_back(Write{key, MakeShared<const V>(std::move(value))});
+}
+
+template <typename K, typename V, typename Less>
+void MvccStore<K, V, Less>::Transaction::erase(const K& key)
+{
+    writes.push_back(Write{key, SharedPtr<const V>()});
+}
+
+template <typename K, typename V, typename Less>
+bool MvccStore<K, V, Less>::Transaction::empty() const noexcept
+{
+    return writes.empty();
+}
+
+template <typename K, typename V, typename Less>
+MvccStore<K, V, Less>::MvccStore(const Less& less)
+    : current(MakeShared<const Version>(0, 0, SharedPtr<const Node>())), less(less)
+{
+}
+
+template <typename K, typename V, typename Less>
+typename MvccStore<K, V, Less>::Snapshot MvccStore<K, V, Less>::snapshot() const noexcept
+{
+    return Snapshot(current.load(), less);
+}
+
+template <typename K, typename V, typename Less>
+std::uint64_t MvccStore<K, V, Less>::priority_of(const K& key) noexcept
+{
+    // Priorities derived from the key make the tree shape a function of the
+    // key set alone.
+    std::uint64_t hash = static_cast<std::uint64_t>(std::hash<K>()(key)) + 0x9e3779b97f4a7c15ull;
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ull;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebull;
+    return hash ^ (hash >> 31);
+}
+
+template <typename K, typename V, typename Less>
+SharedPtr<const typename MvccStore<K, V, Less>::Node> MvccStore<K, V, Less>::make(
+    const Node& from, const SharedPtr<const Node>& left, const SharedPtr<const Node>& right)
+{
+    return MakeShared<const Node>(from.key, from.value, from.priority, left, right);
+}
+
+template <typename K, typename V, typename Less>
+SharedPtr<const typename MvccStore<K, V, Less>::Node> MvccStore<K, V, Less>::insert(
+    const SharedPtr<const Node>& node, const K& key, const V& value, bool& added) const
+{
+    if (!node)
+    {
+        added = true;
+        return MakeShared<const Node>(key, value, priority_of(key), SharedPtr<const Node>(), SharedPtr<const Node>());
+    }
+
+    if (less(key, node->key))
+    {
+        SharedPtr<const Node> left = insert(node->left, key, value, added);
+        if (left->priority > node->priority)
+            return make(*left, left->left, make(*node, left->right, node->right));
+        return make(*node, left, node->right);
+    }
+    if (less(node->key, key))
+    {
+        SharedPtr<const Node> right = insert(node->right, key, value, added);
+        if (right->priority > node->priority)
+            return make(*right, make(*node, node->left, right->left), right->right);
+        return make(*node, node->left, right);
+    }
+    return MakeShared<const Node>(node->key, value, node->priority, node->left, node->right);
+}
+
+template <typename K, typename V, typename Less>
+SharedPtr<const typename MvccStore<K, V, Less>::Node> MvccStore<K, V, Less>::merge(
+    const SharedPtr<const Node>& low, const SharedPtr<const Node>& high)
+{
+    if (!low)
+        return high;
+    if (!high)
+        return low;
+    if (low->priority > high->priority)
+        return make(*low, low->left, merge(low->right, high));
+    return make(*high, merge(low, high->left), high->right);
+}
+
+template <typename K, typename V, typename Less>
+SharedPtr<const typename MvccStore<K, V, Less>::Node> MvccStore<K, V, Less>::remove(
+    const SharedPtr<const Node>& node, const K& key, bool& removed) const
+{
+    if (!node)
+        return node;
+
+    if (less(key, node->key))
+    {
+        SharedPtr<const Node> left = remove(node->left, key, removed);
+        return removed ? make(*node, left, node->right) : node;
+    }
+    if (less(node->key, key))
+    {
+        SharedPtr<const Node> right = remove(node->right, key, removed);
+        return removed ? make(*node, node->left, right) : node;
+    }
+    removed = true;
+    return merge(node->left, node->right);
+}
+
+template <typename K, typename V, typename Less>
+std::uint64_t MvccStore<K, V, Less>::commit(const Transaction& transaction)
+{
+    std::lock_guard<std::mutex> lock(commit_mutex);
+    SharedPtr<const Version> base = current.load();
+    if (transaction.writes.empty())
+        return base->number;
+
+    // Nodes built by an earlier write of this transaction are copied again
+    // by later ones; they were never published, so that is only garbage.
+    SharedPtr<const Node> root = base->root;
+    std::size_t size = base->size;
+    for (const Write& write : transaction.writes)
+    {
+        bool changed = false;
+        if (write.value)
+        {
+            root = insert(root, write.key, *write.value, changed);
+            size += changed ? 1 : 0;
+        }
+        else
+        {
+            root = remove(root, write.key, changed);
+            size -= changed ? 1 : 0;
+        }
+    }
+
+    const std::uint64_t number = base->number + 1;
+    current.store(MakeShared<const Version>(number, size, root));
+    return number;
+}
+
+template <typename K, typename V, typename Less>
+std::uint64_t MvccStore<K, V, Less>::put(const K& key, V value)
+{
+    Transaction transaction;
+    transaction.put(key, std::move(value));
+    return commit(transaction);
+}
+
+template <typename K, typename V, typename Less>
+std::uint64_t MvccStore<K, V, Less>::erase(const K& key)
+{
+    Transaction transaction;
+    transaction.erase(key);
+    return commit(transaction);
+}
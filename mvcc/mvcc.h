@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+#include "atomic_shared.h"
+
+// Multi-version key-value store. Every version is an immutable treap whose
+// nodes are shared with the versions before and after it: a commit copies
+// only the paths to the keys it changes and publishes the new root with one
+// AtomicSharedPtr store. A Snapshot pins its version by holding the root,
+// so it sees every key as of one commit however many commits follow, and
+// nodes no version references any more are freed when their last snapshot
+// goes away.
+//
+// Commits are serialised among themselves; snapshots never wait for them.
+// Values live in the nodes, so a lookup touches no other memory but path
+// copying copies them; large values are better stored as SharedPtr<const V>.
+template <typename K, typename V, typename Less = std::less<K>>
+class MvccStore
+{
+private:
+    struct Node
+    {
+        K key;
+        V value;
+        std::uint64_t priority;
+        SharedPtr<const Node> left;
+        SharedPtr<const Node> right;
+
+        Node(const K& key, const V& value, std::uint64_t priority, const SharedPtr<const Node>& left,
+             const SharedPtr<const Node>& right);
+    };
+
+    struct Version
+    {
+        std::uint64_t number;
+        std::size_t size;
+        SharedPtr<const Node> root;
+
+        Version(std::uint64_t number, std::size_t size, const SharedPtr<const Node>& root);
+    };
+
+    struct Write
+    {
+        K key;
+        // Null for an erase.
+        SharedPtr<const V> value;
+    };
+
+    AtomicSharedPtr<const Version> current;
+    std::mutex commit_mutex;
+    Less less;
+
+    static std::uint64_t priority_of(const K& key) noexcept;
+    static SharedPtr<const Node> make(const Node& from, const SharedPtr<const Node>& left,
+                                      const SharedPtr<const Node>& right);
+    SharedPtr<const Node> insert(const SharedPtr<const Node>& node, const K& key, const V& value, bool& added) const;
+    SharedPtr<const Node> remove(const SharedPtr<const Node>& node, const K& key, bool& removed) const;
+    static SharedPtr<const Node> merge(const SharedPtr<const Node>& low, const SharedPtr<const Node>& high);
+
+public:
+    class Snapshot
+    {
+    private:
+        SharedPtr<const Version> version;
+        Less less;
+
+        template <typename Func>
+        void scan_node(const Node* node, const K& from, const K& to, Func& func) const;
+
+        explicit Snapshot(SharedPtr<const Version> version, const Less& less) noexcept;
+        friend class MvccStore;
+
+    public:
+        std::uint64_t number() const noexcept;
+        std::size_t size() const noexcept;
+        // Valid for as long as this snapshot or a copy of it is alive.
+        const V* find(const K& key) const;
+        bool contains(const K& key) const;
+        // Calls func(key, value) for keys in [from, to), in order.
+        template <typename Func>
+        void scan(const K& from, const K& to, Func func) const;
+        template <typename Func>
+        void for_each(Func func) const;
+    };
+
+    // Writes applied atomically by commit(), in the order they were made.
+    class Transaction
+    {
+    private:
+        std::vector<Write> writes;
+        friend class MvccStore;
+
+    public:
+        void put(const K& key, V value);
+        void erase(const K& key);
+        bool empty() const noexcept;
+    };
+
+    explicit MvccStore(const Less& less = Less());
+    MvccStore(const MvccStore&) = delete;
+    MvccStore& operator=(const MvccStore&) = delete;
+
+    Snapshot snapshot() const noexcept;
+    // Publishes the transaction's writes as one new version and returns
+    // its number; an empty transaction publishes nothing.
+    std::uint64_t commit(const Transaction& transaction);
+    std::uint64_t put(const K& key, V value);
+    std::uint64_t erase(const K& key);
+};
+
+#include "mvcc-inl.h"
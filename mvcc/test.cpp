@@ -0,0 +1,169 @@
+#include <atomic>
+#include <map>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+#include "mvcc.h"
+
+
+struct Tracked
+{
+    static std::atomic<int> live;
+    int value;
+
+    explicit Tracked(int value) : value(value) { ++live; }
+    Tracked(const Tracked& other) : value(other.value) { ++live; }
+    ~Tracked() { --live; }
+};
+
+std::atomic<int> Tracked::live(0);
+
+
+TEST(AtomicSharedPtrTest, LoadStoreAndCompareExchange)
+{
+    AtomicSharedPtr<int> slot(MakeShared<int>(1));
+    SharedPtr<int> first = slot.load();
+    EXPECT_EQ(*first, 1);
+    EXPECT_EQ(first.use_count(), 2);
+
+    SharedPtr<int> old = slot.exchange(MakeShared<int>(2));
+    EXPECT_EQ(old.get(), first.get());
+    EXPECT_EQ(*slot.load(), 2);
+
+    SharedPtr<int> expected = first;
+    EXPECT_FALSE(slot.compare_exchange(expected, MakeShared<int>(3)));
+    EXPECT_EQ(*expected, 2);
+    EXPECT_TRUE(slot.compare_exchange(expected, MakeShared<int>(4)));
+    EXPECT_EQ(*slot.load(), 4);
+}
+
+
+TEST(MvccStoreTest, SnapshotsKeepTheirVersion)
+{
+    MvccStore<int, std::string> store;
+    EXPECT_EQ(store.put(1, "one"), 1u);
+    EXPECT_EQ(store.put(2, "two"), 2u);
+    MvccStore<int, std::string>::Snapshot before = store.snapshot();
+
+    store.put(1, "uno");
+    store.erase(2);
+    store.put(3, "three");
+
+    EXPECT_EQ(before.number(), 2u);
+    EXPECT_EQ(before.size(), 2u);
+    EXPECT_EQ(*before.find(1), "one");
+    EXPECT_EQ(*before.find(2), "two");
+    EXPECT_FALSE(before.contains(3));
+
+    MvccStore<int, std::string>::Snapshot after = store.snapshot();
+    EXPECT_EQ(after.number(), 5u);
+    EXPECT_EQ(after.size(), 2u);
+    EXPECT_EQ(*after.find(1), "uno");
+    EXPECT_EQ(after.find(2), nullptr);
+    EXPECT_EQ(*after.find(3), "three");
+}
+
+
+TEST(MvccStoreTest, MatchesStdMapAndScansInOrder)
+{
+    MvccStore<int, int> store;
+    std::map<int, int> model;
+    unsigned seed = 7;
+    for (int i = 0; i < 5000; ++i)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        const int key = static_cast<int>((seed >> 8) % 1000);
+        MvccStore<int, int>::Transaction transaction;
+        if ((seed >> 28) < 4)
+        {
+            transaction.erase(key);
+            model.erase(key);
+        }
+        else
+        {
+            transaction.put(key, i);
+            model[key] = i;
+        }
+        store.commit(transaction);
+    }
+
+    MvccStore<int, int>::Snapshot snapshot = store.snapshot();
+    ASSERT_EQ(snapshot.size(), model.size());
+    std::vector<std::pair<int, int>> all;
+    snapshot.for_each([&all](int key, int value) { all.emplace_back(key, value); });
+    EXPECT_EQ(all, (std::vector<std::pair<int, int>>(model.begin(), model.end())));
+
+    std::vector<std::pair<int, int>> range;
+    snapshot.scan(100, 200, [&range](int key, int value) { range.emplace_back(key, value); });
+    EXPECT_EQ(range, (std::vector<std::pair<int, int>>(model.lower_bound(100), model.lower_bound(200))));
+}
+
+
+TEST(MvccStoreTest, OldVersionsAreFreedWithTheirLastSnapshot)
+{
+    Tracked::live = 0;
+    {
+        MvccStore<int, Tracked> store;
+        store.put(1, Tracked(10));
+        MvccStore<int, Tracked>::Snapshot pinned = store.snapshot();
+        store.put(1, Tracked(11));
+        store.put(1, Tracked(12));
+
+        // Version 2 is gone already; version 1 is pinned.
+        EXPECT_EQ(Tracked::live, 2);
+        EXPECT_EQ(pinned.find(1)->value, 10);
+        pinned = store.snapshot();
+        EXPECT_EQ(Tracked::live, 1);
+    }
+    EXPECT_EQ(Tracked::live, 0);
+}
+
+
+TEST(MvccStoreTest, ReadersSeeWholeTransactions)
+{
+    // Every commit moves one unit between two accounts, so each snapshot
+    // must add up to the same total.
+    const int accounts = 64;
+    MvccStore<int, long> store;
+    MvccStore<int, long>::Transaction setup;
+    for (int i = 0; i < accounts; ++i)
+        setup.put(i, 100);
+    store.commit(setup);
+
+    std::atomic<bool> done(false);
+    std::atomic<long> bad(0);
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r)
+    {
+        readers.emplace_back([&]() {
+            while (!done.load(std::memory_order_relaxed))
+            {
+                long total = 0;
+                store.snapshot().for_each([&total](int, long value) { total += value; });
+                if (total != 100 * accounts)
+                    ++bad;
+            }
+        });
+    }
+
+    unsigned seed = 3;
+    for (int i = 0; i < 20000; ++i)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        const int from = static_cast<int>((seed >> 8) % accounts);
+        const int to = static_cast<int>((seed >> 16) % accounts);
+        if (from == to)
+            continue;
+        MvccStore<int, long>::Snapshot view = store.snapshot();
+        MvccStore<int, long>::Transaction transfer;
+        transfer.put(from, *view.find(from) - 1);
+        transfer.put(to, *view.find(to) + 1);
+        store.commit(transfer);
+    }
+    done = true;
+    for (std::thread& reader : readers)
+        reader.join();
+    EXPECT_EQ(bad.load(), 0);
+}
@@ -0,0 +1,269 @@
+#include <algorithm>
+#include <chrono>
+#include <new>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+inline Blob::Blob(const std::uint32_t bytes) noexcept
+{
+    this->bytes = bytes;
+    Counters& counters = Blob::counters();
+    ++counters.live;
+    counters.live_bytes += bytes;
+    counters.peak = std::max(counters.peak, counters.live);
+    counters.peak_bytes = std::max(counters.peak_bytes, counters.live_bytes);
+}
+
+inline Blob::~Blob() noexcept
+{
+    Counters& counters = Blob::counters();
+    --counters.live;
+    counters.live_bytes -= bytes;
+}
+
+inline Blob::Counters& Blob::counters() noexcept
+{
+    static Counters counters;
+    return counters;
+}
+
+inline void Blob::reset_peak() noexcept
+{
+    Counters& counters = Blob::counters();
+    counters.peak = counters.live;
+    counters.peak_bytes = counters.live_bytes;
+}
+
+inline Blob* Blob::create(const std::uint32_t size)
+{
+    const std::uint32_t bytes = std::max<std::uint32_t>(size, sizeof(Blob));
+    void* memory = ::operator new(bytes);
+    return new (memory) Blob(bytes);
+}
+
+inline void Blob::operator delete(void* const memory) noexcept
+{
+    ::operator delete(memory);
+}
+
+inline ReplayHeap::Counters& ReplayHeap::counters() noexcept
+{
+    static Counters counters;
+    return counters;
+}
+
+inline void ReplayHeap::allocated(const std::size_t bytes) noexcept
+{
+    Counters& counters = ReplayHeap::counters();
+    ++counters.allocations;
+    counters.live += bytes;
+    counters.peak = std::max(counters.peak, counters.live);
+}
+
+inline void ReplayHeap::freed(const std::size_t bytes) noexcept
+{
+    counters().live -= bytes;
+}
+
+inline void ReplayHeap::reset() noexcept
+{
+    Counters& counters = ReplayHeap::counters();
+    counters.allocations = 0;
+    counters.peak = counters.live;
+}
+
+inline const char* RepoPointers::name() noexcept
+{
+    return "SharedPtr/UniquePtr";
+}
+
+inline const char* StdPointers::name() noexcept
+{
+    return "std::shared_ptr/unique_ptr";
+}
+
+inline ReplayProgram PtrReplay::compile(const std::vector<TraceEvent>& events)
+{
+    ReplayProgram program;
+    std::unordered_map<std::uint64_t, std::uint32_t> slots[2];
+    std::vector<std::uint32_t> free_slots[2];
+    std::uint32_t* counts[2] = {&program.shared_slots, &program.unique_slots};
+    std::unordered_set<std::uint16_t> threads;
+
+    // Whether each slot holds an object, followed along the trace so that
+    // slots of instances that died empty (which is never logged) can be
+    // reused.
+    std::vector<bool> full[2];
+
+    auto find = [&](int pointer, std::uint64_t address) {
+        auto found = slots[pointer].find(address);
+        return found == slots[pointer].end() ? none : found->second;
+    };
+    auto assign = [&](int pointer, std::uint64_t address) {
+        const std::uint32_t old = find(pointer, address);
+        if (old != none && !full[pointer][old])
+            free_slots[pointer].push_back(old);
+
+        std::uint32_t slot;
+        if (!free_slots[pointer].empty())
+        {
+            slot = free_slots[pointer].back();
+            free_slots[pointer].pop_back();
+        }
+        else
+        {
+            slot = (*counts[pointer])++;
+            full[pointer].push_back(false);
+        }
+        slots[pointer][address] = slot;
+        return slot;
+    };
+
+    program.ops.reserve(events.size());
+    for (const TraceEvent& event : events)
+    {
+        const int pointer = static_cast<int>(event.pointer);
+        ReplayOp op;
+        op.kind = event.kind;
+        op.pointer = event.pointer;
+        op.source = none;
+        op.size = event.size;
+
+        switch (event.kind)
+        {
+        case TraceKind::create:
+            op.slot = assign(pointer, event.self);
+            break;
+        case TraceKind::copy:
+        case TraceKind::move:
+            op.source = find(pointer, event.other);
+            op.slot = assign(pointer, event.self);
+            break;
+        case TraceKind::copy_assign:
+        case TraceKind::move_assign:
+            op.source = find(pointer, event.other);
+            op.slot = find(pointer, event.self);
+            if (op.slot == none)
+                op.slot = assign(pointer, event.self);
+            break;
+        case TraceKind::reset:
+        case TraceKind::destroy:
+            op.slot = find(pointer, event.self);
+            if (op.slot == none)
+                continue;
+            if (event.kind == TraceKind::destroy)
+            {
+                slots[pointer].erase(event.self);
+                free_slots[pointer].push_back(op.slot);
+            }
+            break;
+        }
+        switch (event.kind)
+        {
+        case TraceKind::create:
+            full[pointer][op.slot] = true;
+            break;
+        case TraceKind::copy:
+        case TraceKind::copy_assign:
+            full[pointer][op.slot] = op.source != none && full[pointer][op.source];
+            break;
+        case TraceKind::move:
+        case TraceKind::move_assign:
+            full[pointer][op.slot] = op.source != none && full[pointer][op.source];
+            if (op.source != none && op.source != op.slot)
+                full[pointer][op.source] = false;
+            break;
+        case TraceKind::reset:
+        case TraceKind::destroy:
+            full[pointer][op.slot] = false;
+            break;
+        }
+        threads.insert(event.thread);
+        program.ops.push_back(op);
+    }
+    program.threads = threads.size();
+    return program;
+}
+
+template <typename Pointers>
+ReplayStats PtrReplay::run(const ReplayProgram& program)
+{
+    typedef typename Pointers::Shared Shared;
+    typedef typename Pointers::Unique Unique;
+
+    ReplayStats stats = {};
+    std::vector<Shared> shared(program.shared_slots);
+    std::vector<Unique> unique(program.unique_slots);
+    Blob::reset_peak();
+    const std::size_t base_objects = Blob::counters().live;
+    const std::size_t base_bytes = Blob::counters().live_bytes;
+    ReplayHeap::reset();
+    const std::size_t base_heap = ReplayHeap::counters().live;
+
+    auto start = std::chrono::steady_clock::now();
+    for (const ReplayOp& op : program.ops)
+    {
+        if (op.pointer == TracePointer::shared)
+        {
+            Shared& slot = shared[op.slot];
+            switch (op.kind)
+            {
+            case TraceKind::create:
+                slot = Shared(Blob::create(op.size));
+                ++stats.objects;
+                break;
+            case TraceKind::copy:
+            case TraceKind::copy_assign:
+                if (op.source == none)
+                    slot.reset();
+                else
+                    slot = shared[op.source];
+                break;
+            case TraceKind::move:
+            case TraceKind::move_assign:
+                if (op.source == none)
+                    slot.reset();
+                else
+                    slot = std::move(shared[op.source]);
+                break;
+            case TraceKind::reset:
+            case TraceKind::destroy:
+                slot.reset();
+                break;
+            }
+        }
+        else
+        {
+            Unique& slot = unique[op.slot];
+            switch (op.kind)
+            {
+            case TraceKind::create:
+                slot = Unique(Blob::create(op.size));
+                ++stats.objects;
+                break;
+            case TraceKind::move:
+            case TraceKind::move_assign:
+                if (op.source == none)
+                    slot.reset();
+                else
+                    slot = std::move(unique[op.source]);
+                break;
+            case TraceKind::copy:
+            case TraceKind::copy_assign:
+            case TraceKind::reset:
+            case TraceKind::destroy:
+                slot.reset();
+                break;
+            }
+        }
+    }
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    stats.operations = program.ops.size();
+    stats.peak_objects = Blob::counters().peak - base_objects;
+    stats.peak_payload_bytes = Blob::counters().peak_bytes - base_bytes;
+    stats.allocations = ReplayHeap::counters().allocations;
+    stats.peak_heap_bytes = ReplayHeap::counters().peak - base_heap;
+    return stats;
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "ptr_trace.h"
+#include "../shared_ptr/shared.h"
+#include "../unique_ptr/unique.h"
+
+// Stand-in for a traced object: an allocation of the recorded size. Keeps
+// counts of live objects and payload bytes for the replay report.
+class Blob
+{
+private:
+    std::uint32_t bytes;
+
+    struct Counters
+    {
+        std::size_t live;
+        std::size_t live_bytes;
+        std::size_t peak;
+        std::size_t peak_bytes;
+    };
+
+    explicit Blob(std::uint32_t bytes) noexcept;
+
+public:
+    static Counters& counters() noexcept;
+    static void reset_peak() noexcept;
+
+    static Blob* create(std::uint32_t size);
+    static void operator delete(void* memory) noexcept;
+    ~Blob() noexcept;
+};
+
+// Heap counters for the replay report. They stay at zero unless the
+// program replaces the global operator new and delete to feed them, as the
+// replay driver does.
+class ReplayHeap
+{
+private:
+    struct Counters
+    {
+        std::size_t allocations;
+        std::size_t live;
+        std::size_t peak;
+    };
+
+public:
+    static Counters& counters() noexcept;
+    static void allocated(std::size_t bytes) noexcept;
+    static void freed(std::size_t bytes) noexcept;
+    static void reset() noexcept;
+};
+
+struct ReplayOp
+{
+    TraceKind kind;
+    TracePointer pointer;
+    std::uint32_t slot;
+    std::uint32_t source;
+    std::uint32_t size;
+};
+
+// A trace rewritten against dense slot numbers, so replaying it is a flat
+// loop over arrays with no address lookups.
+struct ReplayProgram
+{
+    std::vector<ReplayOp> ops;
+    std::uint32_t shared_slots = 0;
+    std::uint32_t unique_slots = 0;
+    std::size_t threads = 0;
+};
+
+struct ReplayStats
+{
+    double seconds;
+    std::size_t operations;
+    std::size_t objects;
+    std::size_t peak_objects;
+    std::size_t peak_payload_bytes;
+    std::size_t allocations;
+    std::size_t peak_heap_bytes;
+};
+
+// Pointer implementations a trace can be replayed against. Each provides
+// Shared and Unique types over Blob and a way to take ownership of one.
+struct RepoPointers
+{
+    typedef SharedPtr<Blob> Shared;
+    typedef UniquePtr<Blob> Unique;
+    static const char* name() noexcept;
+};
+
+struct StdPointers
+{
+    typedef std::shared_ptr<Blob> Shared;
+    typedef std::unique_ptr<Blob> Unique;
+    static const char* name() noexcept;
+};
+
+// Replays in recorded order on the calling thread; the thread ids in the
+// trace only feed the report. Concurrency effects such as contended
+// reference counts are therefore not reproduced.
+class PtrReplay
+{
+public:
+    static const std::uint32_t none = 0xffffffffu;
+
+    static ReplayProgram compile(const std::vector<TraceEvent>& events);
+
+    template <typename Pointers>
+    static ReplayStats run(const ReplayProgram& program);
+};
+
+#include "ptr_replay-inl.h"
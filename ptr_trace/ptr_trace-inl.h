@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <system_error>
+#include <sys/stat.h>
+
+inline PtrTraceLog::PtrTraceLog()
+{
+    PtrTrace::State& state = PtrTrace::state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    thread = state.next_thread++;
+    state.threads.push_back(this);
+}
+
+inline PtrTraceLog::~PtrTraceLog()
+{
+    PtrTrace::State& state = PtrTrace::state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.finished.insert(state.finished.end(), events.begin(), events.end());
+    state.threads.erase(std::find(state.threads.begin(), state.threads.end(), this));
+}
+
+inline PtrTrace::State& PtrTrace::state() noexcept
+{
+    static State state;
+    return state;
+}
+
+inline PtrTraceLog& PtrTrace::local()
+{
+    static thread_local PtrTraceLog log;
+    return log;
+}
+
+inline void PtrTrace::start()
+{
+    State& state = PtrTrace::state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    for (PtrTraceLog* thread : state.threads)
+        thread->events.clear();
+    state.finished.clear();
+    state.sequence.store(0, std::memory_order_relaxed);
+    state.lost.store(0, std::memory_order_relaxed);
+    state.enabled.store(true, std::memory_order_release);
+}
+
+inline void PtrTrace::stop() noexcept
+{
+    state().enabled.store(false, std::memory_order_release);
+}
+
+inline bool PtrTrace::recording() noexcept
+{
+    return state().enabled.load(std::memory_order_acquire);
+}
+
+inline void PtrTrace::record(const TracePointer pointer, const TraceKind kind, const void* const self,
+                             const void* const other, const std::size_t size) noexcept
+{
+    State& state = PtrTrace::state();
+    if (!state.enabled.load(std::memory_order_relaxed))
+        return;
+
+    try
+    {
+        PtrTraceLog& log = local();
+        TraceEvent event;
+        event.sequence = state.sequence.fetch_add(1, std::memory_order_relaxed);
+        event.self = reinterpret_cast<std::uintptr_t>(self);
+        event.other = reinterpret_cast<std::uintptr_t>(other);
+        event.size = static_cast<std::uint32_t>(size);
+        event.thread = log.thread;
+        event.kind = kind;
+        event.pointer = pointer;
+        log.events.push_back(event);
+    }
+    catch (...)
+    {
+        state.lost.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+inline std::vector<TraceEvent> PtrTrace::events()
+{
+    State& state = PtrTrace::state();
+    std::vector<TraceEvent> merged;
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        merged = state.finished;
+        for (const PtrTraceLog* thread : state.threads)
+            merged.insert(merged.end(), thread->events.begin(), thread->events.end());
+    }
+    std::sort(merged.begin(), merged.end(),
+              [](const TraceEvent& a, const TraceEvent& b) { return a.sequence < b.sequence; });
+    return merged;
+}
+
+inline std::size_t PtrTrace::lost() noexcept
+{
+    return state().lost.load(std::memory_order_relaxed);
+}
+
+inline const char* PtrTrace::magic() noexcept
+{
+    return "PTRTRC01";
+}
+
+inline void PtrTrace::save(const std::string& path, const std::vector<TraceEvent>& events)
+{
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr)
+        throw std::system_error(errno, std::generic_category(), "open " + path);
+
+    const std::uint64_t count = events.size();
+    bool written = std::fwrite(magic(), magic_size, 1, file) == 1 &&
+                   std::fwrite(&count, sizeof(count), 1, file) == 1 &&
+                   (count == 0 || std::fwrite(events.data(), sizeof(TraceEvent), count, file) == count);
+    const int error = errno;
+    if (std::fclose(file) != 0 || !written)
+        throw std::system_error(written ? errno : error, std::generic_category(), "write " + path);
+}
+
+inline std::vector<TraceEvent> PtrTrace::load(const std::string& path)
+{
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr)
+        throw std::system_error(errno, std::generic_category(), "open " + path);
+
+    char header[magic_size];
+    std::uint64_t count = 0;
+    std::vector<TraceEvent> events;
+    bool valid = std::fread(header, magic_size, 1, file) == 1 &&
+                 std::memcmp(header, magic(), magic_size) == 0 &&
+                 std::fread(&count, sizeof(count), 1, file) == 1;
+    // A corrupt count must not turn into a huge allocation.
+    struct stat status;
+    if (valid)
+        valid = fstat(fileno(file), &status) == 0 &&
+                count <= (static_cast<std::uint64_t>(status.st_size) - magic_size - sizeof(count)) / sizeof(TraceEvent);
+    if (valid)
+    {
+        events.resize(count);
+        valid = count == 0 || std::fread(events.data(), sizeof(TraceEvent), count, file) == count;
+    }
+    std::fclose(file);
+    if (!valid)
+        throw std::system_error(EINVAL, std::generic_category(), "not a pointer trace " + path);
+    return events;
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+enum class TraceKind : std::uint8_t
+{
+    create,
+    copy,
+    copy_assign,
+    move,
+    move_assign,
+    reset,
+    destroy
+};
+
+enum class TracePointer : std::uint8_t
+{
+    shared,
+    unique
+};
+
+// One ownership operation. self is the address of the smart pointer that
+// changed; other is the pointer it copied or moved from, or the new object
+// for create. Addresses only identify instances and are never followed.
+struct TraceEvent
+{
+    std::uint64_t sequence;
+    std::uint64_t self;
+    std::uint64_t other;
+    std::uint32_t size;
+    std::uint16_t thread;
+    TraceKind kind;
+    TracePointer pointer;
+};
+
+class PtrTraceLog
+{
+public:
+    std::vector<TraceEvent> events;
+    std::uint16_t thread;
+
+    PtrTraceLog();
+    PtrTraceLog(const PtrTraceLog&) = delete;
+    PtrTraceLog& operator=(const PtrTraceLog&) = delete;
+    ~PtrTraceLog();
+};
+
+// Collects ownership operations from instrumented builds. Each thread
+// appends to its own log; a global counter orders events across threads.
+// events() merges every log and start() clears them, so call either only
+// while the traced threads are idle or gone.
+class PtrTrace
+{
+public:
+    static void start();
+    static void stop() noexcept;
+    static bool recording() noexcept;
+    static void record(TracePointer pointer, TraceKind kind, const void* self, const void* other,
+                       std::size_t size) noexcept;
+
+    static std::vector<TraceEvent> events();
+    static std::size_t lost() noexcept;
+
+    // Native-endian file: an 8 byte magic, a 64-bit event count and the
+    // events in sequence order. Both throw std::system_error on I/O failure.
+    static void save(const std::string& path, const std::vector<TraceEvent>& events);
+    static std::vector<TraceEvent> load(const std::string& path);
+
+private:
+    struct State
+    {
+        std::mutex mutex;
+        std::atomic<bool> enabled{false};
+        std::atomic<std::uint64_t> sequence{0};
+        std::atomic<std::size_t> lost{0};
+        std::uint16_t next_thread = 0;
+        std::vector<PtrTraceLog*> threads;
+        std::vector<TraceEvent> finished;
+    };
+
+    static const std::size_t magic_size = 8;
+
+    static State& state() noexcept;
+    static PtrTraceLog& local();
+    static const char* magic() noexcept;
+
+    friend class PtrTraceLog;
+};
+
+#include "ptr_trace-inl.h"
@@ -0,0 +1,93 @@
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ptr_trace.h"
+#include "../shared_ptr/shared.h"
+#include "../unique_ptr/unique.h"
+
+
+// Sample workload for the instrumented build: a feed thread publishes
+// shared orders to two book threads, which keep some of them and build
+// short-lived scratch buffers. Writes a trace for replay_ptr_trace.
+struct Order
+{
+    long id;
+    double price;
+    char venue[48];
+};
+
+struct Scratch
+{
+    char bytes[512];
+};
+
+
+int main(int argc, char** argv)
+{
+    const std::string path = argc > 1 ? argv[1] : "ptr.trace";
+    const long orders = argc > 2 ? std::atol(argv[2]) : 100000;
+
+    std::mutex mutex;
+    std::deque<SharedPtr<Order>> queues[2];
+    bool done = false;
+
+    PtrTrace::start();
+    std::vector<std::thread> books;
+    for (int b = 0; b < 2; ++b)
+    {
+        books.emplace_back([&, b]() {
+            std::vector<SharedPtr<Order>> resting;
+            for (;;)
+            {
+                SharedPtr<Order> order;
+                bool finished = false;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!queues[b].empty())
+                    {
+                        order = std::move(queues[b].front());
+                        queues[b].pop_front();
+                    }
+                    finished = done && queues[b].empty();
+                }
+                if (!order)
+                {
+                    if (finished)
+                        break;
+                    std::this_thread::yield();
+                    continue;
+                }
+                UniquePtr<Scratch> scratch(new Scratch());
+                UniquePtr<Scratch> kept = std::move(scratch);
+                if (order->id % 3 == 0)
+                    resting.push_back(order);
+                if (resting.size() > 64)
+                    resting.erase(resting.begin(), resting.begin() + 32);
+            }
+        });
+    }
+
+    for (long i = 0; i < orders; ++i)
+    {
+        SharedPtr<Order> order(new Order{i, 100.0 + i % 50, "XNAS"});
+        std::lock_guard<std::mutex> lock(mutex);
+        queues[0].push_back(order);
+        queues[1].push_back(order);
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        done = true;
+    }
+    for (std::thread& book : books)
+        book.join();
+    PtrTrace::stop();
+
+    std::vector<TraceEvent> events = PtrTrace::events();
+    PtrTrace::save(path, events);
+    std::printf("wrote %zu events to %s (%zu lost)\n", events.size(), path.c_str(), PtrTrace::lost());
+    return 0;
+}
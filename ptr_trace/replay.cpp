@@ -0,0 +1,62 @@
+#include <cstdio>
+#include <cstdlib>
+#include <malloc.h>
+#include <new>
+#include <string>
+#include "ptr_replay.h"
+
+
+// Every allocation in this program feeds ReplayHeap, so the report covers
+// control blocks and anything else an implementation allocates.
+void* operator new(std::size_t size)
+{
+    void* memory = std::malloc(size ? size : 1);
+    if (memory == nullptr)
+        throw std::bad_alloc();
+    ReplayHeap::allocated(malloc_usable_size(memory));
+    return memory;
+}
+
+void operator delete(void* memory) noexcept
+{
+    if (memory == nullptr)
+        return;
+    ReplayHeap::freed(malloc_usable_size(memory));
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    operator delete(memory);
+}
+
+
+template <typename Pointers>
+void report(const ReplayProgram& program, int repeats)
+{
+    ReplayStats best = PtrReplay::run<Pointers>(program);
+    for (int i = 1; i < repeats; ++i)
+    {
+        ReplayStats stats = PtrReplay::run<Pointers>(program);
+        if (stats.seconds < best.seconds)
+            best = stats;
+    }
+    std::printf("%-28s %14.0f %12zu %12zu %14zu %14zu\n", Pointers::name(), best.operations / best.seconds,
+                best.allocations, best.peak_objects, best.peak_payload_bytes, best.peak_heap_bytes);
+}
+
+
+int main(int argc, char** argv)
+{
+    const std::string path = argc > 1 ? argv[1] : "ptr.trace";
+    const int repeats = argc > 2 ? std::atoi(argv[2]) : 3;
+
+    ReplayProgram program = PtrReplay::compile(PtrTrace::load(path));
+    std::printf("%s: %zu operations from %zu threads, %u shared and %u unique slots\n", path.c_str(),
+                program.ops.size(), program.threads, program.shared_slots, program.unique_slots);
+    std::printf("%-28s %14s %12s %12s %14s %14s\n", "", "ops/s", "allocations", "peak objects", "peak payload",
+                "peak heap");
+    report<RepoPointers>(program, repeats);
+    report<StdPointers>(program, repeats);
+    return 0;
+}
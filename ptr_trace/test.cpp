@@ -0,0 +1,154 @@
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "ptr_replay.h"
+
+
+struct Payload
+{
+    char bytes[100];
+};
+
+
+static std::vector<TraceKind> kinds(const std::vector<TraceEvent>& events)
+{
+    std::vector<TraceKind> result;
+    for (const TraceEvent& event : events)
+        result.push_back(event.kind);
+    return result;
+}
+
+
+TEST(PtrTraceTest, RecordsSharedPtrOperations)
+{
+    PtrTrace::start();
+    {
+        SharedPtr<Payload> first(new Payload());
+        SharedPtr<Payload> second(first);
+        SharedPtr<Payload> third(std::move(second));
+        second = third;
+        first.reset();
+    }
+    PtrTrace::stop();
+
+    std::vector<TraceEvent> events = PtrTrace::events();
+    EXPECT_EQ(kinds(events), (std::vector<TraceKind>{TraceKind::create, TraceKind::copy, TraceKind::move,
+                                                     TraceKind::copy_assign, TraceKind::reset, TraceKind::destroy,
+                                                     TraceKind::destroy}));
+    EXPECT_EQ(events[0].size, sizeof(Payload));
+    EXPECT_EQ(events[0].pointer, TracePointer::shared);
+    EXPECT_EQ(events[1].other, events[0].self);
+    for (std::size_t i = 1; i < events.size(); ++i)
+        EXPECT_EQ(events[i].sequence, events[i - 1].sequence + 1);
+}
+
+
+TEST(PtrTraceTest, RecordsUniquePtrOperations)
+{
+    PtrTrace::start();
+    {
+        UniquePtr<Payload> first(new Payload());
+        UniquePtr<Payload> second(std::move(first));
+        first = UniquePtr<Payload>(new Payload());
+        delete second.release();
+    }
+    PtrTrace::stop();
+
+    std::vector<TraceEvent> events = PtrTrace::events();
+    EXPECT_EQ(kinds(events), (std::vector<TraceKind>{TraceKind::create, TraceKind::move, TraceKind::create,
+                                                     TraceKind::move_assign, TraceKind::reset, TraceKind::destroy}));
+    EXPECT_EQ(events[0].pointer, TracePointer::unique);
+}
+
+
+TEST(PtrTraceTest, NothingIsRecordedWhileStopped)
+{
+    PtrTrace::start();
+    PtrTrace::stop();
+    SharedPtr<Payload> ignored(new Payload());
+    EXPECT_TRUE(PtrTrace::events().empty());
+}
+
+
+TEST(PtrTraceTest, KeepsEventsOfFinishedThreads)
+{
+    PtrTrace::start();
+    SharedPtr<Payload> shared(new Payload());
+    std::thread worker([&]() { SharedPtr<Payload> copy(shared); });
+    worker.join();
+    PtrTrace::stop();
+
+    std::vector<TraceEvent> events = PtrTrace::events();
+    ASSERT_EQ(events.size(), 3u);
+    EXPECT_NE(events[0].thread, events[1].thread);
+    EXPECT_EQ(events[1].thread, events[2].thread);
+}
+
+
+TEST(PtrTraceTest, SaveAndLoadRoundTrip)
+{
+    PtrTrace::start();
+    {
+        SharedPtr<Payload> first(new Payload());
+        SharedPtr<Payload> second(first);
+    }
+    PtrTrace::stop();
+    std::vector<TraceEvent> events = PtrTrace::events();
+
+    const std::string path = "ptr_trace_test.trace";
+    PtrTrace::save(path, events);
+    std::vector<TraceEvent> loaded = PtrTrace::load(path);
+    std::remove(path.c_str());
+
+    ASSERT_EQ(loaded.size(), events.size());
+    for (std::size_t i = 0; i < events.size(); ++i)
+    {
+        EXPECT_EQ(loaded[i].sequence, events[i].sequence);
+        EXPECT_EQ(loaded[i].self, events[i].self);
+        EXPECT_EQ(loaded[i].kind, events[i].kind);
+    }
+    EXPECT_THROW(PtrTrace::load("missing.trace"), std::system_error);
+
+    // A count far beyond the file's size is rejected before allocating.
+    PtrTrace::save(path, events);
+    std::FILE* file = std::fopen(path.c_str(), "r+b");
+    ASSERT_NE(file, nullptr);
+    const std::uint64_t huge = std::uint64_t(1) << 60;
+    std::fseek(file, 8, SEEK_SET);
+    std::fwrite(&huge, sizeof(huge), 1, file);
+    std::fclose(file);
+    EXPECT_THROW(PtrTrace::load(path), std::system_error);
+    std::remove(path.c_str());
+}
+
+
+TEST(PtrReplayTest, ReplayReproducesObjectLifetimes)
+{
+    PtrTrace::start();
+    {
+        std::vector<SharedPtr<Payload>> held;
+        for (int i = 0; i < 10; ++i)
+        {
+            SharedPtr<Payload> made(new Payload());
+            held.push_back(made);
+            UniquePtr<Payload> scratch(new Payload());
+        }
+        held.erase(held.begin(), held.begin() + 5);
+    }
+    PtrTrace::stop();
+
+    ReplayProgram program = PtrReplay::compile(PtrTrace::events());
+    EXPECT_EQ(program.threads, 1u);
+    EXPECT_EQ(program.unique_slots, 1u);
+
+    ReplayStats repo = PtrReplay::run<RepoPointers>(program);
+    ReplayStats standard = PtrReplay::run<StdPointers>(program);
+    EXPECT_EQ(repo.objects, 20u);
+    EXPECT_EQ(standard.objects, 20u);
+    EXPECT_EQ(repo.peak_objects, 11u);
+    EXPECT_EQ(standard.peak_objects, 11u);
+    EXPECT_EQ(repo.peak_payload_bytes, 11 * sizeof(Payload));
+    EXPECT_EQ(Blob::counters().live, 0u);
+}
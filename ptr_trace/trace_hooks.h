@@ -0,0 +1,11 @@
+#pragma once
+
+// Building with SMART_PTR_TRACE defined makes SharedPtr and UniquePtr log
+// every ownership operation to PtrTrace. Without it the hooks compile away.
+#ifdef SMART_PTR_TRACE
+#include "ptr_trace.h"
+#define PTR_TRACE(pointer, kind, self, other, size) \
+    PtrTrace::record(TracePointer::pointer, TraceKind::kind, self, other, size)
+#else
+#define PTR_TRACE(pointer, kind, self, other, size) ((void)0)
+#endif
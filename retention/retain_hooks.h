@@ -0,0 +1,12 @@
+#pragma once
+
+// Building with SMART_PTR_RETAIN defined makes SharedPtr keep RetainRegistry
+// up to date with every live instance and the object it holds. Without it
+// the hooks compile away.
+#ifdef SMART_PTR_RETAIN
+#include <typeinfo>
+#include "retention.h"
+#define PTR_RETAIN(kind, ...) RetainRegistry::kind(__VA_ARGS__)
+#else
+#define PTR_RETAIN(kind, ...) ((void)0)
+#endif
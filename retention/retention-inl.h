@@ -0,0 +1,261 @@
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <iterator>
+#include <cxxabi.h>
+
+inline RetainRegistry::State& RetainRegistry::state()
+{
+    // Never destroyed: SharedPtrs with static storage outlive it otherwise.
+    static State& state = *new State();
+    return state;
+}
+
+inline void RetainRegistry::object(const void* const control, const void* const address, const std::size_t size,
+                                   const char* const type) noexcept
+{
+    State& state = RetainRegistry::state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    try
+    {
+        state.objects[control] = Object{state.next_id++, address, size, type};
+        state.object_starts[reinterpret_cast<std::uintptr_t>(address)] = control;
+    }
+    catch (...)
+    {
+        state.objects.erase(control);
+    }
+}
+
+inline void RetainRegistry::hold(const void* const holder, const void* const control) noexcept
+{
+    State& state = RetainRegistry::state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    try
+    {
+        state.holders[holder] = control;
+    }
+    catch (...)
+    {
+    }
+}
+
+inline void RetainRegistry::drop(const void* const holder) noexcept
+{
+    State& state = RetainRegistry::state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.holders.erase(holder);
+}
+
+inline void RetainRegistry::release(const void* const control) noexcept
+{
+    State& state = RetainRegistry::state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    auto found = state.objects.find(control);
+    if (found == state.objects.end())
+        return;
+
+    const std::uintptr_t start = reinterpret_cast<std::uintptr_t>(found->second.address);
+    auto first = state.object_starts.find(start);
+    if (first != state.object_starts.end() && first->second == control)
+        state.object_starts.erase(first);
+    state.labels.erase(found->second.address);
+    state.objects.erase(found);
+}
+
+inline void RetainRegistry::contain(const void* const owner, const void* const begin, const std::size_t size)
+{
+    State& state = RetainRegistry::state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    const std::uintptr_t start = reinterpret_cast<std::uintptr_t>(begin);
+    state.regions[start] = Region{start + size, owner};
+}
+
+inline void RetainRegistry::uncontain(const void* const begin) noexcept
+{
+    State& state = RetainRegistry::state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.regions.erase(reinterpret_cast<std::uintptr_t>(begin));
+}
+
+inline void RetainRegistry::label(const void* const address, const std::string& name)
+{
+    State& state = RetainRegistry::state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.labels[address] = name;
+}
+
+inline const void* RetainRegistry::control_of(const State& state, const void* const address) noexcept
+{
+    const std::uintptr_t at = reinterpret_cast<std::uintptr_t>(address);
+    auto next = state.object_starts.upper_bound(at);
+    if (next == state.object_starts.begin())
+        return nullptr;
+    const void* control = std::prev(next)->second;
+    const Object& object = state.objects.at(control);
+    const std::uintptr_t start = reinterpret_cast<std::uintptr_t>(object.address);
+    return at < start + (object.size ? object.size : 1) ? control : nullptr;
+}
+
+inline const void* RetainRegistry::owner_of(const State& state, const void* const holder) noexcept
+{
+    // Explicit containment wins: a region is registered precisely because
+    // the address alone does not tell.
+    const std::uintptr_t at = reinterpret_cast<std::uintptr_t>(holder);
+    auto next = state.regions.upper_bound(at);
+    if (next != state.regions.begin() && at < std::prev(next)->second.end)
+        return control_of(state, std::prev(next)->second.owner);
+    return control_of(state, holder);
+}
+
+inline std::string RetainRegistry::name_of(const State& state, const void* const address)
+{
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%p", address);
+    auto label = state.labels.find(address);
+    if (label != state.labels.end())
+        return label->second + " (" + buffer + ")";
+
+    const void* control = control_of(state, address);
+    if (!control)
+        return buffer;
+
+    const char* type = state.objects.at(control).type;
+    int status = 0;
+    char* readable = abi::__cxa_demangle(type, nullptr, nullptr, &status);
+    std::string name = (status == 0 ? readable : type) + std::string(" ") + buffer;
+    std::free(readable);
+    return name;
+}
+
+inline std::vector<RetainHolder> RetainRegistry::holders(const void* const object)
+{
+    State& state = RetainRegistry::state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    std::vector<RetainHolder> result;
+    const void* control = control_of(state, object);
+    if (!control)
+        return result;
+
+    for (const auto& entry : state.holders)
+    {
+        if (entry.second != control)
+            continue;
+        const void* owner = owner_of(state, entry.first);
+        result.push_back(RetainHolder{entry.first, owner ? state.objects.at(owner).address : nullptr});
+    }
+    return result;
+}
+
+inline std::vector<RetentionPath> RetainRegistry::paths(const void* const object)
+{
+    State& state = RetainRegistry::state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    std::vector<RetentionPath> result;
+    const void* target = control_of(state, object);
+    if (!target)
+        return result;
+
+    std::unordered_map<const void*, std::vector<const void*>> held_by;
+    for (const auto& entry : state.holders)
+        held_by[entry.second].push_back(entry.first);
+
+    // Breadth-first from the target towards the roots; next_hop records, for
+    // each reached object, the holder and object one step closer to it.
+    struct Hop
+    {
+        const void* holder;
+        const void* control;
+    };
+    std::unordered_map<const void*, Hop> next_hop;
+    next_hop[target] = Hop{nullptr, nullptr};
+    std::deque<const void*> queue(1, target);
+    while (!queue.empty())
+    {
+        const void* control = queue.front();
+        queue.pop_front();
+        for (const void* holder : held_by[control])
+        {
+            const void* owner = owner_of(state, holder);
+            if (owner)
+            {
+                if (next_hop.emplace(owner, Hop{holder, control}).second)
+                    queue.push_back(owner);
+                continue;
+            }
+
+            RetentionPath path(1, RetainLink{holder, state.objects.at(control).address});
+            for (Hop hop = next_hop[control]; hop.holder; hop = next_hop[hop.control])
+                path.push_back(RetainLink{hop.holder, state.objects.at(hop.control).address});
+            result.push_back(path);
+        }
+    }
+    return result;
+}
+
+inline std::string RetainRegistry::describe(const RetentionPath& path)
+{
+    State& state = RetainRegistry::state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    std::string text;
+    for (std::size_t i = 0; i < path.size(); ++i)
+    {
+        char holder[32];
+        std::snprintf(holder, sizeof(holder), "%p", path[i].holder);
+        if (i == 0)
+            text += "root " + name_of(state, path[i].holder);
+        else
+            text += std::string(" .") + holder;
+        text += " -> " + name_of(state, path[i].object);
+    }
+    return text;
+}
+
+inline RetainSnapshot RetainRegistry::snapshot()
+{
+    State& state = RetainRegistry::state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    std::unordered_map<const void*, std::size_t> counts;
+    for (const auto& entry : state.holders)
+        ++counts[entry.second];
+
+    RetainSnapshot snapshot;
+    for (const auto& entry : state.objects)
+    {
+        const Object& object = entry.second;
+        snapshot.objects[object.id] = RetainedObject{object.id, object.address, object.size, object.type,
+                                                     counts[entry.first]};
+    }
+    return snapshot;
+}
+
+inline RetainDiff RetainRegistry::diff(const RetainSnapshot& before, const RetainSnapshot& after)
+{
+    RetainDiff diff;
+    for (const auto& entry : after.objects)
+    {
+        if (before.objects.count(entry.first))
+            continue;
+        diff.added.push_back(entry.second);
+        RetainTypeDelta& delta = diff.by_type[entry.second.type];
+        delta.objects += 1;
+        delta.bytes += static_cast<long>(entry.second.size);
+    }
+    for (const auto& entry : before.objects)
+    {
+        if (after.objects.count(entry.first))
+            continue;
+        diff.removed.push_back(entry.second);
+        RetainTypeDelta& delta = diff.by_type[entry.second.type];
+        delta.objects -= 1;
+        delta.bytes -= static_cast<long>(entry.second.size);
+    }
+    return diff;
+}
+
+inline std::size_t RetainRegistry::live_holders()
+{
+    State& state = RetainRegistry::state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    return state.holders.size();
+}
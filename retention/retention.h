@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// A SharedPtr instance and the object that memory containing it belongs
+// to, or null when nothing registered contains it (a stack, global or
+// otherwise unowned pointer: a root).
+struct RetainHolder
+{
+    const void* holder;
+    const void* owner;
+};
+
+// One reference along a retention path: holder points at object.
+struct RetainLink
+{
+    const void* holder;
+    const void* object;
+};
+
+// Path from a root holder to the queried object. Every link's holder lies
+// inside the previous link's object.
+typedef std::vector<RetainLink> RetentionPath;
+
+struct RetainedObject
+{
+    std::uint64_t id;
+    const void* address;
+    std::size_t size;
+    const char* type;
+    std::size_t holders;
+};
+
+struct RetainTypeDelta
+{
+    long objects;
+    long bytes;
+};
+
+// Objects are matched by registration id, so an address reused by a new
+// object shows up as one removal and one addition.
+struct RetainSnapshot
+{
+    std::map<std::uint64_t, RetainedObject> objects;
+};
+
+struct RetainDiff
+{
+    std::vector<RetainedObject> added;
+    std::vector<RetainedObject> removed;
+    std::map<std::string, RetainTypeDelta> by_type;
+};
+
+// Debug registry of live SharedPtr instances, fed by the hooks in SharedPtr
+// when built with SMART_PTR_RETAIN. It knows which control block each
+// instance holds and the address range of each managed object, so a holder
+// that sits inside a managed object is known to be owned by it. Holders in
+// memory the registry cannot see into, such as a container's heap buffer,
+// are attributed to an owner with contain(). Queries take any address
+// inside the object of interest.
+class RetainRegistry
+{
+public:
+    // Hook entry points. A registration that cannot be stored for lack of
+    // memory is dropped, which only makes later answers less complete.
+    static void object(const void* control, const void* address, std::size_t size, const char* type) noexcept;
+    static void hold(const void* holder, const void* control) noexcept;
+    static void drop(const void* holder) noexcept;
+    static void release(const void* control) noexcept;
+
+    // Holders in [begin, begin + size) are owned by the object at owner.
+    static void contain(const void* owner, const void* begin, std::size_t size);
+    static void uncontain(const void* begin) noexcept;
+    // Name used for an object or a root holder by describe().
+    static void label(const void* address, const std::string& name);
+
+    static std::vector<RetainHolder> holders(const void* object);
+    // Shortest path from each root that keeps object alive. Empty while
+    // object is held only from inside a cycle of unreachable objects.
+    static std::vector<RetentionPath> paths(const void* object);
+    static std::string describe(const RetentionPath& path);
+
+    static RetainSnapshot snapshot();
+    static RetainDiff diff(const RetainSnapshot& before, const RetainSnapshot& after);
+    static std::size_t live_holders();
+
+private:
+    struct Object
+    {
+        std::uint64_t id;
+        const void* address;
+        std::size_t size;
+        const char* type;
+    };
+
+    struct Region
+    {
+        std::uintptr_t end;
+        const void* owner;
+    };
+
+    struct State
+    {
+        std::mutex mutex;
+        std::uint64_t next_id = 0;
+        std::unordered_map<const void*, const void*> holders;
+        std::unordered_map<const void*, Object> objects;
+        std::map<std::uintptr_t, const void*> object_starts;
+        std::map<std::uintptr_t, Region> regions;
+        std::unordered_map<const void*, std::string> labels;
+    };
+
+    static State& state();
+    static const void* control_of(const State& state, const void* address) noexcept;
+    static const void* owner_of(const State& state, const void* holder) noexcept;
+    static std::string name_of(const State& state, const void* address);
+};
+
+#include "retention-inl.h"
@@ -0,0 +1,131 @@
+#include <string>
+#include <typeinfo>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../shared_ptr/shared.h"
+
+
+struct Blob
+{
+    char bytes[64];
+};
+
+struct Cache
+{
+    std::vector<SharedPtr<Blob>> entries;
+};
+
+struct Session
+{
+    SharedPtr<Cache> cache;
+};
+
+struct Peer
+{
+    SharedPtr<Peer> other;
+};
+
+
+TEST(RetainRegistryTest, ListsHoldersAndTheirOwners)
+{
+    const std::size_t baseline = RetainRegistry::live_holders();
+    {
+        SharedPtr<Cache> root = MakeShared<Cache>();
+        SharedPtr<Session> session = MakeShared<Session>();
+        session->cache = root;
+
+        std::vector<RetainHolder> holders = RetainRegistry::holders(root.get());
+        ASSERT_EQ(holders.size(), 2u);
+        for (const RetainHolder& holder : holders)
+        {
+            if (holder.holder == &root)
+                EXPECT_EQ(holder.owner, nullptr);
+            else
+            {
+                EXPECT_EQ(holder.holder, &session->cache);
+                EXPECT_EQ(holder.owner, session.get());
+            }
+        }
+        EXPECT_EQ(RetainRegistry::live_holders(), baseline + 3);
+    }
+    EXPECT_EQ(RetainRegistry::live_holders(), baseline);
+}
+
+
+TEST(RetainRegistryTest, FollowsContainmentEdgesToRoots)
+{
+    SharedPtr<Session> session = MakeShared<Session>();
+    session->cache = MakeShared<Cache>();
+    session->cache->entries.resize(4);
+    session->cache->entries[2] = MakeShared<Blob>();
+    SharedPtr<Blob> blob = session->cache->entries[2];
+    blob.reset();
+
+    // The vector buffer is invisible to the registry until attributed to
+    // the Cache that owns it.
+    std::vector<SharedPtr<Blob>>& entries = session->cache->entries;
+    const Blob* target = entries[2].get();
+    EXPECT_EQ(RetainRegistry::holders(target)[0].owner, nullptr);
+
+    RetainRegistry::contain(session->cache.get(), entries.data(), entries.size() * sizeof(entries[0]));
+    RetainRegistry::label(&session, "session");
+
+    std::vector<RetentionPath> paths = RetainRegistry::paths(target);
+    ASSERT_EQ(paths.size(), 1u);
+    const RetentionPath& path = paths[0];
+    ASSERT_EQ(path.size(), 3u);
+    EXPECT_EQ(path[0].holder, &session);
+    EXPECT_EQ(path[0].object, session.get());
+    EXPECT_EQ(path[1].holder, &session->cache);
+    EXPECT_EQ(path[1].object, session->cache.get());
+    EXPECT_EQ(path[2].holder, &entries[2]);
+    EXPECT_EQ(path[2].object, target);
+
+    const std::string text = RetainRegistry::describe(path);
+    EXPECT_EQ(text.find("root session"), 0u);
+    EXPECT_NE(text.find("Blob"), std::string::npos);
+
+    RetainRegistry::uncontain(entries.data());
+    EXPECT_EQ(RetainRegistry::paths(target)[0].size(), 1u);
+}
+
+
+TEST(RetainRegistryTest, CycleHasHoldersButNoPath)
+{
+    SharedPtr<Peer> a = MakeShared<Peer>();
+    SharedPtr<Peer> b = MakeShared<Peer>();
+    a->other = b;
+    b->other = a;
+    Peer* leaked = a.get();
+
+    // Directly from a, and from b through b->other.
+    EXPECT_EQ(RetainRegistry::paths(leaked).size(), 2u);
+    a.reset();
+    b.reset();
+    EXPECT_EQ(RetainRegistry::holders(leaked).size(), 1u);
+    EXPECT_TRUE(RetainRegistry::paths(leaked).empty());
+
+    leaked->other->other.reset();
+}
+
+
+TEST(RetainRegistryTest, SnapshotDiffReportsGrowthByType)
+{
+    SharedPtr<Blob> kept = MakeShared<Blob>();
+    SharedPtr<Blob> dropped(new Blob());
+    const RetainSnapshot before = RetainRegistry::snapshot();
+
+    dropped.reset();
+    std::vector<SharedPtr<Blob>> grown;
+    for (int i = 0; i < 3; ++i)
+        grown.push_back(MakeShared<Blob>());
+    SharedPtr<Cache> cache = MakeShared<Cache>();
+
+    const RetainDiff diff = RetainRegistry::diff(before, RetainRegistry::snapshot());
+    EXPECT_EQ(diff.added.size(), 4u);
+    ASSERT_EQ(diff.removed.size(), 1u);
+    EXPECT_EQ(diff.removed[0].holders, 1u);
+    EXPECT_EQ(diff.by_type.at(typeid(Blob).name()).objects, 2);
+    EXPECT_EQ(diff.by_type.at(typeid(Blob).name()).bytes, static_cast<long>(2 * sizeof(Blob)));
+    EXPECT_EQ(diff.by_type.at(typeid(Cache).name()).objects, 1);
+}
@@ -0,0 +1,104 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "rw_lock.h"
+
+
+typedef std::unordered_map<int, int> Registry;
+
+
+struct StdLock
+{
+    std::shared_mutex mutex;
+
+    template <typename Func>
+    void read(Func func)
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        func();
+    }
+
+    template <typename Func>
+    void write(Func func)
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        func();
+    }
+};
+
+
+struct ScalableLock
+{
+    ScalableRwLock lock;
+
+    template <typename Func>
+    void read(Func func)
+    {
+        SharedGuard guard(lock);
+        func();
+    }
+
+    template <typename Func>
+    void write(Func func)
+    {
+        std::lock_guard<ScalableRwLock> guard(lock);
+        func();
+    }
+};
+
+
+template <typename Lock>
+double run(int threads, long operations, int write_percent)
+{
+    Lock lock;
+    Registry registry;
+    for (int i = 0; i < 1024; ++i)
+        registry[i] = i;
+
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&, t]() {
+            unsigned seed = static_cast<unsigned>(t) * 2654435761u + 1;
+            long sum = 0;
+            for (long i = 0; i < operations; ++i)
+            {
+                seed = seed * 1664525u + 1013904223u;
+                const int key = static_cast<int>(seed >> 8) & 1023;
+                if (static_cast<int>((seed >> 20) % 100) < write_percent)
+                    lock.write([&]() { ++registry[key]; });
+                else
+                    lock.read([&]() { sum += registry.find(key)->second; });
+            }
+            if (sum == 42)
+                std::printf(" ");
+        });
+    }
+    for (std::thread& worker : workers)
+        worker.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return static_cast<double>(operations) * threads / seconds;
+}
+
+
+int main(int argc, char** argv)
+{
+    const int max_threads = argc > 1 ? std::atoi(argv[1]) : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    const long operations = argc > 2 ? std::atol(argv[2]) : 2000000;
+    const int write_percent = argc > 3 ? std::atoi(argv[3]) : 1;
+
+    std::printf("%d%% writes, %ld operations per thread\n", write_percent, operations);
+    std::printf("%8s %20s %20s\n", "threads", "shared_mutex ops/s", "ScalableRwLock ops/s");
+    for (int threads = 1; threads <= max_threads; threads *= 2)
+    {
+        double baseline = run<StdLock>(threads, operations, write_percent);
+        double scalable = run<ScalableLock>(threads, operations, write_percent);
+        std::printf("%8d %20.0f %20.0f\n", threads, baseline, scalable);
+    }
+    return 0;
+}
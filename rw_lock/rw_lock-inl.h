@@ -0,0 +1,106 @@
+#include <algorithm>
+#include <thread>
+#include <sched.h>
+
+inline ScalableRwLock::Counter::Counter() noexcept
+    : readers(0)
+{}
+
+inline ScalableRwLock::ScalableRwLock(std::size_t slots)
+    : writer(false)
+{
+    if (slots == 0)
+        slots = std::max(1u, std::thread::hardware_concurrency());
+    counters = std::vector<Counter>(slots);
+}
+
+inline std::size_t ScalableRwLock::current_slot() const noexcept
+{
+    int cpu = sched_getcpu();
+    return cpu < 0 ? 0 : static_cast<std::size_t>(cpu) % counters.size();
+}
+
+inline std::size_t ScalableRwLock::lock_shared() noexcept
+{
+    std::size_t slot;
+    while (!try_lock_shared(slot))
+    {
+        while (writer.load(std::memory_order_relaxed))
+            std::this_thread::yield();
+    }
+    return slot;
+}
+
+inline bool ScalableRwLock::try_lock_shared(std::size_t& slot) noexcept
+{
+    slot = current_slot();
+    std::atomic<long>& readers = counters[slot].readers;
+
+    // Pairs with the writer's flag store and counter loads: either the
+    // writer sees this increment or this reader sees the flag.
+    readers.fetch_add(1, std::memory_order_seq_cst);
+    if (!writer.load(std::memory_order_seq_cst))
+        return true;
+    readers.fetch_sub(1, std::memory_order_release);
+    return false;
+}
+
+inline void ScalableRwLock::unlock_shared(const std::size_t slot) noexcept
+{
+    counters[slot].readers.fetch_sub(1, std::memory_order_release);
+}
+
+inline void ScalableRwLock::wait_for_readers() const noexcept
+{
+    for (const Counter& counter : counters)
+    {
+        while (counter.readers.load(std::memory_order_seq_cst) != 0)
+            std::this_thread::yield();
+    }
+}
+
+inline void ScalableRwLock::lock()
+{
+    writers.lock();
+    writer.store(true, std::memory_order_seq_cst);
+    wait_for_readers();
+}
+
+inline bool ScalableRwLock::try_lock()
+{
+    if (!writers.try_lock())
+        return false;
+
+    writer.store(true, std::memory_order_seq_cst);
+    for (const Counter& counter : counters)
+    {
+        if (counter.readers.load(std::memory_order_seq_cst) != 0)
+        {
+            unlock();
+            return false;
+        }
+    }
+    return true;
+}
+
+inline void ScalableRwLock::unlock() noexcept
+{
+    writer.store(false, std::memory_order_release);
+    writers.unlock();
+}
+
+inline std::size_t ScalableRwLock::slots() const noexcept
+{
+    return counters.size();
+}
+
+inline SharedGuard::SharedGuard(ScalableRwLock& lock) noexcept
+    : lock(lock)
+{
+    slot = lock.lock_shared();
+}
+
+inline SharedGuard::~SharedGuard() noexcept
+{
+    lock.unlock_shared(slot);
+}
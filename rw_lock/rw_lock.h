@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+// Big-reader lock: every reader increments the counter of the CPU it runs
+// on, so readers on different cores never write the same cache line. A
+// writer raises a flag that turns new readers away and then waits until
+// every per-CPU counter has drained. Readers get back the slot they counted
+// on and must hand it to unlock_shared, since the thread may have migrated.
+class ScalableRwLock
+{
+private:
+    struct alignas(128) Counter
+    {
+        std::atomic<long> readers;
+
+        Counter() noexcept;
+    };
+
+    std::vector<Counter> counters;
+    std::atomic<bool> writer;
+    std::mutex writers;
+
+    std::size_t current_slot() const noexcept;
+    void wait_for_readers() const noexcept;
+
+public:
+    explicit ScalableRwLock(std::size_t slots = 0);
+    ScalableRwLock(const ScalableRwLock&) = delete;
+    ScalableRwLock& operator=(const ScalableRwLock&) = delete;
+
+    std::size_t lock_shared() noexcept;
+    bool try_lock_shared(std::size_t& slot) noexcept;
+    void unlock_shared(std::size_t slot) noexcept;
+    void lock();
+    bool try_lock();
+    void unlock() noexcept;
+
+    std::size_t slots() const noexcept;
+};
+
+class SharedGuard
+{
+private:
+    ScalableRwLock& lock;
+    std::size_t slot;
+
+public:
+    explicit SharedGuard(ScalableRwLock& lock) noexcept;
+    SharedGuard(const SharedGuard&) = delete;
+    SharedGuard& operator=(const SharedGuard&) = delete;
+    ~SharedGuard() noexcept;
+};
+
+#include "rw_lock-inl.h"
@@ -0,0 +1,80 @@
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "rw_lock.h"
+
+
+TEST(ScalableRwLockTest, ReadersShareTheLock)
+{
+    ScalableRwLock lock(4);
+    std::size_t first = lock.lock_shared();
+    std::size_t second;
+    EXPECT_TRUE(lock.try_lock_shared(second));
+    EXPECT_FALSE(lock.try_lock());
+
+    lock.unlock_shared(first);
+    lock.unlock_shared(second);
+    EXPECT_TRUE(lock.try_lock());
+    lock.unlock();
+}
+
+
+TEST(ScalableRwLockTest, WriterExcludesReaders)
+{
+    ScalableRwLock lock(4);
+    lock.lock();
+
+    std::size_t slot;
+    EXPECT_FALSE(lock.try_lock_shared(slot));
+    EXPECT_FALSE(lock.try_lock());
+
+    lock.unlock();
+    EXPECT_TRUE(lock.try_lock_shared(slot));
+    lock.unlock_shared(slot);
+}
+
+
+TEST(ScalableRwLockTest, DefaultsToOneSlotPerCpu)
+{
+    ScalableRwLock lock;
+    EXPECT_EQ(lock.slots(), static_cast<std::size_t>(std::max(1u, std::thread::hardware_concurrency())));
+}
+
+
+TEST(ScalableRwLockTest, ReadersNeverSeeHalfWrites)
+{
+    ScalableRwLock lock(8);
+    long first = 0;
+    long second = 0;
+    std::atomic<long> torn(0);
+
+    auto reader = [&]() {
+        for (int i = 0; i < 20000; ++i)
+        {
+            SharedGuard guard(lock);
+            if (first != second)
+                torn.fetch_add(1);
+        }
+    };
+    auto writer = [&]() {
+        for (int i = 0; i < 2000; ++i)
+        {
+            std::lock_guard<ScalableRwLock> guard(lock);
+            ++first;
+            std::this_thread::yield();
+            ++second;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.emplace_back(writer);
+    threads.emplace_back(writer);
+    for (int i = 0; i < 3; ++i)
+        threads.emplace_back(reader);
+    for (std::thread& thread : threads)
+        thread.join();
+
+    EXPECT_EQ(torn.load(), 0);
+    EXPECT_EQ(first, 4000);
+    EXPECT_EQ(second, 4000);
+}
@@ -0,0 +1,73 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+#include "shared.h"
+
+
+struct Widget
+{
+    long value = 0;
+};
+
+struct WidgetBase
+{
+    long value = 0;
+};
+
+struct DerivedWidget : WidgetBase
+{
+    long extra = 0;
+};
+
+struct WidgetDeleter
+{
+    void operator()(Widget* widget) const noexcept { delete widget; }
+};
+
+
+template <typename Pointer, typename Make>
+double destroy_ns(std::size_t count, int rounds, Make make)
+{
+    double best = 1e30;
+    for (int round = 0; round < rounds; ++round)
+    {
+        std::vector<Pointer> pointers;
+        pointers.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+            pointers.push_back(make());
+
+        auto start = std::chrono::steady_clock::now();
+        pointers.clear();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (seconds < best)
+            best = seconds;
+    }
+    return best * 1e9 / static_cast<double>(count);
+}
+
+
+int main(int argc, char** argv)
+{
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const int rounds = argc > 2 ? std::atoi(argv[2]) : 5;
+
+    std::printf("%zu pointers, best of %d rounds; last-release cost in ns\n", count, rounds);
+    std::printf("%-32s %10s\n", "construction", "destroy");
+    std::printf("%-32s %10.1f\n", "MakeShared<Widget>",
+                destroy_ns<SharedPtr<Widget>>(count, rounds, []() { return MakeShared<Widget>(); }));
+    std::printf("%-32s %10.1f\n", "SharedPtr<Widget>(new Widget)",
+                destroy_ns<SharedPtr<Widget>>(count, rounds, []() { return SharedPtr<Widget>(new Widget()); }));
+    std::printf("%-32s %10.1f\n", "SharedPtr<Base>(new Derived)",
+                destroy_ns<SharedPtr<WidgetBase>>(count, rounds, []() { return SharedPtr<WidgetBase>(new DerivedWidget()); }));
+    std::printf("%-32s %10.1f\n", "SharedPtr<void>(new Widget)",
+                destroy_ns<SharedPtr<void>>(count, rounds, []() { return SharedPtr<void>(new Widget()); }));
+    std::printf("%-32s %10.1f\n", "SharedPtr<Widget>(p, deleter)",
+                destroy_ns<SharedPtr<Widget>>(count, rounds, []() { return SharedPtr<Widget>(new Widget(), WidgetDeleter()); }));
+    std::printf("%-32s %10.1f\n", "std::make_shared<Widget>",
+                destroy_ns<std::shared_ptr<Widget>>(count, rounds, []() { return std::make_shared<Widget>(); }));
+    std::printf("%-32s %10.1f\n", "std::shared_ptr<void>",
+                destroy_ns<std::shared_ptr<void>>(count, rounds, []() { return std::shared_ptr<void>(new Widget()); }));
+    return 0;
+}
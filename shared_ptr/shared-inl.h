@@ -1,45 +1,235 @@
+#include <new>
+#include <utility>
+
+template <typename U, typename Deleter>
+PointerControl<U, Deleter>::PointerControl(U* const pointer, const Deleter& deleter) : deleter(deleter)
+{
+    count.store(1, std::memory_order_relaxed);
+    destroy = &PointerControl::destroy_block;
+    this->pointer = pointer;
+}
+
+template <typename U, typename Deleter>
+void PointerControl<U, Deleter>::destroy_block(SharedControl* const control) noexcept
+{
+    PointerControl* block = static_cast<PointerControl*>(control);
+    if (block->pointer)
+        block->deleter(block->pointer);
+    delete block;
+}
+
+template <typename T, typename... Args>
+T* NewAlloc::create(Args&&... args)
+{
+    return new T(std::forward<Args>(args)...);
+}
+
+template <typename T>
+void NewAlloc::destroy(T* const pointer) noexcept
+{
+    delete pointer;
+}
+
+template <typename U, typename Alloc>
+InlineControl<U, Alloc>::InlineControl() noexcept
+{
+    count.store(1, std::memory_order_relaxed);
+    destroy = &InlineControl::destroy_block;
+}
+
+template <typename U, typename Alloc>
+U* InlineControl<U, Alloc>::object() noexcept
+{
+    return reinterpret_cast<U*>(&storage);
+}
+
+template <typename U, typename Alloc>
+void InlineControl<U, Alloc>::destroy_block(SharedControl* const control) noexcept
+{
+    InlineControl* block = static_cast<InlineControl*>(control);
+    block->object()->~U();
+    Alloc::destroy(block);
+}
+
+template <typename T, bool IsVoid>
+void SharedRelease<T, IsVoid>::destroy(SharedControl* const control) noexcept
+{
+    // The two blocks a SharedPtr<T> builds for itself are recognised and
+    // called directly, so the common release is inlined; converted and
+    // custom-deleter blocks take the indirect call.
+    if (control->destroy == &InlineControl<T, SmallAlloc>::destroy_block)
+        InlineControl<T, SmallAlloc>::destroy_block(control);
+    else if (control->destroy == &PointerControl<T, DefaultDelete<T>>::destroy_block)
+        PointerControl<T, DefaultDelete<T>>::destroy_block(control);
+    else
+        control->destroy(control);
+}
+
+template <typename T>
+void SharedRelease<T, true>::destroy(SharedControl* const control) noexcept
+{
+    control->destroy(control);
+}
+
 template <typename T>
 SharedPtr<T>::SharedPtr() noexcept
 {
     this->pointer = nullptr;
-    count = new std::atomic<int>(0);
+    control = nullptr;
+}
+
+template <typename T>
+SharedPtr<T>::SharedPtr(T* const pointer) : SharedPtr(pointer, DefaultDelete<T>())
+{
+    static_assert(!std::is_void<T>::value, "SharedPtr<void> must be built from a typed pointer");
 }
 
 template <typename T>
-SharedPtr<T>::SharedPtr(T* const pointer) noexcept
+template <typename U>
+SharedPtr<T>::SharedPtr(U* const pointer) : SharedPtr(pointer, DefaultDelete<U>())
 {
+}
+
+template <typename T>
+template <typename U, typename Deleter>
+SharedPtr<T>::SharedPtr(U* const pointer, Deleter deleter)
+{
+    static_assert(std::is_convertible<U*, T*>::value, "SharedPtr<T> needs a pointer convertible to T*");
+
+    // Like std::shared_ptr, the object is released if the block cannot be
+    // allocated.
+    try
+    {
+        control = new PointerControl<U, Deleter>(pointer, deleter);
+    }
+    catch (...)
+    {
+        if (pointer)
+            deleter(pointer);
+        throw;
+    }
     this->pointer = pointer;
-    count = new std::atomic<int>(1);
+    if (pointer)
+    {
+        PTR_TRACE(shared, create, this, pointer, sizeof(U));
+        PTR_RETAIN(object, control, pointer, sizeof(U), typeid(U).name());
+        PTR_RETAIN(hold, this, control);
+    }
+}
+
+template <typename T>
+SharedPtr<T>::SharedPtr(T* const pointer, SharedControl* const control, FromControl) noexcept
+{
+    this->pointer = pointer;
+    this->control = control;
+    if (control)
+        PTR_RETAIN(hold, this, control);
+}
+
+template <typename T>
+SharedPtr<T>::SharedPtr(const SharedPtr& other) noexcept
+{
+    pointer = other.pointer;
+    control = other.control;
+    if (control)
+    {
+        control->count.fetch_add(1, std::memory_order_relaxed);
+        PTR_TRACE(shared, copy, this, &other, 0);
+        PTR_RETAIN(hold, this, control);
+    }
+}
+
+template <typename T>
+SharedPtr<T>::SharedPtr(const SharedPtr& other, AdoptRef) noexcept
+{
+    pointer = other.pointer;
+    control = other.control;
+    if (control)
+    {
+        PTR_TRACE(shared, copy, this, &other, 0);
+        PTR_RETAIN(hold, this, control);
+    }
+}
+
+template <typename T>
+template <typename U, typename>
+SharedPtr<T>::SharedPtr(const SharedPtr<U>& other) noexcept
+{
+    pointer = other.pointer;
+    control = other.control;
+    if (control)
+    {
+        control->count.fetch_add(1, std::memory_order_relaxed);
+        PTR_TRACE(shared, copy, this, &other, 0);
+        PTR_RETAIN(hold, this, control);
+    }
 }
 
 template <typename T>
-SharedPtr<T>::SharedPtr(SharedPtr& other) noexcept
+template <typename U, typename>
+SharedPtr<T>::SharedPtr(SharedPtr<U>&& other) noexcept
 {
+    if (other.control)
+        PTR_TRACE(shared, move, this, &other, 0);
     pointer = other.pointer;
-    count = other.count;
-    count->fetch_add(1, std::memory_order_relaxed);
+    control = other.control;
+    if (control)
+    {
+        PTR_RETAIN(hold, this, control);
+        PTR_RETAIN(drop, &other);
+    }
+
+    other.pointer = nullptr;
+    other.control = nullptr;
 }
 
 template <typename T>
-SharedPtr<T>& SharedPtr<T>::operator=(SharedPtr& other) noexcept
+void SharedPtr<T>::release() noexcept
+{
+    if (!control)
+        return;
+    PTR_RETAIN(drop, this);
+    if (control->count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        PTR_RETAIN(release, control);
+        SharedRelease<T>::destroy(control);
+    }
+}
+
+template <typename T>
+SharedPtr<T>& SharedPtr<T>::operator=(const SharedPtr& other) noexcept
 {
     if (this == &other)
         return *this;
 
+    if (control || other.control)
+        PTR_TRACE(shared, copy_assign, this, &other, 0);
+    if (other.control)
+        other.control->count.fetch_add(1, std::memory_order_relaxed);
+    release();
+
     pointer = other.pointer;
-    count = other.count;
-    count->fetch_add(1, std::memory_order_relaxed);
+    control = other.control;
+    if (control)
+        PTR_RETAIN(hold, this, control);
     return *this;
 }
 
 template <typename T>
 SharedPtr<T>::SharedPtr(SharedPtr&& other) noexcept
 {
-    count = other.count;
+    if (other.control)
+        PTR_TRACE(shared, move, this, &other, 0);
+    control = other.control;
     pointer = other.pointer;
+    if (control)
+    {
+        PTR_RETAIN(hold, this, control);
+        PTR_RETAIN(drop, &other);
+    }
 
     other.pointer = nullptr;
-    other.count = nullptr;
+    other.control = nullptr;
 }
 
 template <typename T>
@@ -48,17 +238,20 @@ SharedPtr<T>& SharedPtr<T>::operator=(SharedPtr&& other) noexcept
     if (this == &other)
         return *this;
 
-    if (count && count->fetch_sub(1, std::memory_order_acq_rel) == 0)
-    {
-        delete pointer;
-        delete count;
-    }
+    if (control || other.control)
+        PTR_TRACE(shared, move_assign, this, &other, 0);
+    release();
 
     pointer = other.pointer;
-    count = other.count;
+    control = other.control;
+    if (control)
+    {
+        PTR_RETAIN(hold, this, control);
+        PTR_RETAIN(drop, &other);
+    }
 
     other.pointer = nullptr;
-    other.count = nullptr;
+    other.control = nullptr;
 
     return *this;
 }
@@ -66,15 +259,13 @@ SharedPtr<T>& SharedPtr<T>::operator=(SharedPtr&& other) noexcept
 template <typename T>
 SharedPtr<T>::~SharedPtr() noexcept
 {
-    if (count && count->fetch_sub(1, std::memory_order_acq_rel) == 0)
-    {
-        delete pointer;
-        delete count;
-    }
+    if (control)
+        PTR_TRACE(shared, destroy, this, nullptr, 0);
+    release();
 }
 
 template <typename T>
-T& SharedPtr<T>::operator*() const noexcept
+typename std::add_lvalue_reference<T>::type SharedPtr<T>::operator*() const noexcept
 {
     return *pointer;
 }
@@ -106,17 +297,58 @@ T* SharedPtr<T>::get() const noexcept
 template <typename T>
 void SharedPtr<T>::reset() noexcept
 {
-    if (count && count->fetch_sub(1, std::memory_order_acq_rel) == 0)
-    {
-        delete pointer;
-        delete count;
-    }
+    if (control)
+        PTR_TRACE(shared, reset, this, nullptr, 0);
+    release();
     pointer = nullptr;
-    count = nullptr;
+    control = nullptr;
 }
 
 template <typename T>
 int SharedPtr<T>::use_count() const noexcept
 {
-    return count ? count->load(std::memory_order_relaxed) : 0;
+    return control ? control->count.load(std::memory_order_relaxed) : 0;
+}
+
+template <typename T>
+void SharedPtr<T>::retain(const int n) const noexcept
+{
+    if (control && n > 0)
+        control->count.fetch_add(n, std::memory_order_relaxed);
+}
+
+template <typename T, typename Alloc, typename... Args>
+SharedPtr<T> AllocateShared(Args&&... args)
+{
+    InlineControl<T, Alloc>* control = Alloc::template create<InlineControl<T, Alloc>>();
+    try
+    {
+        new (&control->storage) T(std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+        Alloc::destroy(control);
+        throw;
+    }
+    PTR_RETAIN(object, control, control->object(), sizeof(T), typeid(T).name());
+    SharedPtr<T> result(control->object(), control, typename SharedPtr<T>::FromControl());
+    PTR_TRACE(shared, create, &result, result.pointer, sizeof(T));
+    return result;
+}
+
+template <typename T, typename... Args>
+SharedPtr<T> MakeShared(Args&&... args)
+{
+    return AllocateShared<T, SmallAlloc>(std::forward<Args>(args)...);
+}
+
+template <typename T, typename U>
+SharedPtr<T> StaticPointerCast(const SharedPtr<U>& other) noexcept
+{
+    if (other.control)
+        other.control->count.fetch_add(1, std::memory_order_relaxed);
+    SharedPtr<T> result(static_cast<T*>(other.pointer), other.control, typename SharedPtr<T>::FromControl());
+    if (other.control)
+        PTR_TRACE(shared, copy, &result, &other, 0);
+    return result;
 }
@@ -1,28 +1,148 @@
+#pragma once
+
 #include <atomic>
+#include <type_traits>
+
+#include "../ptr_trace/trace_hooks.h"
+#include "../retention/retain_hooks.h"
+#include "../small_alloc/small_alloc.h"
+#include "../unique_ptr/unique.h"
+
+// Tag for taking over a reference that was already added with retain().
+struct AdoptRef
+{
+};
+
+// Reference count plus the routine that destroys the object and frees the
+// block. The routine is picked when the first SharedPtr is built, from the
+// type actually allocated, so SharedPtr<Base> and SharedPtr<void> destroy a
+// Derived correctly.
+class SharedControl
+{
+public:
+    std::atomic<int> count;
+    void (*destroy)(SharedControl* control) noexcept;
+};
+
+// Block for an object allocated separately, released through Deleter.
+template <typename U, typename Deleter>
+class PointerControl : public SharedControl
+{
+public:
+    U* pointer;
+    Deleter deleter;
+
+    PointerControl(U* pointer, const Deleter& deleter);
+    static void destroy_block(SharedControl* control) noexcept;
+};
+
+// Block allocator using plain new and delete. AllocateShared accepts any
+// type with the same static create/destroy pair, as SmallAlloc has.
+struct NewAlloc
+{
+    template <typename T, typename... Args>
+    static T* create(Args&&... args);
+    template <typename T>
+    static void destroy(T* pointer) noexcept;
+};
+
+// Block with the object stored inline, built by AllocateShared.
+template <typename U, typename Alloc = NewAlloc>
+class InlineControl : public SharedControl
+{
+public:
+    typename std::aligned_storage<sizeof(U), alignof(U)>::type storage;
+
+    InlineControl() noexcept;
+    U* object() noexcept;
+    static void destroy_block(SharedControl* control) noexcept;
+};
+
+// MakeShared blocks follow the opt-out of the type they hold.
+template <typename U>
+struct UseSmallAlloc<InlineControl<U, SmallAlloc>> : UseSmallAlloc<U>
+{};
+
+template <typename T, bool = std::is_void<T>::value>
+struct SharedRelease
+{
+    static void destroy(SharedControl* control) noexcept;
+};
+
+template <typename T>
+struct SharedRelease<T, true>
+{
+    static void destroy(SharedControl* control) noexcept;
+};
 
 template <typename T>
 class SharedPtr
 {
 private:
     T* pointer;
-    std::atomic<int>* count;
+    SharedControl* control;
+
+    struct FromControl
+    {
+    };
+
+    SharedPtr(T* pointer, SharedControl* control, FromControl) noexcept;
+    void release() noexcept;
+
+    template <typename U>
+    friend class SharedPtr;
+    template <typename U, typename Alloc, typename... Args>
+    friend SharedPtr<U> AllocateShared(Args&&... args);
+    template <typename U, typename V>
+    friend SharedPtr<U> StaticPointerCast(const SharedPtr<V>& other) noexcept;
 
 public:
     SharedPtr() noexcept;
-    explicit SharedPtr(T* pointer) noexcept;
-    SharedPtr(SharedPtr& other) noexcept;
-    SharedPtr& operator=(SharedPtr& other) noexcept;
+    // Deletes the object if the control block cannot be allocated. Not
+    // available for T = void, which could not delete what it holds.
+    explicit SharedPtr(T* pointer);
+    // Takes ownership of a U (which may differ from T, or T may be void) and
+    // deletes it as a U.
+    template <typename U>
+    explicit SharedPtr(U* pointer);
+    template <typename U, typename Deleter>
+    SharedPtr(U* pointer, Deleter deleter);
+    SharedPtr(const SharedPtr& other) noexcept;
+    SharedPtr(const SharedPtr& other, AdoptRef) noexcept;
+    template <typename U, typename = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+    SharedPtr(const SharedPtr<U>& other) noexcept;
+    template <typename U, typename = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+    SharedPtr(SharedPtr<U>&& other) noexcept;
+    SharedPtr& operator=(const SharedPtr& other) noexcept;
     SharedPtr(SharedPtr&& other) noexcept;
     SharedPtr& operator=(SharedPtr&& other) noexcept;
     ~SharedPtr() noexcept;
 
-    T& operator*() const noexcept;
+    typename std::add_lvalue_reference<T>::type operator*() const noexcept;
     T* operator->() const noexcept;
     bool operator!() const noexcept;
     explicit operator bool() const noexcept;
     int use_count() const noexcept;
     T* get() const noexcept;
     void reset() noexcept;
+
+    // Adds n references in one atomic step, for handing out n copies built
+    // with AdoptRef.
+    void retain(int n) const noexcept;
 };
 
+// Allocates the object and its control block together, as one block from
+// Alloc.
+template <typename T, typename Alloc, typename... Args>
+SharedPtr<T> AllocateShared(Args&&... args);
+
+// AllocateShared from SmallAlloc.
+template <typename T, typename... Args>
+SharedPtr<T> MakeShared(Args&&... args);
+
+// Shares ownership of other's object under a static_cast pointer, e.g. to
+// get a typed handle back out of a SharedPtr<void>.
+template <typename T, typename U>
+SharedPtr<T> StaticPointerCast(const SharedPtr<U>& other) noexcept;
+
 #include "shared-inl.h"
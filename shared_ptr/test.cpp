@@ -1,3 +1,5 @@
+#include <stdexcept>
+#include <string>
 #include <thread>
 #include <gtest/gtest.h>
 #include "shared.h"
@@ -237,3 +239,162 @@ TYPED_TEST(SharedPtrTest, ThreadSafty)
 
     EXPECT_EQ(ptr.use_count(), 1);
 }
+
+
+class DestroyCounter
+{
+public:
+    static int destroyed;
+    ~DestroyCounter() { ++destroyed; }
+};
+
+int DestroyCounter::destroyed = 0;
+
+
+TEST(SharedPtrReleaseTest, LastReleaseDestroysObject)
+{
+    DestroyCounter::destroyed = 0;
+    {
+        SharedPtr<DestroyCounter> ptr1(new DestroyCounter());
+        SharedPtr<DestroyCounter> ptr2(ptr1);
+        SharedPtr<DestroyCounter> ptr3;
+        ptr3 = ptr2;
+        ptr1.reset();
+        EXPECT_EQ(DestroyCounter::destroyed, 0);
+    }
+    EXPECT_EQ(DestroyCounter::destroyed, 1);
+}
+
+
+TEST(SharedPtrReleaseTest, CopyAssignmentReleasesOldObject)
+{
+    DestroyCounter::destroyed = 0;
+    SharedPtr<DestroyCounter> ptr1(new DestroyCounter());
+    SharedPtr<DestroyCounter> ptr2(new DestroyCounter());
+
+    ptr1 = ptr2;
+
+    EXPECT_EQ(DestroyCounter::destroyed, 1);
+    EXPECT_EQ(ptr2.use_count(), 2);
+}
+
+
+TEST(SharedPtrReleaseTest, RetainedReferencesAreAdopted)
+{
+    DestroyCounter::destroyed = 0;
+    SharedPtr<DestroyCounter> original(new DestroyCounter());
+    original.retain(3);
+    EXPECT_EQ(original.use_count(), 4);
+    {
+        SharedPtr<DestroyCounter> copies[3] = {
+            SharedPtr<DestroyCounter>(original, AdoptRef()),
+            SharedPtr<DestroyCounter>(original, AdoptRef()),
+            SharedPtr<DestroyCounter>(original, AdoptRef())};
+        EXPECT_EQ(copies[2].get(), original.get());
+        EXPECT_EQ(original.use_count(), 4);
+    }
+    EXPECT_EQ(original.use_count(), 1);
+    original.reset();
+    EXPECT_EQ(DestroyCounter::destroyed, 1);
+}
+
+
+struct PlainBase
+{
+    int tag = 1;
+};
+
+struct CountedDerived : PlainBase
+{
+    static int destroyed;
+    std::string payload = "derived";
+    ~CountedDerived() { ++destroyed; }
+};
+
+int CountedDerived::destroyed = 0;
+
+
+TEST(SharedPtrErasureTest, BaseFromDerivedRunsDerivedDestructor)
+{
+    CountedDerived::destroyed = 0;
+    {
+        SharedPtr<PlainBase> base(new CountedDerived());
+        SharedPtr<PlainBase> copy = base;
+        EXPECT_EQ(copy->tag, 1);
+        EXPECT_EQ(base.use_count(), 2);
+    }
+    EXPECT_EQ(CountedDerived::destroyed, 1);
+}
+
+
+TEST(SharedPtrErasureTest, ConvertingMoveKeepsDestroyer)
+{
+    CountedDerived::destroyed = 0;
+    {
+        SharedPtr<CountedDerived> derived = MakeShared<CountedDerived>();
+        SharedPtr<PlainBase> base(std::move(derived));
+        EXPECT_FALSE(derived);
+        EXPECT_EQ(base.use_count(), 1);
+        EXPECT_EQ(CountedDerived::destroyed, 0);
+    }
+    EXPECT_EQ(CountedDerived::destroyed, 1);
+}
+
+
+TEST(SharedPtrErasureTest, VoidHandleDestroysOriginalType)
+{
+    CountedDerived::destroyed = 0;
+    {
+        SharedPtr<void> erased(new CountedDerived());
+        SharedPtr<void> other = SharedPtr<CountedDerived>(MakeShared<CountedDerived>());
+        EXPECT_EQ(erased.use_count(), 1);
+        EXPECT_EQ(other.use_count(), 1);
+
+        SharedPtr<CountedDerived> typed = StaticPointerCast<CountedDerived>(erased);
+        EXPECT_EQ(typed->payload, "derived");
+        EXPECT_EQ(erased.use_count(), 2);
+    }
+    EXPECT_EQ(CountedDerived::destroyed, 2);
+}
+
+
+TEST(SharedPtrErasureTest, CustomDeleterIsCalledOnce)
+{
+    int calls = 0;
+    int value = 5;
+    {
+        SharedPtr<int> ptr(&value, [&calls](int*) { ++calls; });
+        SharedPtr<int> copy = ptr;
+        EXPECT_EQ(*copy, 5);
+    }
+    EXPECT_EQ(calls, 1);
+}
+
+
+TEST(SharedPtrErasureTest, MakeSharedConstructsInPlace)
+{
+    DestroyCounter::destroyed = 0;
+    {
+        SharedPtr<std::string> text = MakeShared<std::string>(3, 'x');
+        EXPECT_EQ(*text, "xxx");
+        EXPECT_EQ(text.use_count(), 1);
+
+        SharedPtr<DestroyCounter> counter = MakeShared<DestroyCounter>();
+        SharedPtr<DestroyCounter> copy = counter;
+        counter.reset();
+        EXPECT_EQ(DestroyCounter::destroyed, 0);
+    }
+    EXPECT_EQ(DestroyCounter::destroyed, 1);
+}
+
+
+struct ThrowingConstructor
+{
+    ThrowingConstructor() { throw std::runtime_error("no"); }
+};
+
+
+TEST(SharedPtrErasureTest, MakeSharedPropagatesConstructorFailure)
+{
+    EXPECT_THROW(MakeShared<ThrowingConstructor>(), std::runtime_error);
+}
@@ -0,0 +1,162 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "shm.h"
+
+
+struct Result
+{
+    double attach;
+    std::uint64_t sum;
+};
+
+
+double seconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+bool read_all(int fd, void* data, std::size_t size)
+{
+    char* out = static_cast<char*>(data);
+    while (size > 0)
+    {
+        ssize_t got = read(fd, out, size);
+        if (got <= 0)
+            return false;
+        out += got;
+        size -= static_cast<std::size_t>(got);
+    }
+    return true;
+}
+
+
+bool write_all(int fd, const void* data, std::size_t size)
+{
+    const char* in = static_cast<const char*>(data);
+    while (size > 0)
+    {
+        ssize_t put = write(fd, in, size);
+        if (put <= 0)
+            return false;
+        in += put;
+        size -= static_cast<std::size_t>(put);
+    }
+    return true;
+}
+
+
+Result attach_and_read(const std::string& name)
+{
+    int results[2];
+    if (pipe(results) != 0)
+        std::exit(1);
+
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        auto start = std::chrono::steady_clock::now();
+        ShmSegment segment(name);
+        ShmSharedPtr<std::uint64_t> table = segment.find<std::uint64_t>("table");
+        Result result;
+        result.attach = seconds_since(start);
+        result.sum = 0;
+        for (std::size_t i = 0; i < table.size(); ++i)
+            result.sum += table[i];
+        write_all(results[1], &result, sizeof(result));
+        _exit(0);
+    }
+
+    Result result;
+    read_all(results[0], &result, sizeof(result));
+    waitpid(pid, nullptr, 0);
+    close(results[0]);
+    close(results[1]);
+    return result;
+}
+
+
+Result copy_and_read(const std::vector<std::uint64_t>& source)
+{
+    int data[2];
+    int results[2];
+    if (pipe(data) != 0 || pipe(results) != 0)
+        std::exit(1);
+
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        close(data[1]);
+        auto start = std::chrono::steady_clock::now();
+        std::uint64_t count = 0;
+        read_all(data[0], &count, sizeof(count));
+        std::vector<std::uint64_t> table(count);
+        read_all(data[0], table.data(), count * sizeof(std::uint64_t));
+        Result result;
+        result.attach = seconds_since(start);
+        result.sum = 0;
+        for (std::uint64_t value : table)
+            result.sum += value;
+        write_all(results[1], &result, sizeof(result));
+        _exit(0);
+    }
+
+    close(data[0]);
+    std::uint64_t count = source.size();
+    write_all(data[1], &count, sizeof(count));
+    write_all(data[1], source.data(), count * sizeof(std::uint64_t));
+    close(data[1]);
+
+    Result result;
+    read_all(results[0], &result, sizeof(result));
+    waitpid(pid, nullptr, 0);
+    close(results[0]);
+    close(results[1]);
+    return result;
+}
+
+
+int main(int argc, char** argv)
+{
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : (16u << 20);
+    const int rounds = argc > 2 ? std::atoi(argv[2]) : 5;
+    const std::string name = "/shm_bench_" + std::to_string(getpid());
+
+    std::vector<std::uint64_t> source(count);
+    for (std::size_t i = 0; i < count; ++i)
+        source[i] = i;
+
+    ShmSegment::remove(name);
+    ShmSegment segment(name, count * sizeof(std::uint64_t) + (1 << 20));
+    ShmSharedPtr<std::uint64_t> table = segment.construct<std::uint64_t>("table", count);
+    std::copy(source.begin(), source.end(), table.get());
+
+    std::printf("%zu elements (%.1f MiB), %d rounds\n", count, count * 8.0 / (1 << 20), rounds);
+    std::printf("%-12s %14s %14s\n", "mode", "attach ms", "total ms");
+    for (int round = 0; round < rounds; ++round)
+    {
+        auto start = std::chrono::steady_clock::now();
+        Result shared = attach_and_read(name);
+        double shared_total = seconds_since(start);
+
+        start = std::chrono::steady_clock::now();
+        Result copied = copy_and_read(source);
+        double copied_total = seconds_since(start);
+
+        if (shared.sum != copied.sum)
+            std::printf("checksum mismatch\n");
+        std::printf("%-12s %14.3f %14.3f\n", "shm", shared.attach * 1e3, shared_total * 1e3);
+        std::printf("%-12s %14.3f %14.3f\n", "pipe copy", copied.attach * 1e3, copied_total * 1e3);
+    }
+
+    table.reset();
+    ShmSegment::remove(name);
+    return 0;
+}
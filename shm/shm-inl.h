@@ -0,0 +1,608 @@
+#include <cassert>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+inline std::size_t shm_round_up(const std::size_t size) noexcept
+{
+    return (size + ShmSegment::alignment - 1) & ~(ShmSegment::alignment - 1);
+}
+
+template <typename T>
+OffsetPtr<T>::OffsetPtr() noexcept
+{
+    offset = 1;
+}
+
+template <typename T>
+OffsetPtr<T>::OffsetPtr(T* const pointer) noexcept
+{
+    *this = pointer;
+}
+
+template <typename T>
+OffsetPtr<T>::OffsetPtr(const OffsetPtr& other) noexcept
+{
+    *this = other.get();
+}
+
+template <typename T>
+OffsetPtr<T>& OffsetPtr<T>::operator=(const OffsetPtr& other) noexcept
+{
+    return *this = other.get();
+}
+
+template <typename T>
+OffsetPtr<T>& OffsetPtr<T>::operator=(T* const pointer) noexcept
+{
+    if (pointer == nullptr)
+        offset = 1;
+    else
+        offset = reinterpret_cast<char*>(pointer) - reinterpret_cast<char*>(this);
+    return *this;
+}
+
+template <typename T>
+T& OffsetPtr<T>::operator*() const noexcept
+{
+    return *get();
+}
+
+template <typename T>
+T* OffsetPtr<T>::operator->() const noexcept
+{
+    return get();
+}
+
+template <typename T>
+bool OffsetPtr<T>::operator!() const noexcept
+{
+    return offset == 1;
+}
+
+template <typename T>
+OffsetPtr<T>::operator bool() const noexcept
+{
+    return offset != 1;
+}
+
+template <typename T>
+T* OffsetPtr<T>::get() const noexcept
+{
+    if (offset == 1)
+        return nullptr;
+    return reinterpret_cast<T*>(const_cast<char*>(reinterpret_cast<const char*>(this)) + offset);
+}
+
+inline void* ShmObject::data() noexcept
+{
+    return reinterpret_cast<char*>(this) + shm_round_up(sizeof(ShmObject));
+}
+
+inline ShmSegment::Lock::Lock(ShmSegment& segment) : segment(segment)
+{
+    int result = pthread_mutex_lock(&segment.header->mutex);
+    if (result == EOWNERDEAD)
+    {
+        segment.reap();
+        pthread_mutex_consistent(&segment.header->mutex);
+    }
+    else if (result != 0)
+    {
+        throw std::system_error(result, std::generic_category(), "pthread_mutex_lock");
+    }
+    held = true;
+}
+
+// For the noexcept paths: a failed lock is reported on stderr and leaves the
+// guard unheld, so the caller skips its update instead of terminating.
+inline ShmSegment::Lock::Lock(ShmSegment& segment, const std::nothrow_t&) noexcept : segment(segment)
+{
+    int result = pthread_mutex_lock(&segment.header->mutex);
+    if (result == EOWNERDEAD)
+    {
+        segment.reap();
+        pthread_mutex_consistent(&segment.header->mutex);
+    }
+    else if (result != 0)
+    {
+        std::fprintf(stderr, "shm: pthread_mutex_lock: %s\n", std::strerror(result));
+        held = false;
+        return;
+    }
+    held = true;
+}
+
+inline ShmSegment::Lock::~Lock() noexcept
+{
+    if (held)
+        pthread_mutex_unlock(&segment.header->mutex);
+}
+
+inline ShmSegment::Lock::operator bool() const noexcept
+{
+    return held;
+}
+
+inline ShmSegment::ShmSegment(const std::string& name, const std::size_t size)
+{
+    header = nullptr;
+    mapped = 0;
+    slot = -1;
+    pointers = 0;
+
+    const std::size_t first = shm_round_up(sizeof(ShmHeader));
+    if (size < first + alignment)
+        throw std::system_error(EINVAL, std::generic_category(), "shm segment too small");
+
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0)
+        throw std::system_error(errno, std::generic_category(), "shm_open " + name);
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0)
+    {
+        int error = errno;
+        close(fd);
+        shm_unlink(name.c_str());
+        throw std::system_error(error, std::generic_category(), "ftruncate " + name);
+    }
+    map(fd, size);
+
+    pthread_mutexattr_t attributes;
+    pthread_mutexattr_init(&attributes);
+    pthread_mutexattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&attributes, PTHREAD_MUTEX_ROBUST);
+    pthread_mutex_init(&header->mutex, &attributes);
+    pthread_mutexattr_destroy(&attributes);
+
+    header->size = size;
+    std::memset(header->processes, 0, sizeof(header->processes));
+    header->objects = nullptr;
+
+    ShmFreeBlock* block = reinterpret_cast<ShmFreeBlock*>(reinterpret_cast<char*>(header) + first);
+    block->size = (size - first) & ~(alignment - 1);
+    block->next = nullptr;
+    header->free_list = block;
+
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = magic;
+
+    attach();
+}
+
+inline ShmSegment::ShmSegment(const std::string& name)
+{
+    header = nullptr;
+    mapped = 0;
+    slot = -1;
+    pointers = 0;
+
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0)
+        throw std::system_error(errno, std::generic_category(), "shm_open " + name);
+
+    struct stat status;
+    if (fstat(fd, &status) != 0 || static_cast<std::size_t>(status.st_size) < sizeof(ShmHeader))
+    {
+        close(fd);
+        throw std::system_error(EINVAL, std::generic_category(), "shm segment not initialized " + name);
+    }
+    map(fd, static_cast<std::size_t>(status.st_size));
+
+    if (header->magic != magic)
+    {
+        munmap(header, mapped);
+        throw std::system_error(EINVAL, std::generic_category(), "shm segment not initialized " + name);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    attach();
+}
+
+inline ShmSegment::~ShmSegment() noexcept
+{
+    assert(pointers.load(std::memory_order_relaxed) == 0 && "ShmSharedPtr outlives its ShmSegment");
+
+    {
+        Lock lock(*this, std::nothrow);
+        ShmObject* object = lock ? header->objects.get() : nullptr;
+        while (object)
+        {
+            ShmObject* next = object->next.get();
+            object->holders -= object->refs[slot];
+            object->refs[slot] = 0;
+            if (object->holders == 0)
+                destroy(object);
+            object = next;
+        }
+        if (lock)
+            header->processes[slot] = 0;
+    }
+    munmap(header, mapped);
+}
+
+inline void ShmSegment::remove(const std::string& name) noexcept
+{
+    shm_unlink(name.c_str());
+}
+
+inline void ShmSegment::map(const int fd, const std::size_t size)
+{
+    void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    int error = errno;
+    close(fd);
+    if (base == MAP_FAILED)
+        throw std::system_error(error, std::generic_category(), "mmap");
+
+    header = static_cast<ShmHeader*>(base);
+    mapped = size;
+}
+
+inline void ShmSegment::attach()
+{
+    try
+    {
+        Lock lock(*this);
+        reap();
+        for (int i = 0; i < ShmObject::max_processes; ++i)
+        {
+            if (header->processes[i] == 0)
+            {
+                header->processes[i] = getpid();
+                slot = i;
+                return;
+            }
+        }
+        throw std::runtime_error("shm segment has no free process slot");
+    }
+    catch (...)
+    {
+        munmap(header, mapped);
+        throw;
+    }
+}
+
+inline std::size_t ShmSegment::reap() noexcept
+{
+    std::size_t reaped = 0;
+    for (int i = 0; i < ShmObject::max_processes; ++i)
+    {
+        pid_t pid = header->processes[i];
+        if (pid == 0 || i == slot || kill(pid, 0) == 0 || errno != ESRCH)
+            continue;
+
+        ShmObject* object = header->objects.get();
+        while (object)
+        {
+            ShmObject* next = object->next.get();
+            object->holders -= object->refs[i];
+            object->refs[i] = 0;
+            if (object->holders == 0)
+                destroy(object);
+            object = next;
+        }
+        header->processes[i] = 0;
+        ++reaped;
+    }
+    return reaped;
+}
+
+inline ShmObject* ShmSegment::lookup(const char* const name) noexcept
+{
+    for (ShmObject* object = header->objects.get(); object; object = object->next.get())
+    {
+        if (std::strncmp(object->name, name, ShmObject::name_size) == 0)
+            return object;
+    }
+    return nullptr;
+}
+
+inline void* ShmSegment::allocate(std::size_t size) noexcept
+{
+    size = shm_round_up(size);
+
+    OffsetPtr<ShmFreeBlock>* link = &header->free_list;
+    while (ShmFreeBlock* block = link->get())
+    {
+        if (block->size >= size)
+        {
+            if (block->size == size)
+            {
+                *link = block->next.get();
+            }
+            else
+            {
+                ShmFreeBlock* rest = reinterpret_cast<ShmFreeBlock*>(reinterpret_cast<char*>(block) + size);
+                rest->size = block->size - size;
+                rest->next = block->next.get();
+                *link = rest;
+            }
+            return block;
+        }
+        link = &block->next;
+    }
+    return nullptr;
+}
+
+inline void ShmSegment::deallocate(void* const memory, const std::size_t size) noexcept
+{
+    char* start = static_cast<char*>(memory);
+    ShmFreeBlock* previous = nullptr;
+    OffsetPtr<ShmFreeBlock>* link = &header->free_list;
+    while (link->get() && reinterpret_cast<char*>(link->get()) < start)
+    {
+        previous = link->get();
+        link = &previous->next;
+    }
+
+    ShmFreeBlock* next = link->get();
+    ShmFreeBlock* block = reinterpret_cast<ShmFreeBlock*>(start);
+    block->size = size;
+    block->next = next;
+    if (next && start + size == reinterpret_cast<char*>(next))
+    {
+        block->size += next->size;
+        block->next = next->next.get();
+    }
+
+    if (previous && reinterpret_cast<char*>(previous) + previous->size == start)
+    {
+        previous->size += block->size;
+        previous->next = block->next.get();
+    }
+    else
+    {
+        *link = block;
+    }
+}
+
+inline void ShmSegment::destroy(ShmObject* const object) noexcept
+{
+    OffsetPtr<ShmObject>* link = &header->objects;
+    while (link->get() != object)
+        link = &link->get()->next;
+    *link = object->next.get();
+
+    deallocate(object, object->block_size);
+}
+
+inline void ShmSegment::release(ShmObject* const object) noexcept
+{
+    Lock lock(*this, std::nothrow);
+    if (!lock)
+        return;
+    --object->refs[slot];
+    if (--object->holders == 0)
+        destroy(object);
+}
+
+template <typename T>
+ShmSharedPtr<T> ShmSegment::construct(const char* const name, const std::size_t count)
+{
+    static_assert(std::is_trivially_destructible<T>::value, "shm objects are never destroyed in place");
+    static_assert(alignof(T) <= alignment, "shm objects are only 64-byte aligned");
+
+    if (std::strlen(name) >= ShmObject::name_size)
+        return ShmSharedPtr<T>();
+
+    Lock lock(*this);
+    if (lookup(name))
+        return ShmSharedPtr<T>();
+
+    const std::size_t size = shm_round_up(shm_round_up(sizeof(ShmObject)) + sizeof(T) * count);
+    void* block = allocate(size);
+    if (block == nullptr && reap() > 0)
+        block = allocate(size);
+    if (block == nullptr)
+        return ShmSharedPtr<T>();
+
+    ShmObject* object = static_cast<ShmObject*>(block);
+    object->block_size = size;
+    object->element_size = sizeof(T);
+    object->count = count;
+    object->holders = 1;
+    std::memset(object->refs, 0, sizeof(object->refs));
+    object->refs[slot] = 1;
+    std::memcpy(object->name, name, std::strlen(name) + 1);
+
+    T* data = static_cast<T*>(object->data());
+    for (std::size_t i = 0; i < count; ++i)
+        new (data + i) T();
+
+    object->next = header->objects.get();
+    header->objects = object;
+
+    return ShmSharedPtr<T>(this, object);
+}
+
+template <typename T>
+ShmSharedPtr<T> ShmSegment::find(const char* const name)
+{
+    Lock lock(*this);
+    ShmObject* object = lookup(name);
+    if (object == nullptr || object->element_size != sizeof(T))
+        return ShmSharedPtr<T>();
+
+    ++object->refs[slot];
+    ++object->holders;
+    return ShmSharedPtr<T>(this, object);
+}
+
+inline std::size_t ShmSegment::recover()
+{
+    Lock lock(*this);
+    return reap();
+}
+
+inline std::size_t ShmSegment::free_bytes()
+{
+    Lock lock(*this);
+    std::size_t bytes = 0;
+    for (ShmFreeBlock* block = header->free_list.get(); block; block = block->next.get())
+        bytes += block->size;
+    return bytes;
+}
+
+inline void* ShmSegment::base() const noexcept
+{
+    return header;
+}
+
+template <typename T>
+ShmSharedPtr<T>::ShmSharedPtr() noexcept
+{
+    pointer = nullptr;
+    object = nullptr;
+    segment = nullptr;
+    count = nullptr;
+}
+
+template <typename T>
+ShmSharedPtr<T>::ShmSharedPtr(ShmSegment* const segment, ShmObject* const object)
+{
+    this->segment = segment;
+    this->object = object;
+    pointer = static_cast<T*>(object->data());
+    count = new std::atomic<long>(1);
+    segment->pointers.fetch_add(1, std::memory_order_relaxed);
+}
+
+template <typename T>
+ShmSharedPtr<T>::ShmSharedPtr(const ShmSharedPtr& other) noexcept
+{
+    pointer = other.pointer;
+    object = other.object;
+    segment = other.segment;
+    count = other.count;
+    if (count)
+        count->fetch_add(1, std::memory_order_relaxed);
+}
+
+template <typename T>
+ShmSharedPtr<T>& ShmSharedPtr<T>::operator=(const ShmSharedPtr& other) noexcept
+{
+    if (this == &other)
+        return *this;
+
+    if (other.count)
+        other.count->fetch_add(1, std::memory_order_relaxed);
+    reset();
+
+    pointer = other.pointer;
+    object = other.object;
+    segment = other.segment;
+    count = other.count;
+    return *this;
+}
+
+template <typename T>
+ShmSharedPtr<T>::ShmSharedPtr(ShmSharedPtr&& other) noexcept
+{
+    pointer = other.pointer;
+    object = other.object;
+    segment = other.segment;
+    count = other.count;
+
+    other.pointer = nullptr;
+    other.object = nullptr;
+    other.segment = nullptr;
+    other.count = nullptr;
+}
+
+template <typename T>
+ShmSharedPtr<T>& ShmSharedPtr<T>::operator=(ShmSharedPtr&& other) noexcept
+{
+    if (this == &other)
+        return *this;
+
+    reset();
+
+    pointer = other.pointer;
+    object = other.object;
+    segment = other.segment;
+    count = other.count;
+
+    other.pointer = nullptr;
+    other.object = nullptr;
+    other.segment = nullptr;
+    other.count = nullptr;
+
+    return *this;
+}
+
+template <typename T>
+ShmSharedPtr<T>::~ShmSharedPtr() noexcept
+{
+    reset();
+}
+
+template <typename T>
+T& ShmSharedPtr<T>::operator*() const noexcept
+{
+    return *pointer;
+}
+
+template <typename T>
+T* ShmSharedPtr<T>::operator->() const noexcept
+{
+    return pointer;
+}
+
+template <typename T>
+T& ShmSharedPtr<T>::operator[](const std::size_t index) const noexcept
+{
+    return pointer[index];
+}
+
+template <typename T>
+bool ShmSharedPtr<T>::operator!() const noexcept
+{
+    return pointer == nullptr;
+}
+
+template <typename T>
+ShmSharedPtr<T>::operator bool() const noexcept
+{
+    return pointer != nullptr;
+}
+
+template <typename T>
+long ShmSharedPtr<T>::use_count() const noexcept
+{
+    return count ? count->load(std::memory_order_relaxed) : 0;
+}
+
+template <typename T>
+std::size_t ShmSharedPtr<T>::size() const noexcept
+{
+    return object ? object->count : 0;
+}
+
+template <typename T>
+T* ShmSharedPtr<T>::get() const noexcept
+{
+    return pointer;
+}
+
+template <typename T>
+void ShmSharedPtr<T>::reset() noexcept
+{
+    if (count && count->fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        segment->release(object);
+        segment->pointers.fetch_sub(1, std::memory_order_relaxed);
+        delete count;
+    }
+    pointer = nullptr;
+    object = nullptr;
+    segment = nullptr;
+    count = nullptr;
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <pthread.h>
+#include <sys/types.h>
+
+// Pointer stored as a distance from its own address, so it stays valid in
+// every process no matter where the segment is mapped.
+template <typename T>
+class OffsetPtr
+{
+private:
+    std::ptrdiff_t offset;
+
+public:
+    OffsetPtr() noexcept;
+    OffsetPtr(T* pointer) noexcept;
+    OffsetPtr(const OffsetPtr& other) noexcept;
+    OffsetPtr& operator=(const OffsetPtr& other) noexcept;
+    OffsetPtr& operator=(T* pointer) noexcept;
+
+    T& operator*() const noexcept;
+    T* operator->() const noexcept;
+    bool operator!() const noexcept;
+    explicit operator bool() const noexcept;
+    T* get() const noexcept;
+};
+
+struct ShmFreeBlock
+{
+    std::uint64_t size;
+    OffsetPtr<ShmFreeBlock> next;
+};
+
+struct ShmObject
+{
+    static const int max_processes = 64;
+    static const std::size_t name_size = 48;
+
+    OffsetPtr<ShmObject> next;
+    std::uint64_t block_size;
+    std::uint64_t element_size;
+    std::uint64_t count;
+    std::uint32_t holders;
+    std::uint32_t refs[max_processes];
+    char name[name_size];
+
+    void* data() noexcept;
+};
+
+struct ShmHeader
+{
+    std::uint64_t magic;
+    std::uint64_t size;
+    pthread_mutex_t mutex;
+    pid_t processes[ShmObject::max_processes];
+    OffsetPtr<ShmObject> objects;
+    OffsetPtr<ShmFreeBlock> free_list;
+};
+
+class ShmSegment;
+
+template <typename T>
+class ShmSharedPtr
+{
+private:
+    T* pointer;
+    ShmObject* object;
+    ShmSegment* segment;
+    std::atomic<long>* count;
+
+    ShmSharedPtr(ShmSegment* segment, ShmObject* object);
+
+    friend class ShmSegment;
+
+public:
+    ShmSharedPtr() noexcept;
+    ShmSharedPtr(const ShmSharedPtr& other) noexcept;
+    ShmSharedPtr& operator=(const ShmSharedPtr& other) noexcept;
+    ShmSharedPtr(ShmSharedPtr&& other) noexcept;
+    ShmSharedPtr& operator=(ShmSharedPtr&& other) noexcept;
+    ~ShmSharedPtr() noexcept;
+
+    T& operator*() const noexcept;
+    T* operator->() const noexcept;
+    T& operator[](std::size_t index) const noexcept;
+    bool operator!() const noexcept;
+    explicit operator bool() const noexcept;
+    long use_count() const noexcept;
+    std::size_t size() const noexcept;
+    T* get() const noexcept;
+    void reset() noexcept;
+};
+
+// A named POSIX shared-memory segment holding named, refcounted arrays.
+// Every process that opens the segment takes a slot in the process table,
+// and each object counts its holders per slot. When a process dies without
+// releasing, the next lock or recover() call in any other process drops the
+// dead slot's references and frees objects nobody holds anymore.
+//
+// The segment owns the mapping: every ShmSharedPtr it hands out must be
+// reset or destroyed before the segment itself. Debug builds assert this.
+class ShmSegment
+{
+private:
+    static const std::uint64_t magic = 0x3130534d48535043ull;
+
+    ShmHeader* header;
+    std::size_t mapped;
+    int slot;
+    std::atomic<long> pointers;
+
+    class Lock
+    {
+    private:
+        ShmSegment& segment;
+        bool held;
+
+    public:
+        explicit Lock(ShmSegment& segment);
+        Lock(ShmSegment& segment, const std::nothrow_t&) noexcept;
+        ~Lock() noexcept;
+
+        explicit operator bool() const noexcept;
+    };
+
+    void map(int fd, std::size_t size);
+    void attach();
+    std::size_t reap() noexcept;
+    ShmObject* lookup(const char* name) noexcept;
+    void* allocate(std::size_t size) noexcept;
+    void deallocate(void* block, std::size_t size) noexcept;
+    void destroy(ShmObject* object) noexcept;
+    void release(ShmObject* object) noexcept;
+
+    template <typename T>
+    friend class ShmSharedPtr;
+
+public:
+    static const std::size_t alignment = 64;
+
+    ShmSegment(const std::string& name, std::size_t size);
+    explicit ShmSegment(const std::string& name);
+    ShmSegment(const ShmSegment&) = delete;
+    ShmSegment& operator=(const ShmSegment&) = delete;
+    ~ShmSegment() noexcept;
+
+    static void remove(const std::string& name) noexcept;
+
+    template <typename T>
+    ShmSharedPtr<T> construct(const char* name, std::size_t count);
+    template <typename T>
+    ShmSharedPtr<T> find(const char* name);
+
+    std::size_t recover();
+    std::size_t free_bytes();
+    void* base() const noexcept;
+};
+
+#include "shm-inl.h"
@@ -0,0 +1,190 @@
+#include <cstring>
+#include <string>
+#include <gtest/gtest.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "shm.h"
+
+
+class ShmTest : public ::testing::Test
+{
+protected:
+    std::string name;
+
+    void SetUp() override
+    {
+        name = "/shm_test_" + std::to_string(getpid());
+        ShmSegment::remove(name);
+    }
+
+    void TearDown() override
+    {
+        ShmSegment::remove(name);
+    }
+};
+
+
+template <typename Func>
+int run_child(Func func)
+{
+    pid_t pid = fork();
+    if (pid == 0)
+        _exit(func());
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+
+TEST(OffsetPtrTest, NullAndRelative)
+{
+    struct Node
+    {
+        int value;
+        OffsetPtr<Node> next;
+    };
+
+    Node nodes[2];
+    EXPECT_FALSE(nodes[0].next);
+    EXPECT_EQ(nodes[0].next.get(), nullptr);
+
+    nodes[0].value = 1;
+    nodes[1].value = 2;
+    nodes[0].next = &nodes[1];
+    EXPECT_EQ(nodes[0].next->value, 2);
+
+    alignas(Node) unsigned char bytes[sizeof(nodes)];
+    std::memcpy(bytes, nodes, sizeof(nodes));
+    Node* copy = reinterpret_cast<Node*>(bytes);
+    EXPECT_EQ(copy[0].next.get(), &copy[1]);
+}
+
+
+TEST_F(ShmTest, ConstructAndFind)
+{
+    ShmSegment segment(name, 1 << 20);
+    ShmSharedPtr<long> table = segment.construct<long>("table", 1000);
+    ASSERT_TRUE(table);
+    EXPECT_EQ(table.size(), 1000u);
+    for (std::size_t i = 0; i < table.size(); ++i)
+        table[i] = static_cast<long>(i);
+
+    ShmSharedPtr<long> found = segment.find<long>("table");
+    ASSERT_TRUE(found);
+    EXPECT_EQ(found.get(), table.get());
+    EXPECT_EQ(found[999], 999);
+
+    EXPECT_FALSE(segment.find<long>("missing"));
+    EXPECT_FALSE(segment.find<char>("table"));
+    EXPECT_FALSE(segment.construct<long>("table", 1));
+}
+
+
+TEST_F(ShmTest, LastReleaseFreesObject)
+{
+    ShmSegment segment(name, 1 << 20);
+    const std::size_t before = segment.free_bytes();
+    {
+        ShmSharedPtr<int> ptr1 = segment.construct<int>("values", 4096);
+        ShmSharedPtr<int> ptr2 = ptr1;
+        EXPECT_EQ(ptr1.use_count(), 2);
+        EXPECT_LT(segment.free_bytes(), before);
+
+        ptr1.reset();
+        EXPECT_TRUE(segment.find<int>("values"));
+    }
+    EXPECT_EQ(segment.free_bytes(), before);
+    EXPECT_FALSE(segment.find<int>("values"));
+}
+
+
+TEST_F(ShmTest, FreedMemoryIsReused)
+{
+    ShmSegment segment(name, 1 << 20);
+    const std::size_t before = segment.free_bytes();
+    {
+        ShmSharedPtr<char> a = segment.construct<char>("a", 1000);
+        ShmSharedPtr<char> b = segment.construct<char>("b", 1000);
+        ShmSharedPtr<char> c = segment.construct<char>("c", 1000);
+        b.reset();
+        a.reset();
+    }
+    EXPECT_EQ(segment.free_bytes(), before);
+    EXPECT_TRUE(segment.construct<char>("big", before - 1024));
+}
+
+
+TEST_F(ShmTest, OtherProcessReadsTable)
+{
+    ShmSegment segment(name, 1 << 20);
+    ShmSharedPtr<long> table = segment.construct<long>("table", 100);
+    for (std::size_t i = 0; i < table.size(); ++i)
+        table[i] = static_cast<long>(i * i);
+
+    const std::string segment_name = name;
+    int status = run_child([&segment_name]() {
+        ShmSegment other(segment_name);
+        ShmSharedPtr<long> found = other.find<long>("table");
+        if (!found || found.size() != 100)
+            return 1;
+        for (std::size_t i = 0; i < found.size(); ++i)
+        {
+            if (found[i] != static_cast<long>(i * i))
+                return 2;
+        }
+        found[0] = -1;
+        return 0;
+    });
+
+    EXPECT_EQ(status, 0);
+    EXPECT_EQ(table[0], -1);
+}
+
+
+TEST_F(ShmTest, LastProcessDestroysObject)
+{
+    ShmSegment segment(name, 1 << 20);
+    const std::size_t before = segment.free_bytes();
+
+    const std::string segment_name = name;
+    int status = run_child([&segment_name]() {
+        ShmSegment other(segment_name);
+        ShmSharedPtr<long> table = other.construct<long>("table", 100);
+        return table ? 0 : 1;
+    });
+
+    EXPECT_EQ(status, 0);
+    EXPECT_FALSE(segment.find<long>("table"));
+    EXPECT_EQ(segment.free_bytes(), before);
+}
+
+
+TEST_F(ShmTest, CrashedProcessIsRecovered)
+{
+    ShmSegment segment(name, 1 << 20);
+    const std::size_t before = segment.free_bytes();
+    ShmSharedPtr<long> table = segment.construct<long>("table", 100);
+
+    const std::string segment_name = name;
+    int status = run_child([&segment_name]() {
+        ShmSegment other(segment_name);
+        ShmSharedPtr<long> found = other.find<long>("table");
+        _exit(found ? 0 : 1);
+        return 1;
+    });
+    EXPECT_EQ(status, 0);
+
+    table.reset();
+    EXPECT_TRUE(segment.find<long>("table"));
+
+    EXPECT_EQ(segment.recover(), 1u);
+    EXPECT_FALSE(segment.find<long>("table"));
+    EXPECT_EQ(segment.free_bytes(), before);
+}
+
+
+TEST_F(ShmTest, OpenMissingSegmentThrows)
+{
+    EXPECT_THROW(ShmSegment segment(name), std::system_error);
+}
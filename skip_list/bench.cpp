@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "skip_list.h"
+
+
+struct Payload
+{
+    long value;
+};
+
+
+class LockedMap
+{
+private:
+    std::map<long, SharedPtr<Payload>> map;
+    mutable std::mutex mutex;
+
+public:
+    SharedPtr<Payload> get(long key) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = map.find(key);
+        return it == map.end() ? SharedPtr<Payload>() : it->second;
+    }
+
+    void put(long key, SharedPtr<Payload> value)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        map[key] = std::move(value);
+    }
+
+    void erase(long key)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        map.erase(key);
+    }
+
+    long scan(long from, long to) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        long sum = 0;
+        for (auto it = map.lower_bound(from); it != map.end() && it->first < to; ++it)
+            sum += it->second->value;
+        return sum;
+    }
+};
+
+
+class LockFreeMap
+{
+private:
+    SkipListMap<long, Payload> map;
+
+public:
+    SharedPtr<Payload> get(long key) const
+    {
+        return map.get(key);
+    }
+
+    void put(long key, SharedPtr<Payload> value)
+    {
+        map.put(key, std::move(value));
+    }
+
+    void erase(long key)
+    {
+        map.erase(key);
+    }
+
+    long scan(long from, long to) const
+    {
+        long sum = 0;
+        for (auto entry : map.range(from, to))
+            sum += entry.second->value;
+        return sum;
+    }
+};
+
+
+// Per 100 operations: 80 gets, 10 puts, 5 erases, 5 scans of 32 keys.
+template <typename Map>
+double run(int threads, long keys, long operations)
+{
+    Map map;
+    for (long key = 0; key < keys; key += 2)
+        map.put(key, SharedPtr<Payload>(new Payload{key}));
+
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&, t]() {
+            unsigned long seed = static_cast<unsigned long>(t) * 2654435761ul + 1;
+            long sink = 0;
+            for (long i = 0; i < operations; ++i)
+            {
+                seed = seed * 6364136223846793005ul + 1442695040888963407ul;
+                const long key = static_cast<long>((seed >> 20) % static_cast<unsigned long>(keys));
+                const int choice = static_cast<int>((seed >> 8) % 100);
+                if (choice < 80)
+                {
+                    SharedPtr<Payload> value = map.get(key);
+                    if (value)
+                        sink += value->value;
+                }
+                else if (choice < 90)
+                    map.put(key, SharedPtr<Payload>(new Payload{key}));
+                else if (choice < 95)
+                    map.erase(key);
+                else
+                    sink += map.scan(key, key + 32);
+            }
+            if (sink == 42)
+                std::printf(" ");
+        });
+    }
+    for (std::thread& worker : workers)
+        worker.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return static_cast<double>(operations) * threads / seconds;
+}
+
+
+int main(int argc, char** argv)
+{
+    const int max_threads = argc > 1 ? std::atoi(argv[1]) : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    const long keys = argc > 2 ? std::atol(argv[2]) : 100000;
+    const long operations = argc > 3 ? std::atol(argv[3]) : 1000000;
+
+    std::printf("%ld keys, %ld operations per thread (80%% get, 10%% put, 5%% erase, 5%% scan)\n", keys, operations);
+    std::printf("%8s %22s %22s\n", "threads", "mutex std::map ops/s", "SkipListMap ops/s");
+    for (int threads = 1; threads <= max_threads; threads *= 2)
+    {
+        double locked = run<LockedMap>(threads, keys, operations);
+        double lock_free = run<LockFreeMap>(threads, keys, operations);
+        std::printf("%8d %22.0f %22.0f\n", threads, locked, lock_free);
+    }
+    return 0;
+}
@@ -0,0 +1,164 @@
+#include <algorithm>
+
+inline EpochRecord::EpochRecord()
+{
+    state.store(0, std::memory_order_relaxed);
+    depth = 0;
+    retired_since_advance = 0;
+    for (std::uint64_t& epoch : bag_epochs)
+        epoch = 0;
+
+    Epoch::State& global = Epoch::state();
+    std::lock_guard<std::mutex> lock(global.mutex);
+    global.records.push_back(this);
+}
+
+inline EpochRecord::~EpochRecord()
+{
+    // Whatever this thread still has waiting is handed over and freed by
+    // whichever thread advances the epoch far enough.
+    Epoch::State& global = Epoch::state();
+    std::lock_guard<std::mutex> lock(global.mutex);
+    for (int i = 0; i < 3; ++i)
+    {
+        for (const RetiredObject& object : bags[i])
+            global.orphans.push_back(Epoch::Orphan{bag_epochs[i], object});
+    }
+    global.records.erase(std::find(global.records.begin(), global.records.end(), this));
+}
+
+inline Epoch::State& Epoch::state() noexcept
+{
+    static State state;
+    return state;
+}
+
+inline EpochRecord& Epoch::local()
+{
+    static thread_local EpochRecord record;
+    return record;
+}
+
+inline void Epoch::enter() noexcept
+{
+    EpochRecord& record = local();
+    if (record.depth++ != 0)
+        return;
+
+    const std::uint64_t epoch = state().epoch.load(std::memory_order_seq_cst);
+    record.state.store(epoch << 1 | 1, std::memory_order_seq_cst);
+    collect(record, epoch);
+}
+
+inline void Epoch::exit() noexcept
+{
+    EpochRecord& record = local();
+    if (--record.depth == 0)
+        record.state.store(record.state.load(std::memory_order_relaxed) & ~std::uint64_t(1), std::memory_order_release);
+}
+
+inline void Epoch::retire(void* const pointer, void (*destroy)(void*) noexcept)
+{
+    State& state = Epoch::state();
+    EpochRecord& record = local();
+    const std::uint64_t epoch = state.epoch.load(std::memory_order_seq_cst);
+    collect(record, epoch);
+
+    const int bag = static_cast<int>(epoch % 3);
+    record.bag_epochs[bag] = epoch;
+    record.bags[bag].push_back(RetiredObject{pointer, destroy});
+    state.pending.fetch_add(1, std::memory_order_relaxed);
+
+    if (++record.retired_since_advance >= advance_interval)
+    {
+        record.retired_since_advance = 0;
+        try_advance(state);
+        collect(record, state.epoch.load(std::memory_order_seq_cst));
+    }
+}
+
+template <typename T>
+void Epoch::destroy_object(void* const pointer) noexcept
+{
+    delete static_cast<T*>(pointer);
+}
+
+template <typename T>
+void Epoch::retire(T* const pointer)
+{
+    retire(pointer, &Epoch::destroy_object<T>);
+}
+
+inline void Epoch::flush()
+{
+    State& state = Epoch::state();
+    for (int i = 0; i < 3; ++i)
+        try_advance(state);
+    collect(local(), state.epoch.load(std::memory_order_seq_cst));
+}
+
+inline std::size_t Epoch::pending() noexcept
+{
+    return state().pending.load(std::memory_order_relaxed);
+}
+
+inline bool Epoch::try_advance(State& state)
+{
+    std::vector<RetiredObject> ready;
+    bool advanced = true;
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        const std::uint64_t epoch = state.epoch.load(std::memory_order_seq_cst);
+        for (const EpochRecord* record : state.records)
+        {
+            const std::uint64_t announced = record->state.load(std::memory_order_seq_cst);
+            if ((announced & 1) && (announced >> 1) != epoch)
+            {
+                advanced = false;
+                break;
+            }
+        }
+        if (advanced)
+            state.epoch.store(epoch + 1, std::memory_order_seq_cst);
+
+        const std::uint64_t now = state.epoch.load(std::memory_order_relaxed);
+        auto safe = [now](const Orphan& orphan) { return orphan.epoch + 2 <= now; };
+        for (const Orphan& orphan : state.orphans)
+        {
+            if (safe(orphan))
+                ready.push_back(orphan.object);
+        }
+        state.orphans.erase(std::remove_if(state.orphans.begin(), state.orphans.end(), safe), state.orphans.end());
+    }
+    free_bag(ready);
+    return advanced;
+}
+
+inline void Epoch::collect(EpochRecord& record, const std::uint64_t epoch) noexcept
+{
+    for (int i = 0; i < 3; ++i)
+    {
+        if (!record.bags[i].empty() && record.bag_epochs[i] + 2 <= epoch)
+            free_bag(record.bags[i]);
+    }
+}
+
+inline void Epoch::free_bag(std::vector<RetiredObject>& bag) noexcept
+{
+    // Destructors may retire more objects, so work on a detached bag.
+    std::vector<RetiredObject> objects;
+    objects.swap(bag);
+    for (const RetiredObject& object : objects)
+        object.destroy(object.pointer);
+    state().pending.fetch_sub(objects.size(), std::memory_order_relaxed);
+}
+
+inline EpochGuard::EpochGuard() noexcept
+{
+    Epoch::enter();
+}
+
+inline EpochGuard::~EpochGuard() noexcept
+{
+    Epoch::exit();
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+struct RetiredObject
+{
+    void* pointer;
+    void (*destroy)(void* pointer) noexcept;
+};
+
+class EpochRecord
+{
+public:
+    // Epoch the thread announced, shifted left by one; the low bit is set
+    // while the thread is inside a guard.
+    std::atomic<std::uint64_t> state;
+    int depth;
+    std::vector<RetiredObject> bags[3];
+    std::uint64_t bag_epochs[3];
+    std::size_t retired_since_advance;
+
+    EpochRecord();
+    EpochRecord(const EpochRecord&) = delete;
+    EpochRecord& operator=(const EpochRecord&) = delete;
+    ~EpochRecord();
+};
+
+// Epoch-based reclamation for lock-free structures. Readers bracket every
+// access with an EpochGuard. An unlinked object is retire()d into a bag
+// tagged with the current global epoch, and is destroyed once the epoch
+// has moved on twice: the epoch only advances when every thread inside a
+// guard has announced the current one, so after two advances nobody can
+// still hold a pointer obtained before the retire.
+class Epoch
+{
+public:
+    static const std::size_t advance_interval = 64;
+
+    static void enter() noexcept;
+    static void exit() noexcept;
+    static void retire(void* pointer, void (*destroy)(void*) noexcept);
+    template <typename T>
+    static void retire(T* pointer);
+
+    // Advances as far as the other threads allow and frees what that
+    // makes safe. Must be called outside a guard.
+    static void flush();
+    static std::size_t pending() noexcept;
+
+private:
+    struct Orphan
+    {
+        std::uint64_t epoch;
+        RetiredObject object;
+    };
+
+    struct State
+    {
+        std::mutex mutex;
+        std::atomic<std::uint64_t> epoch{3};
+        std::atomic<std::size_t> pending{0};
+        std::vector<EpochRecord*> records;
+        std::vector<Orphan> orphans;
+    };
+
+    static State& state() noexcept;
+    static EpochRecord& local();
+    static bool try_advance(State& state);
+    static void collect(EpochRecord& record, std::uint64_t epoch) noexcept;
+    static void free_bag(std::vector<RetiredObject>& bag) noexcept;
+
+    template <typename T>
+    static void destroy_object(void* pointer) noexcept;
+
+    friend class EpochRecord;
+};
+
+class EpochGuard
+{
+public:
+    EpochGuard() noexcept;
+    EpochGuard(const EpochGuard&) = delete;
+    EpochGuard& operator=(const EpochGuard&) = delete;
+    ~EpochGuard() noexcept;
+};
+
+#include "epoch-inl.h"
@@ -0,0 +1,371 @@
+#include <new>
+
+template <typename K, typename V>
+SkipListMap<K, V>::Iterator::Iterator(Node* const node, const K* const to) noexcept
+{
+    this->node = node;
+    this->to = to;
+    settle();
+}
+
+template <typename K, typename V>
+void SkipListMap<K, V>::Iterator::settle() noexcept
+{
+    // Skip deleted nodes; their frozen next pointers still lead forward.
+    while (node && marked(node->next[0].load(std::memory_order_acquire)))
+        node = pointer(node->next[0].load(std::memory_order_acquire));
+    if (node && !(node->key < *to))
+        node = nullptr;
+}
+
+template <typename K, typename V>
+std::pair<const K&, SharedPtr<V>> SkipListMap<K, V>::Iterator::operator*() const noexcept
+{
+    return std::pair<const K&, SharedPtr<V>>(node->key, node->box.load(std::memory_order_acquire)->value);
+}
+
+template <typename K, typename V>
+typename SkipListMap<K, V>::Iterator& SkipListMap<K, V>::Iterator::operator++() noexcept
+{
+    node = pointer(node->next[0].load(std::memory_order_acquire));
+    settle();
+    return *this;
+}
+
+template <typename K, typename V>
+bool SkipListMap<K, V>::Iterator::operator==(const Iterator& other) const noexcept
+{
+    return node == other.node;
+}
+
+template <typename K, typename V>
+bool SkipListMap<K, V>::Iterator::operator!=(const Iterator& other) const noexcept
+{
+    return node != other.node;
+}
+
+template <typename K, typename V>
+SkipListMap<K, V>::Range::Range(const SkipListMap& map, const K& from, const K& to) : to(to)
+{
+    first = map.lower_bound(from);
+}
+
+template <typename K, typename V>
+typename SkipListMap<K, V>::Iterator SkipListMap<K, V>::Range::begin() const noexcept
+{
+    return Iterator(first, &to);
+}
+
+template <typename K, typename V>
+typename SkipListMap<K, V>::Iterator SkipListMap<K, V>::Range::end() const noexcept
+{
+    return Iterator(nullptr, &to);
+}
+
+template <typename K, typename V>
+SkipListMap<K, V>::SkipListMap()
+{
+    head = create_node(K(), nullptr, max_height);
+    count.store(0, std::memory_order_relaxed);
+}
+
+template <typename K, typename V>
+SkipListMap<K, V>::~SkipListMap() noexcept
+{
+    // Erased nodes were unlinked before they were retired, so level 0 holds
+    // exactly the nodes the map still owns.
+    Node* node = head;
+    while (node)
+    {
+        Node* next = pointer(node->next[0].load(std::memory_order_relaxed));
+        destroy_node(node);
+        node = next;
+    }
+}
+
+template <typename K, typename V>
+bool SkipListMap<K, V>::marked(const std::uintptr_t link) noexcept
+{
+    return (link & 1) != 0;
+}
+
+template <typename K, typename V>
+typename SkipListMap<K, V>::Node* SkipListMap<K, V>::pointer(const std::uintptr_t link) noexcept
+{
+    return reinterpret_cast<Node*>(link & ~std::uintptr_t(1));
+}
+
+template <typename K, typename V>
+std::uintptr_t SkipListMap<K, V>::link(Node* const node) noexcept
+{
+    return reinterpret_cast<std::uintptr_t>(node);
+}
+
+template <typename K, typename V>
+bool SkipListMap<K, V>::equal(const K& left, const K& right)
+{
+    return !(left < right) && !(right < left);
+}
+
+template <typename K, typename V>
+typename SkipListMap<K, V>::Node* SkipListMap<K, V>::create_node(const K& key, Box* const box, const int height)
+{
+    void* memory = ::operator new(sizeof(Node) + (height - 1) * sizeof(std::atomic<std::uintptr_t>));
+    Node* node = static_cast<Node*>(memory);
+    try
+    {
+        new (&node->key) K(key);
+    }
+    catch (...)
+    {
+        ::operator delete(memory);
+        throw;
+    }
+    new (&node->box) std::atomic<Box*>(box);
+    new (&node->lifecycle) std::atomic<int>(0);
+    node->height = height;
+    for (int level = 0; level < height; ++level)
+        new (&node->next[level]) std::atomic<std::uintptr_t>(0);
+    return node;
+}
+
+template <typename K, typename V>
+void SkipListMap<K, V>::destroy_node(void* const pointer) noexcept
+{
+    Node* node = static_cast<Node*>(pointer);
+    delete node->box.load(std::memory_order_relaxed);
+    node->key.~K();
+    ::operator delete(pointer);
+}
+
+template <typename K, typename V>
+int SkipListMap<K, V>::random_height() noexcept
+{
+    static thread_local std::uint64_t seed = 0x9e3779b97f4a7c15ull ^ reinterpret_cast<std::uintptr_t>(&seed);
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    return 1 + __builtin_ctzll(seed | (std::uint64_t(1) << (max_height - 1)));
+}
+
+template <typename K, typename V>
+typename SkipListMap<K, V>::Node* SkipListMap<K, V>::lower_bound(const K& key) const
+{
+    // Read-only descent: marked nodes are stepped over, never unlinked.
+    Node* pred = head;
+    Node* curr = nullptr;
+    for (int level = max_height - 1; level >= 0; --level)
+    {
+        curr = pointer(pred->next[level].load(std::memory_order_acquire));
+        while (curr)
+        {
+            const std::uintptr_t succ = curr->next[level].load(std::memory_order_acquire);
+            if (marked(succ))
+            {
+                curr = pointer(succ);
+                continue;
+            }
+            if (!(curr->key < key))
+                break;
+            pred = curr;
+            curr = pointer(succ);
+        }
+    }
+    return curr;
+}
+
+template <typename K, typename V>
+bool SkipListMap<K, V>::try_find(const K& key, Node** const preds, Node** const succs)
+{
+    Node* pred = head;
+    for (int level = max_height - 1; level >= 0; --level)
+    {
+        // A pred deleted since we stepped onto it may miss later inserts
+        // behind its frozen pointer; start over instead.
+        const std::uintptr_t first = pred->next[level].load(std::memory_order_acquire);
+        if (marked(first))
+            return false;
+
+        Node* curr = pointer(first);
+        while (curr)
+        {
+            std::uintptr_t succ = curr->next[level].load(std::memory_order_acquire);
+            if (marked(succ))
+            {
+                std::uintptr_t expected = link(curr);
+                if (!pred->next[level].compare_exchange_strong(expected, succ & ~std::uintptr_t(1), std::memory_order_acq_rel,
+                                                               std::memory_order_acquire))
+                    return false;
+                curr = pointer(succ);
+                continue;
+            }
+            if (!(curr->key < key))
+                break;
+            pred = curr;
+            curr = pointer(succ);
+        }
+        preds[level] = pred;
+        succs[level] = curr;
+    }
+    return true;
+}
+
+template <typename K, typename V>
+bool SkipListMap<K, V>::find(const K& key, Node** const preds, Node** const succs)
+{
+    while (!try_find(key, preds, succs))
+        ;
+    return succs[0] && equal(succs[0]->key, key);
+}
+
+template <typename K, typename V>
+SharedPtr<V> SkipListMap<K, V>::get(const K& key) const
+{
+    EpochGuard guard;
+    Node* node = lower_bound(key);
+    if (!node || !equal(node->key, key))
+        return SharedPtr<V>();
+    return node->box.load(std::memory_order_acquire)->value;
+}
+
+template <typename K, typename V>
+bool SkipListMap<K, V>::contains(const K& key) const
+{
+    EpochGuard guard;
+    Node* node = lower_bound(key);
+    return node && equal(node->key, key);
+}
+
+template <typename K, typename V>
+bool SkipListMap<K, V>::put(const K& key, SharedPtr<V> value)
+{
+    EpochGuard guard;
+    Node* preds[max_height];
+    Node* succs[max_height];
+    Box* box = new Box{std::move(value)};
+    Node* node = nullptr;
+    while (true)
+    {
+        if (find(key, preds, succs))
+        {
+            Box* old = succs[0]->box.exchange(box, std::memory_order_acq_rel);
+            Epoch::retire(old);
+            if (node)
+            {
+                node->box.store(nullptr, std::memory_order_relaxed);
+                destroy_node(node);
+            }
+            return false;
+        }
+
+        if (!node)
+        {
+            try
+            {
+                node = create_node(key, box, random_height());
+            }
+            catch (...)
+            {
+                delete box;
+                throw;
+            }
+        }
+        for (int level = 0; level < node->height; ++level)
+            node->next[level].store(link(succs[level]), std::memory_order_relaxed);
+
+        std::uintptr_t expected = link(succs[0]);
+        if (preds[0]->next[0].compare_exchange_strong(expected, link(node), std::memory_order_release, std::memory_order_relaxed))
+            break;
+    }
+
+    count.fetch_add(1, std::memory_order_relaxed);
+    link_levels(node, preds, succs);
+    if (node->lifecycle.fetch_or(linked, std::memory_order_acq_rel) & erased)
+        finish(node);
+    return true;
+}
+
+template <typename K, typename V>
+void SkipListMap<K, V>::link_levels(Node* const node, Node** const preds, Node** const succs)
+{
+    for (int level = 1; level < node->height; ++level)
+    {
+        while (true)
+        {
+            // Nobody else writes an unlinked level except to mark it, so a
+            // failed exchange means the node is being erased.
+            std::uintptr_t current = node->next[level].load(std::memory_order_acquire);
+            if (marked(current))
+                return;
+            if (current != link(succs[level]) &&
+                !node->next[level].compare_exchange_strong(current, link(succs[level]), std::memory_order_acq_rel))
+                return;
+
+            std::uintptr_t expected = link(succs[level]);
+            if (preds[level]->next[level].compare_exchange_strong(expected, link(node), std::memory_order_release,
+                                                                  std::memory_order_relaxed))
+                break;
+            find(node->key, preds, succs);
+            if (succs[0] != node)
+                return;
+        }
+    }
+}
+
+template <typename K, typename V>
+bool SkipListMap<K, V>::erase(const K& key)
+{
+    EpochGuard guard;
+    Node* preds[max_height];
+    Node* succs[max_height];
+    if (!find(key, preds, succs))
+        return false;
+
+    Node* node = succs[0];
+    for (int level = node->height - 1; level > 0; --level)
+        node->next[level].fetch_or(1, std::memory_order_acq_rel);
+
+    // Marking level 0 is what removes the key; only one eraser wins it.
+    std::uintptr_t next = node->next[0].load(std::memory_order_acquire);
+    while (!marked(next))
+    {
+        if (node->next[0].compare_exchange_weak(next, next | 1, std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            count.fetch_sub(1, std::memory_order_relaxed);
+            if (node->lifecycle.fetch_or(erased, std::memory_order_acq_rel) & linked)
+                finish(node);
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename K, typename V>
+void SkipListMap<K, V>::finish(Node* const node)
+{
+    // Both the insert and the erase are done touching the links, so one
+    // more search unlinks the node from every level it reached.
+    Node* preds[max_height];
+    Node* succs[max_height];
+    find(node->key, preds, succs);
+    Epoch::retire(node, &SkipListMap::destroy_node);
+}
+
+template <typename K, typename V>
+typename SkipListMap<K, V>::Range SkipListMap<K, V>::range(const K& from, const K& to) const
+{
+    return Range(*this, from, to);
+}
+
+template <typename K, typename V>
+std::size_t SkipListMap<K, V>::size() const noexcept
+{
+    const long value = count.load(std::memory_order_relaxed);
+    return value > 0 ? static_cast<std::size_t>(value) : 0;
+}
+
+template <typename K, typename V>
+bool SkipListMap<K, V>::empty() const noexcept
+{
+    return size() == 0;
+}
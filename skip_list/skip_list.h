@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "../shared_ptr/shared.h"
+#include "epoch.h"
+
+// Lock-free ordered map (Fraser's skip list). A node is deleted by marking
+// the low bit of its next pointers, top level first; marked nodes are
+// unlinked by whichever search runs into them. Unlinked nodes and replaced
+// values are handed to Epoch, so a reader never touches freed memory, and
+// values are SharedPtrs, so whatever a reader took out stays valid after
+// the key is erased or overwritten.
+template <typename K, typename V>
+class SkipListMap
+{
+private:
+    struct Box
+    {
+        SharedPtr<V> value;
+    };
+
+    struct Node
+    {
+        K key;
+        std::atomic<Box*> box;
+        // linked: the inserter is done linking levels; erased: level 0 is
+        // marked. Whoever sets the second bit unlinks and retires the node.
+        std::atomic<int> lifecycle;
+        int height;
+        std::atomic<std::uintptr_t> next[1];
+    };
+
+    static constexpr int linked = 1;
+    static constexpr int erased = 2;
+
+public:
+    static constexpr int max_height = 20;
+
+    class Iterator
+    {
+    private:
+        Node* node;
+        const K* to;
+
+        void settle() noexcept;
+
+    public:
+        Iterator(Node* node, const K* to) noexcept;
+
+        std::pair<const K&, SharedPtr<V>> operator*() const noexcept;
+        Iterator& operator++() noexcept;
+        bool operator==(const Iterator& other) const noexcept;
+        bool operator!=(const Iterator& other) const noexcept;
+    };
+
+    // Keys in [from, to) in order. The walk is weakly consistent: it never
+    // returns a key twice or out of order, and may or may not reflect
+    // updates made while it runs. The range pins the current epoch, so
+    // keep it short-lived.
+    class Range
+    {
+    private:
+        EpochGuard guard;
+        Node* first;
+        K to;
+
+    public:
+        Range(const SkipListMap& map, const K& from, const K& to);
+
+        Iterator begin() const noexcept;
+        Iterator end() const noexcept;
+    };
+
+    SkipListMap();
+    SkipListMap(const SkipListMap&) = delete;
+    SkipListMap& operator=(const SkipListMap&) = delete;
+    ~SkipListMap() noexcept;
+
+    // Empty when the key is absent.
+    SharedPtr<V> get(const K& key) const;
+    bool contains(const K& key) const;
+    // Inserts or replaces; true if the key was new.
+    bool put(const K& key, SharedPtr<V> value);
+    bool erase(const K& key);
+    Range range(const K& from, const K& to) const;
+    // Approximate under concurrent updates.
+    std::size_t size() const noexcept;
+    bool empty() const noexcept;
+
+private:
+    Node* head;
+    std::atomic<long> count;
+
+    static bool marked(std::uintptr_t link) noexcept;
+    static Node* pointer(std::uintptr_t link) noexcept;
+    static std::uintptr_t link(Node* node) noexcept;
+    static bool equal(const K& left, const K& right);
+
+    static Node* create_node(const K& key, Box* box, int height);
+    static void destroy_node(void* node) noexcept;
+    static int random_height() noexcept;
+
+    Node* lower_bound(const K& key) const;
+    bool try_find(const K& key, Node** preds, Node** succs);
+    bool find(const K& key, Node** preds, Node** succs);
+    void link_levels(Node* node, Node** preds, Node** succs);
+    void finish(Node* node);
+};
+
+#include "skip_list-inl.h"
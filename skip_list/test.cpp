@@ -0,0 +1,195 @@
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "skip_list.h"
+
+
+struct Tracked
+{
+    static std::atomic<int> alive;
+
+    int value;
+
+    explicit Tracked(int value) : value(value)
+    {
+        alive.fetch_add(1);
+    }
+
+    ~Tracked()
+    {
+        alive.fetch_sub(1);
+    }
+};
+
+std::atomic<int> Tracked::alive(0);
+
+
+TEST(SkipListMapTest, PutGetErase)
+{
+    SkipListMap<int, std::string> map;
+    EXPECT_TRUE(map.empty());
+    EXPECT_TRUE(map.put(2, SharedPtr<std::string>(new std::string("two"))));
+    EXPECT_TRUE(map.put(1, SharedPtr<std::string>(new std::string("one"))));
+    EXPECT_EQ(map.size(), 2u);
+    EXPECT_EQ(*map.get(1), "one");
+    EXPECT_EQ(*map.get(2), "two");
+    EXPECT_FALSE(map.get(3));
+
+    EXPECT_TRUE(map.erase(1));
+    EXPECT_FALSE(map.erase(1));
+    EXPECT_FALSE(map.contains(1));
+    EXPECT_TRUE(map.contains(2));
+    EXPECT_EQ(map.size(), 1u);
+}
+
+
+TEST(SkipListMapTest, PutReplacesValue)
+{
+    SkipListMap<int, int> map;
+    EXPECT_TRUE(map.put(7, SharedPtr<int>(new int(1))));
+    SharedPtr<int> old = map.get(7);
+    EXPECT_FALSE(map.put(7, SharedPtr<int>(new int(2))));
+    EXPECT_EQ(*map.get(7), 2);
+    EXPECT_EQ(*old, 1);
+    EXPECT_EQ(map.size(), 1u);
+}
+
+
+TEST(SkipListMapTest, ValueOutlivesErase)
+{
+    {
+        SkipListMap<int, Tracked> map;
+        map.put(5, SharedPtr<Tracked>(new Tracked(50)));
+        SharedPtr<Tracked> held = map.get(5);
+        EXPECT_TRUE(map.erase(5));
+        Epoch::flush();
+        EXPECT_EQ(held->value, 50);
+        EXPECT_EQ(Tracked::alive.load(), 1);
+    }
+    Epoch::flush();
+    EXPECT_EQ(Tracked::alive.load(), 0);
+}
+
+
+TEST(SkipListMapTest, RangeIsOrderedAndBounded)
+{
+    SkipListMap<int, int> map;
+    for (int i = 99; i >= 0; --i)
+        map.put(i * 2, SharedPtr<int>(new int(i)));
+    map.erase(20);
+
+    std::vector<int> keys;
+    for (auto entry : map.range(15, 31))
+    {
+        keys.push_back(entry.first);
+        EXPECT_EQ(*entry.second * 2, entry.first);
+    }
+    EXPECT_EQ(keys, (std::vector<int>{16, 18, 22, 24, 26, 28, 30}));
+
+    int count = 0;
+    for (auto entry : map.range(1000, 2000))
+        count += entry.first;
+    EXPECT_EQ(count, 0);
+}
+
+
+TEST(SkipListMapTest, ErasedNodesAreReclaimed)
+{
+    Epoch::flush();
+    const int before = Tracked::alive.load();
+    SkipListMap<int, Tracked> map;
+    for (int i = 0; i < 1000; ++i)
+        map.put(i, SharedPtr<Tracked>(new Tracked(i)));
+    for (int i = 0; i < 1000; i += 2)
+        map.erase(i);
+    for (int i = 1; i < 1000; i += 2)
+        map.put(i, SharedPtr<Tracked>(new Tracked(-i)));
+
+    Epoch::flush();
+    EXPECT_EQ(Tracked::alive.load() - before, 500);
+    EXPECT_EQ(Epoch::pending(), 0u);
+}
+
+
+TEST(SkipListMapTest, ConcurrentWritersKeepEveryKey)
+{
+    SkipListMap<int, int> map;
+    const int threads = 4;
+    const int per_thread = 5000;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&map, t]() {
+            for (int i = 0; i < per_thread; ++i)
+                map.put(i * threads + t, SharedPtr<int>(new int(t)));
+            for (int i = 0; i < per_thread; i += 2)
+                EXPECT_TRUE(map.erase(i * threads + t));
+        });
+    }
+    for (std::thread& worker : workers)
+        worker.join();
+
+    EXPECT_EQ(map.size(), static_cast<std::size_t>(threads * per_thread / 2));
+    int previous = -1;
+    std::size_t seen = 0;
+    for (auto entry : map.range(0, threads * per_thread))
+    {
+        EXPECT_LT(previous, entry.first);
+        EXPECT_EQ(entry.first / threads % 2, 1);
+        EXPECT_EQ(*entry.second, entry.first % threads);
+        previous = entry.first;
+        ++seen;
+    }
+    EXPECT_EQ(seen, map.size());
+}
+
+
+TEST(SkipListMapTest, ReadersSeeLiveValuesDuringChurn)
+{
+    SkipListMap<int, Tracked> map;
+    std::atomic<bool> done(false);
+    std::thread writer([&]() {
+        for (int round = 0; round < 200; ++round)
+        {
+            for (int key = 0; key < 64; ++key)
+                map.put(key, SharedPtr<Tracked>(new Tracked(key)));
+            for (int key = 0; key < 64; key += 3)
+                map.erase(key);
+        }
+        done.store(true);
+    });
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r)
+    {
+        readers.emplace_back([&]() {
+            while (!done.load())
+            {
+                for (int key = 0; key < 64; ++key)
+                {
+                    SharedPtr<Tracked> value = map.get(key);
+                    if (value)
+                    {
+                        EXPECT_EQ(value->value, key);
+                    }
+                }
+                int previous = -1;
+                for (auto entry : map.range(0, 64))
+                {
+                    EXPECT_LT(previous, entry.first);
+                    EXPECT_EQ(entry.second->value, entry.first);
+                    previous = entry.first;
+                }
+            }
+        });
+    }
+    writer.join();
+    for (std::thread& reader : readers)
+        reader.join();
+
+    Epoch::flush();
+    EXPECT_EQ(Epoch::pending(), 0u);
+    EXPECT_EQ(static_cast<std::size_t>(Tracked::alive.load()), map.size());
+}
@@ -0,0 +1,113 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "small_alloc.h"
+
+
+struct Malloc
+{
+    static void* allocate(std::size_t size) { return std::malloc(size); }
+    static void deallocate(void* pointer) { std::free(pointer); }
+};
+
+struct Small
+{
+    static void* allocate(std::size_t size) { return SmallAlloc::allocate(size); }
+    static void deallocate(void* pointer) { SmallAlloc::deallocate(pointer); }
+};
+
+
+struct Payload
+{
+    long values[6];
+};
+
+struct PlainPayload
+{
+    long values[6];
+};
+
+template <>
+struct UseSmallAlloc<PlainPayload> : std::false_type
+{};
+
+
+// Every thread keeps a window of live blocks and replaces a random one per
+// step, so frees interleave with allocations of other sizes.
+template <typename Allocator>
+double churn(int threads, long operations, std::size_t window)
+{
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([=]() {
+            std::vector<void*> live(window, nullptr);
+            unsigned seed = static_cast<unsigned>(t) * 2654435761u + 1;
+            for (long i = 0; i < operations; ++i)
+            {
+                seed = seed * 1664525u + 1013904223u;
+                void*& slot = live[(seed >> 8) % window];
+                Allocator::deallocate(slot);
+                slot = Allocator::allocate(16 + (seed >> 22) % 496);
+                *static_cast<char*>(slot) = 1;
+            }
+            for (void* pointer : live)
+                Allocator::deallocate(pointer);
+        });
+    }
+    for (std::thread& worker : workers)
+        worker.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return seconds * 1e9 / (static_cast<double>(operations) * threads);
+}
+
+
+template <typename T>
+double make_unique_churn(int threads, long operations, std::size_t window)
+{
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([=]() {
+            std::vector<UniquePtr<T, SmallDelete<T>>> live(window);
+            unsigned seed = static_cast<unsigned>(t) * 2654435761u + 1;
+            for (long i = 0; i < operations; ++i)
+            {
+                seed = seed * 1664525u + 1013904223u;
+                live[(seed >> 8) % window] = MakeUnique<T>();
+            }
+        });
+    }
+    for (std::thread& worker : workers)
+        worker.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return seconds * 1e9 / (static_cast<double>(operations) * threads);
+}
+
+
+int main(int argc, char** argv)
+{
+    const int max_threads = argc > 1 ? std::atoi(argv[1]) : static_cast<int>(std::max(2u, std::thread::hardware_concurrency()));
+    const long operations = argc > 2 ? std::atol(argv[2]) : 4000000;
+    const std::size_t window = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 4096;
+
+    // Faults in both heaps before anything is timed.
+    churn<Malloc>(1, operations, window);
+    churn<Small>(1, operations, window);
+
+    std::printf("%ld replacements per thread, window of %zu live blocks; ns per replacement\n", operations, window);
+    std::printf("%8s %12s %12s %18s %18s\n", "threads", "malloc", "SmallAlloc", "MakeUnique opt-out", "MakeUnique pooled");
+    for (int threads = 1; threads <= max_threads; threads *= 2)
+    {
+        double glibc = churn<Malloc>(threads, operations, window);
+        double small = churn<Small>(threads, operations, window);
+        double plain = make_unique_churn<PlainPayload>(threads, operations, window);
+        double pooled = make_unique_churn<Payload>(threads, operations, window);
+        std::printf("%8d %12.1f %12.1f %18.1f %18.1f\n", threads, glibc, small, plain, pooled);
+    }
+    return 0;
+}
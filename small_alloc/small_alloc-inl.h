@@ -0,0 +1,392 @@
+#include <sys/mman.h>
+#include <cerrno>
+#include <new>
+#include <system_error>
+#include <utility>
+
+inline SmallAlloc::State::State()
+{
+    void* region = mmap(nullptr, region_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (region == MAP_FAILED)
+        throw std::system_error(errno, std::generic_category(), "mmap");
+    const std::size_t map_bytes = (region_size >> page_shift) * sizeof(SmallSpan*);
+    void* map = mmap(nullptr, map_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (map == MAP_FAILED)
+    {
+        const int error = errno;
+        munmap(region, region_size);
+        throw std::system_error(error, std::generic_category(), "mmap");
+    }
+
+    base = static_cast<char*>(region);
+    page_map = static_cast<SmallSpan**>(map);
+    next_page = 0;
+    for (SmallSpan*& head : free_spans)
+        head = nullptr;
+    for (CentralList& list : central)
+    {
+        list.nonempty.prev = &list.nonempty;
+        list.nonempty.next = &list.nonempty;
+    }
+    SmallAlloc::region().store(reinterpret_cast<std::uintptr_t>(base), std::memory_order_release);
+}
+
+inline SmallThreadCache::SmallThreadCache() noexcept
+{
+    for (std::size_t i = 0; i < SmallAlloc::class_count; ++i)
+    {
+        lists[i].head = nullptr;
+        lists[i].length = 0;
+        lists[i].limit = static_cast<std::uint32_t>(2 * SmallAlloc::batch_size(i));
+    }
+}
+
+inline SmallThreadCache::~SmallThreadCache()
+{
+    // Objects freed by later thread_local destructors of this thread go
+    // straight to the central lists.
+    SmallAlloc::ThreadSlot& slot = SmallAlloc::slot();
+    slot.cache = nullptr;
+    slot.exited = true;
+    for (std::size_t i = 0; i < SmallAlloc::class_count; ++i)
+        SmallAlloc::release_list(lists[i], i, lists[i].length);
+}
+
+inline SmallAlloc::State& SmallAlloc::state()
+{
+    // Never destroyed: objects may be freed by static destructors that run
+    // after this one would.
+    static State& state = *new State();
+    return state;
+}
+
+inline std::atomic<std::uintptr_t>& SmallAlloc::region() noexcept
+{
+    static std::atomic<std::uintptr_t> base(0);
+    return base;
+}
+
+inline SmallAlloc::ThreadSlot& SmallAlloc::slot() noexcept
+{
+    static thread_local ThreadSlot slot = {nullptr, false};
+    return slot;
+}
+
+inline SmallThreadCache* SmallAlloc::local()
+{
+    ThreadSlot& slot = SmallAlloc::slot();
+    if (slot.cache || slot.exited)
+        return slot.cache;
+
+    static thread_local SmallThreadCache cache;
+    slot.cache = &cache;
+    return slot.cache;
+}
+
+inline std::size_t SmallAlloc::size_class(const std::size_t size) noexcept
+{
+    // Steps of 16 bytes up to 128, then four classes per power of two.
+    if (size <= 128)
+        return size == 0 ? 0 : (size - 1) / 16;
+
+    const std::size_t last = size - 1;
+    std::size_t log = 7;
+    while (last >> (log + 1))
+        ++log;
+    return 8 + (log - 7) * 4 + ((last >> (log - 2)) & 3);
+}
+
+inline std::size_t SmallAlloc::class_size(const std::size_t size_class) noexcept
+{
+    if (size_class < 8)
+        return (size_class + 1) * 16;
+
+    const std::size_t step = size_class - 8;
+    return (5 + step % 4) << (7 + step / 4 - 2);
+}
+
+inline std::size_t SmallAlloc::batch_size(const std::size_t size_class) noexcept
+{
+    const std::size_t count = 65536 / class_size(size_class);
+    return count < 2 ? 2 : count > 32 ? 32 : count;
+}
+
+inline std::size_t SmallAlloc::span_pages(const std::size_t size_class) noexcept
+{
+    const std::size_t bytes = 2 * batch_size(size_class) * class_size(size_class);
+    return (bytes + page_size - 1) / page_size;
+}
+
+inline bool SmallAlloc::owns(const void* const pointer) noexcept
+{
+    const std::uintptr_t base = region().load(std::memory_order_acquire);
+    return base != 0 && reinterpret_cast<std::uintptr_t>(pointer) - base < region_size;
+}
+
+inline SmallSpan* SmallAlloc::span_of(State& state, const void* const pointer) noexcept
+{
+    return state.page_map[static_cast<std::size_t>(static_cast<const char*>(pointer) - state.base) >> page_shift];
+}
+
+inline void* SmallAlloc::allocate(const std::size_t size)
+{
+    if (size > max_size)
+        return ::operator new(size);
+
+    const std::size_t index = size_class(size);
+    SmallThreadCache* cache = local();
+    SmallObject* object;
+    if (!cache)
+    {
+        fetch(index, 1, object);
+        return object;
+    }
+
+    SmallFreeList& list = cache->lists[index];
+    if (!list.head)
+        list.length = static_cast<std::uint32_t>(fetch(index, batch_size(index), list.head));
+    object = list.head;
+    list.head = object->next;
+    --list.length;
+    return object;
+}
+
+inline void SmallAlloc::deallocate(void* const pointer) noexcept
+{
+    if (!owns(pointer))
+    {
+        ::operator delete(pointer);
+        return;
+    }
+
+    const std::size_t index = span_of(state(), pointer)->size_class;
+    SmallObject* object = static_cast<SmallObject*>(pointer);
+    SmallThreadCache* cache = local();
+    if (!cache)
+    {
+        object->next = nullptr;
+        release(index, object);
+        return;
+    }
+
+    SmallFreeList& list = cache->lists[index];
+    object->next = list.head;
+    list.head = object;
+    if (++list.length > list.limit)
+        release_list(list, index, list.limit / 2);
+}
+
+inline void SmallAlloc::flush_thread_cache() noexcept
+{
+    SmallThreadCache* cache = slot().cache;
+    if (!cache)
+        return;
+    for (std::size_t i = 0; i < class_count; ++i)
+        release_list(cache->lists[i], i, cache->lists[i].length);
+}
+
+inline std::size_t SmallAlloc::spans_in_use() noexcept
+{
+    if (!region().load(std::memory_order_acquire))
+        return 0;
+    return state().spans_in_use.load(std::memory_order_relaxed);
+}
+
+inline void SmallAlloc::release_list(SmallFreeList& list, const std::size_t size_class, const std::size_t count) noexcept
+{
+    if (count == 0)
+        return;
+
+    SmallObject* head = list.head;
+    SmallObject* tail = head;
+    for (std::size_t i = 1; i < count; ++i)
+        tail = tail->next;
+    list.head = tail->next;
+    list.length -= static_cast<std::uint32_t>(count);
+    tail->next = nullptr;
+    release(size_class, head);
+}
+
+inline std::size_t SmallAlloc::fetch(const std::size_t size_class, const std::size_t count, SmallObject*& head)
+{
+    State& state = SmallAlloc::state();
+    CentralList& central = state.central[size_class];
+    std::lock_guard<std::mutex> lock(central.mutex);
+
+    SmallObject* chain = nullptr;
+    std::size_t fetched = 0;
+    while (fetched < count)
+    {
+        SmallSpan* span = central.nonempty.next;
+        if (span == &central.nonempty)
+        {
+            // Only the first object is required; a short batch is fine.
+            if (fetched != 0)
+                break;
+            span = allocate_span(state, size_class);
+            span->prev = &central.nonempty;
+            span->next = central.nonempty.next;
+            central.nonempty.next->prev = span;
+            central.nonempty.next = span;
+        }
+
+        while (fetched < count && span->free)
+        {
+            SmallObject* object = span->free;
+            span->free = object->next;
+            object->next = chain;
+            chain = object;
+            ++span->live;
+            ++fetched;
+        }
+        if (!span->free)
+        {
+            span->prev->next = span->next;
+            span->next->prev = span->prev;
+        }
+    }
+    head = chain;
+    return fetched;
+}
+
+inline void SmallAlloc::release(const std::size_t size_class, SmallObject* head) noexcept
+{
+    State& state = SmallAlloc::state();
+    CentralList& central = state.central[size_class];
+    std::lock_guard<std::mutex> lock(central.mutex);
+
+    while (head)
+    {
+        SmallObject* object = head;
+        head = head->next;
+
+        SmallSpan* span = span_of(state, object);
+        if (!span->free)
+        {
+            span->prev = &central.nonempty;
+            span->next = central.nonempty.next;
+            central.nonempty.next->prev = span;
+            central.nonempty.next = span;
+        }
+        object->next = span->free;
+        span->free = object;
+
+        if (--span->live == 0)
+        {
+            span->prev->next = span->next;
+            span->next->prev = span->prev;
+            release_span(state, span);
+        }
+    }
+}
+
+inline SmallSpan* SmallAlloc::allocate_span(State& state, const std::size_t size_class)
+{
+    const std::size_t pages = span_pages(size_class);
+    SmallSpan* span;
+    {
+        std::lock_guard<std::mutex> lock(state.heap_mutex);
+        span = state.free_spans[pages];
+        if (span)
+            state.free_spans[pages] = span->next;
+        else
+        {
+            if (state.next_page + pages > (region_size >> page_shift))
+                throw std::bad_alloc();
+            span = new SmallSpan();
+            span->first_page = state.next_page;
+            span->pages = static_cast<std::uint32_t>(pages);
+            for (std::size_t i = 0; i < pages; ++i)
+                state.page_map[state.next_page + i] = span;
+            state.next_page += pages;
+        }
+    }
+    state.spans_in_use.fetch_add(1, std::memory_order_relaxed);
+
+    // Carved in address order so a fresh batch walks memory forwards.
+    const std::size_t size = class_size(size_class);
+    const std::size_t objects = (pages << page_shift) / size;
+    char* const start = state.base + (span->first_page << page_shift);
+    SmallObject* chain = nullptr;
+    for (std::size_t i = objects; i-- > 0;)
+    {
+        SmallObject* object = reinterpret_cast<SmallObject*>(start + i * size);
+        object->next = chain;
+        chain = object;
+    }
+    span->free = chain;
+    span->live = 0;
+    span->size_class = static_cast<std::uint32_t>(size_class);
+    return span;
+}
+
+inline void SmallAlloc::release_span(State& state, SmallSpan* const span) noexcept
+{
+    std::lock_guard<std::mutex> lock(state.heap_mutex);
+    span->next = state.free_spans[span->pages];
+    state.free_spans[span->pages] = span;
+    state.spans_in_use.fetch_sub(1, std::memory_order_relaxed);
+}
+
+template <typename T>
+void* SmallAlloc::object_address(T* const pointer, std::true_type) noexcept
+{
+    return const_cast<void*>(dynamic_cast<const volatile void*>(pointer));
+}
+
+template <typename T>
+void* SmallAlloc::object_address(T* const pointer, std::false_type) noexcept
+{
+    return const_cast<void*>(static_cast<const volatile void*>(pointer));
+}
+
+template <typename T, typename... Args>
+T* SmallAlloc::create(Args&&... args)
+{
+    T* object;
+    if (!Pooled<T>::value)
+        object = new T(std::forward<Args>(args)...);
+    else
+    {
+        void* memory = allocate(sizeof(T));
+        try
+        {
+            object = new (memory) T(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            deallocate(memory);
+            throw;
+        }
+    }
+    AllocSampleHooks::allocated(object, sizeof(T));
+    return object;
+}
+
+template <typename T>
+void SmallAlloc::destroy(T* const pointer) noexcept
+{
+    // A polymorphic object may be reached through a base subobject, so the
+    // allocation is found from the most derived one.
+    void* address = pointer ? object_address(pointer, std::is_polymorphic<T>()) : nullptr;
+    AllocSampleHooks::freed(address);
+    if (!owns(address))
+    {
+        delete pointer;
+        return;
+    }
+    pointer->~T();
+    deallocate(address);
+}
+
+template <typename T>
+void SmallDelete<T>::operator()(T* const pointer) const noexcept
+{
+    SmallAlloc::destroy(pointer);
+}
+
+template <typename T, typename... Args>
+UniquePtr<T, SmallDelete<T>> MakeUnique(Args&&... args)
+{
+    return UniquePtr<T, SmallDelete<T>>(SmallAlloc::create<T>(std::forward<Args>(args)...));
+}
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <type_traits>
+#include "../alloc_sampler/sample_hooks.h"
+#include "../unique_ptr/unique.h"
+
+// Types are served by SmallAlloc from MakeUnique and MakeShared unless this
+// is specialised to std::false_type for them, e.g. for types with their own
+// operator new or that must be visible to malloc-level tooling.
+template <typename T>
+struct UseSmallAlloc : std::true_type
+{};
+
+struct SmallObject
+{
+    SmallObject* next;
+};
+
+// A run of pages carved into objects of one size class. Spans live on their
+// class's central list while they have free objects and go back to the page
+// heap once every object has been returned.
+struct SmallSpan
+{
+    SmallSpan* prev;
+    SmallSpan* next;
+    SmallObject* free;
+    std::size_t first_page;
+    std::uint32_t pages;
+    std::uint32_t live;
+    std::uint32_t size_class;
+};
+
+struct SmallFreeList
+{
+    SmallObject* head;
+    std::uint32_t length;
+    // Two batches; reaching it sends one batch back to the central list.
+    std::uint32_t limit;
+};
+
+class SmallThreadCache;
+
+// Small-object allocator in the tcmalloc mould. Sizes up to max_size are
+// rounded to one of class_count size classes. Each thread keeps a free
+// list per class and only takes a class's central lock to move a batch of
+// objects in or out; the central lists carve spans obtained from a page
+// heap inside one reserved mapping, and a page map from that mapping back
+// to spans lets deallocate() work without being told the size.
+//
+// Anything larger, or allocated while a thread is exiting, falls back to
+// operator new or the central lists respectively; deallocate() accepts
+// pointers from either source. Pages of released spans are reused for
+// spans of the same length but never returned to the kernel.
+class SmallAlloc
+{
+public:
+    static constexpr std::size_t page_shift = 13;
+    static constexpr std::size_t page_size = std::size_t(1) << page_shift;
+    static constexpr std::size_t alignment = 16;
+    static constexpr std::size_t max_size = 4096;
+    static constexpr std::size_t class_count = 28;
+    static constexpr std::size_t region_size = std::size_t(1) << 33;
+
+    static void* allocate(std::size_t size);
+    static void deallocate(void* pointer) noexcept;
+    static bool owns(const void* pointer) noexcept;
+
+    // Allocates and constructs T from the size classes, or with plain new
+    // when T opted out or is too large or over-aligned for them. Both are
+    // reported to AllocSampler, as is the matching destroy().
+    template <typename T, typename... Args>
+    static T* create(Args&&... args);
+    // Destroys an object from create() or from plain new.
+    template <typename T>
+    static void destroy(T* pointer) noexcept;
+
+    static std::size_t size_class(std::size_t size) noexcept;
+    static std::size_t class_size(std::size_t size_class) noexcept;
+    static std::size_t batch_size(std::size_t size_class) noexcept;
+
+    // Hands the calling thread's cached objects back to the central lists.
+    static void flush_thread_cache() noexcept;
+    static std::size_t spans_in_use() noexcept;
+
+private:
+    static constexpr std::size_t max_span_pages = 16;
+
+    struct CentralList
+    {
+        std::mutex mutex;
+        SmallSpan nonempty;
+    };
+
+    struct State
+    {
+        char* base;
+        SmallSpan** page_map;
+        std::size_t next_page;
+        std::mutex heap_mutex;
+        SmallSpan* free_spans[max_span_pages + 1];
+        std::atomic<std::size_t> spans_in_use{0};
+        CentralList central[class_count];
+
+        State();
+    };
+
+    struct ThreadSlot
+    {
+        SmallThreadCache* cache;
+        bool exited;
+    };
+
+    template <typename T>
+    struct Pooled : std::integral_constant<bool, UseSmallAlloc<T>::value && sizeof(T) <= max_size && alignof(T) <= alignment>
+    {};
+
+    static State& state();
+    static std::atomic<std::uintptr_t>& region() noexcept;
+    static ThreadSlot& slot() noexcept;
+    static SmallThreadCache* local();
+    static std::size_t span_pages(std::size_t size_class) noexcept;
+    static SmallSpan* span_of(State& state, const void* pointer) noexcept;
+
+    static std::size_t fetch(std::size_t size_class, std::size_t count, SmallObject*& head);
+    static void release(std::size_t size_class, SmallObject* head) noexcept;
+    static SmallSpan* allocate_span(State& state, std::size_t size_class);
+    static void release_span(State& state, SmallSpan* span) noexcept;
+    static void release_list(SmallFreeList& list, std::size_t size_class, std::size_t count) noexcept;
+
+    template <typename T>
+    static void* object_address(T* pointer, std::true_type) noexcept;
+    template <typename T>
+    static void* object_address(T* pointer, std::false_type) noexcept;
+
+    friend class SmallThreadCache;
+};
+
+class SmallThreadCache
+{
+public:
+    SmallFreeList lists[SmallAlloc::class_count];
+
+    SmallThreadCache() noexcept;
+    SmallThreadCache(const SmallThreadCache&) = delete;
+    SmallThreadCache& operator=(const SmallThreadCache&) = delete;
+    ~SmallThreadCache();
+};
+
+// Deleter for objects built by SmallAlloc::create.
+template <typename T>
+class SmallDelete
+{
+public:
+    void operator()(T* pointer) const noexcept;
+};
+
+// The object comes from SmallAlloc::create. DefaultDelete stays a plain
+// delete, so the result carries SmallDelete instead.
+template <typename T, typename... Args>
+UniquePtr<T, SmallDelete<T>> MakeUnique(Args&&... args);
+
+#include "small_alloc-inl.h"
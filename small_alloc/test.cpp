@@ -0,0 +1,176 @@
+#include <cstdint>
+#include <cstring>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../shared_ptr/shared.h"
+
+
+// Copies, so the assertions do not odr-use the class constants.
+static const std::size_t max_size = SmallAlloc::max_size;
+static const std::size_t class_count = SmallAlloc::class_count;
+static const std::size_t alignment = SmallAlloc::alignment;
+
+
+TEST(SmallAllocTest, SizeClassesCoverEverySize)
+{
+    for (std::size_t size = 1; size <= SmallAlloc::max_size; ++size)
+    {
+        const std::size_t index = SmallAlloc::size_class(size);
+        ASSERT_LT(index, class_count);
+        ASSERT_GE(SmallAlloc::class_size(index), size);
+        if (index > 0)
+        {
+            ASSERT_LT(SmallAlloc::class_size(index - 1), size);
+        }
+    }
+    EXPECT_EQ(SmallAlloc::class_size(class_count - 1), max_size);
+}
+
+
+TEST(SmallAllocTest, AllocationsAreDistinctAndAligned)
+{
+    std::vector<void*> pointers;
+    std::set<void*> unique;
+    for (std::size_t i = 0; i < 5000; ++i)
+    {
+        const std::size_t size = 1 + (i * 37) % SmallAlloc::max_size;
+        void* pointer = SmallAlloc::allocate(size);
+        EXPECT_TRUE(SmallAlloc::owns(pointer));
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(pointer) % alignment, 0u);
+        std::memset(pointer, static_cast<int>(i), size);
+        pointers.push_back(pointer);
+        unique.insert(pointer);
+    }
+    EXPECT_EQ(unique.size(), pointers.size());
+    for (void* pointer : pointers)
+        SmallAlloc::deallocate(pointer);
+}
+
+
+TEST(SmallAllocTest, LargeAndForeignPointersGoToOperatorNew)
+{
+    void* large = SmallAlloc::allocate(SmallAlloc::max_size + 1);
+    EXPECT_FALSE(SmallAlloc::owns(large));
+    SmallAlloc::deallocate(large);
+
+    int* plain = new int(3);
+    EXPECT_FALSE(SmallAlloc::owns(plain));
+    SmallAlloc::destroy(plain);
+}
+
+
+struct Base
+{
+    virtual ~Base() = default;
+    long base = 1;
+};
+
+struct Other
+{
+    virtual ~Other() = default;
+    long other = 2;
+};
+
+struct Derived : Base, Other
+{
+    static int destroyed;
+    std::string name = "derived";
+    ~Derived() override { ++destroyed; }
+};
+
+int Derived::destroyed = 0;
+
+
+TEST(SmallAllocTest, DestroyThroughSecondaryBase)
+{
+    Derived::destroyed = 0;
+    Derived* derived = SmallAlloc::create<Derived>();
+    Other* other = derived;
+    EXPECT_NE(static_cast<void*>(other), static_cast<void*>(derived));
+    SmallAlloc::destroy(other);
+    EXPECT_EQ(Derived::destroyed, 1);
+}
+
+
+struct OptedOut
+{
+    int value;
+    explicit OptedOut(int value) : value(value) {}
+};
+
+template <>
+struct UseSmallAlloc<OptedOut> : std::false_type
+{};
+
+
+TEST(SmallAllocTest, MakeFunctionsUseSizeClasses)
+{
+    UniquePtr<std::string, SmallDelete<std::string>> text = MakeUnique<std::string>(4, 'y');
+    EXPECT_EQ(*text, "yyyy");
+    EXPECT_TRUE(SmallAlloc::owns(text.get()));
+
+    UniquePtr<OptedOut, SmallDelete<OptedOut>> plain = MakeUnique<OptedOut>(7);
+    EXPECT_EQ(plain->value, 7);
+    EXPECT_FALSE(SmallAlloc::owns(plain.get()));
+
+    Derived::destroyed = 0;
+    SharedPtr<Base> shared = MakeShared<Derived>();
+    SharedPtr<OptedOut> shared_plain = MakeShared<OptedOut>(8);
+    EXPECT_FALSE(SmallAlloc::owns(shared_plain.get()));
+    EXPECT_EQ(shared_plain->value, 8);
+    shared.reset();
+    EXPECT_EQ(Derived::destroyed, 1);
+}
+
+
+TEST(SmallAllocTest, ObjectsFreedOnOtherThreadsReturnSpans)
+{
+    SmallAlloc::flush_thread_cache();
+    const std::size_t before = SmallAlloc::spans_in_use();
+
+    std::vector<void*> pointers;
+    for (int i = 0; i < 20000; ++i)
+        pointers.push_back(SmallAlloc::allocate(64));
+    EXPECT_GT(SmallAlloc::spans_in_use(), before);
+
+    std::thread freer([&pointers]() {
+        for (void* pointer : pointers)
+            SmallAlloc::deallocate(pointer);
+    });
+    freer.join();
+    SmallAlloc::flush_thread_cache();
+
+    EXPECT_EQ(SmallAlloc::spans_in_use(), before);
+}
+
+
+TEST(SmallAllocTest, ConcurrentChurn)
+{
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([t]() {
+            std::vector<std::uint32_t*> live(512, nullptr);
+            unsigned seed = static_cast<unsigned>(t) + 1;
+            for (int i = 0; i < 200000; ++i)
+            {
+                seed = seed * 1664525u + 1013904223u;
+                std::uint32_t*& slot = live[(seed >> 8) % live.size()];
+                if (slot)
+                {
+                    ASSERT_EQ(*slot, reinterpret_cast<std::uintptr_t>(&slot) & 0xffffffffu);
+                    SmallAlloc::deallocate(slot);
+                }
+                slot = static_cast<std::uint32_t*>(SmallAlloc::allocate(4 + (seed >> 20) % 1024));
+                *slot = reinterpret_cast<std::uintptr_t>(&slot) & 0xffffffffu;
+            }
+            for (std::uint32_t* pointer : live)
+                SmallAlloc::deallocate(pointer);
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+}
@@ -0,0 +1,124 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+#include "timer_wheel.h"
+#include "../unique_ptr/unique.h"
+
+
+struct Job
+{
+    long value;
+    bool cancelled;
+};
+
+typedef UniquePtr<Job> JobPtr;
+
+
+struct Timings
+{
+    double schedule;
+    double expire;
+    long sum;
+};
+
+
+static double seconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+// The existing approach: a binary heap of heap-allocated callbacks, with
+// cancelled timers skipped when they reach the top.
+Timings run_heap(const std::vector<std::uint64_t>& delays, std::uint64_t step)
+{
+    typedef std::pair<std::uint64_t, JobPtr> Timer;
+    auto later = [](const Timer& a, const Timer& b) { return a.first > b.first; };
+    std::vector<Timer> heap;
+    std::vector<Job*> jobs;
+    Timings timings = {0, 0, 0};
+    heap.reserve(delays.size());
+    jobs.reserve(delays.size());
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < delays.size(); ++i)
+    {
+        JobPtr job(new Job{static_cast<long>(i), false});
+        jobs.push_back(job.get());
+        heap.emplace_back(delays[i], std::move(job));
+        std::push_heap(heap.begin(), heap.end(), later);
+    }
+    for (std::size_t i = 0; i < jobs.size(); i += 4)
+        jobs[i]->cancelled = true;
+    timings.schedule = seconds_since(start);
+
+    start = std::chrono::steady_clock::now();
+    for (std::uint64_t now = step; !heap.empty(); now += step)
+    {
+        while (!heap.empty() && heap.front().first <= now)
+        {
+            std::pop_heap(heap.begin(), heap.end(), later);
+            if (!heap.back().second->cancelled)
+                timings.sum += heap.back().second->value;
+            heap.pop_back();
+        }
+    }
+    timings.expire = seconds_since(start);
+    return timings;
+}
+
+
+Timings run_wheel(const std::vector<std::uint64_t>& delays, std::uint64_t step)
+{
+    TimerWheel<JobPtr> wheel;
+    std::vector<TimerHandle> handles;
+    Timings timings = {0, 0, 0};
+    wheel.reserve(delays.size());
+    handles.reserve(delays.size());
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < delays.size(); ++i)
+        handles.push_back(wheel.schedule(delays[i], JobPtr(new Job{static_cast<long>(i), false})));
+    for (std::size_t i = 0; i < handles.size(); i += 4)
+        wheel.cancel(handles[i]);
+    timings.schedule = seconds_since(start);
+
+    start = std::chrono::steady_clock::now();
+    for (std::uint64_t now = step; !wheel.empty(); now += step)
+        wheel.advance(now, [&](JobPtr& job) { timings.sum += job->value; });
+    timings.expire = seconds_since(start);
+    return timings;
+}
+
+
+int main(int argc, char** argv)
+{
+    const std::size_t timers = argc > 1 ? std::atol(argv[1]) : 10000000;
+    const std::uint64_t horizon = argc > 2 ? std::atol(argv[2]) : 60000;
+    const std::uint64_t step = argc > 3 ? std::atol(argv[3]) : 16;
+
+    std::vector<std::uint64_t> delays(timers);
+    std::uint64_t seed = 88172645463325252ull;
+    for (std::uint64_t& delay : delays)
+    {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        delay = 1 + seed % horizon;
+    }
+
+    std::printf("%zu timers over %llu ticks, a quarter cancelled, advance every %llu ticks\n", timers,
+                static_cast<unsigned long long>(horizon), static_cast<unsigned long long>(step));
+    std::printf("%-16s %22s %22s\n", "", "schedule+cancel ns/op", "expire ns/timer");
+    Timings heap = run_heap(delays, step);
+    std::printf("%-16s %22.1f %22.1f\n", "priority queue", heap.schedule * 1e9 / timers, heap.expire * 1e9 / timers);
+    Timings wheel = run_wheel(delays, step);
+    std::printf("%-16s %22.1f %22.1f\n", "TimerWheel", wheel.schedule * 1e9 / timers, wheel.expire * 1e9 / timers);
+    if (heap.sum != wheel.sum)
+        std::printf("checksum mismatch: %ld vs %ld\n", heap.sum, wheel.sum);
+    return 0;
+}
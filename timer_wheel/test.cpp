@@ -0,0 +1,152 @@
+#include <cstdint>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+#include "timer_wheel.h"
+#include "../unique_ptr/unique.h"
+
+
+struct Job
+{
+    int id;
+    std::uint64_t deadline;
+};
+
+typedef UniquePtr<Job> JobPtr;
+
+
+TEST(TimerWheelTest, FiresAtDeadline)
+{
+    TimerWheel<JobPtr> wheel;
+    wheel.schedule(5, JobPtr(new Job{1, 5}));
+    wheel.schedule(3, JobPtr(new Job{2, 3}));
+
+    std::vector<std::pair<int, std::uint64_t>> fired;
+    auto record = [&](JobPtr& job) { fired.emplace_back(job->id, wheel.now()); };
+
+    EXPECT_EQ(wheel.advance(2, record), 0u);
+    EXPECT_EQ(wheel.advance(4, record), 1u);
+    EXPECT_EQ(wheel.advance(10, record), 1u);
+    EXPECT_EQ(fired, (std::vector<std::pair<int, std::uint64_t>>{{2, 3}, {1, 5}}));
+    EXPECT_TRUE(wheel.empty());
+    EXPECT_EQ(wheel.now(), 10u);
+}
+
+
+TEST(TimerWheelTest, ZeroDelayFiresOnNextTick)
+{
+    TimerWheel<JobPtr> wheel(100);
+    wheel.schedule(0, JobPtr(new Job{1, 101}));
+    int fired = 0;
+    wheel.advance(101, [&](JobPtr&) { ++fired; });
+    EXPECT_EQ(fired, 1);
+}
+
+
+TEST(TimerWheelTest, CancelThroughHandle)
+{
+    TimerWheel<JobPtr> wheel;
+    TimerHandle first = wheel.schedule(10, JobPtr(new Job{1, 10}));
+    TimerHandle second = wheel.schedule(10, JobPtr(new Job{2, 10}));
+    EXPECT_TRUE(wheel.pending(first));
+    EXPECT_TRUE(wheel.cancel(first));
+    EXPECT_FALSE(wheel.pending(first));
+    EXPECT_FALSE(wheel.cancel(first));
+    EXPECT_EQ(wheel.size(), 1u);
+
+    std::vector<int> fired;
+    wheel.advance(20, [&](JobPtr& job) { fired.push_back(job->id); });
+    EXPECT_EQ(fired, std::vector<int>{2});
+    EXPECT_FALSE(wheel.cancel(second));
+}
+
+
+TEST(TimerWheelTest, StaleHandleDoesNotCancelReusedEntry)
+{
+    TimerWheel<JobPtr> wheel;
+    TimerHandle old = wheel.schedule(1, JobPtr(new Job{1, 1}));
+    wheel.advance(1, [](JobPtr&) {});
+    TimerHandle reused = wheel.schedule(1, JobPtr(new Job{2, 2}));
+    EXPECT_EQ(reused.index, old.index);
+    EXPECT_FALSE(wheel.cancel(old));
+    EXPECT_TRUE(wheel.pending(reused));
+}
+
+
+TEST(TimerWheelTest, CallbacksMayScheduleMore)
+{
+    TimerWheel<JobPtr> wheel;
+    wheel.schedule(1, JobPtr(new Job{0, 1}));
+    int fired = 0;
+    wheel.advance(1000, [&](JobPtr& job) {
+        ++fired;
+        if (job->id < 9)
+            wheel.schedule(100, JobPtr(new Job{job->id + 1, 0}));
+    });
+    EXPECT_EQ(fired, 10);
+    EXPECT_TRUE(wheel.empty());
+}
+
+
+TEST(TimerWheelTest, CascadesAcrossEveryLevel)
+{
+    // Delays straddle each level boundary, including one past the top
+    // level that has to be re-filed.
+    const std::vector<std::uint64_t> delays = {
+        1, 255, 256, 257, 65535, 65536, 65537, (1ull << 24) - 1, 1ull << 24, (1ull << 24) + 3,
+        (1ull << 32) - 1, 1ull << 32, (1ull << 32) + 77, 3ull << 32};
+    const std::uint64_t start = 1234567;
+    TimerWheel<std::uint64_t> wheel(start);
+    for (std::uint64_t delay : delays)
+        wheel.schedule(delay, start + delay);
+
+    std::size_t fired = 0;
+    std::uint64_t late = 0;
+    for (std::uint64_t delay : delays)
+    {
+        wheel.advance(start + delay, [&](std::uint64_t& deadline) {
+            ++fired;
+            if (deadline != wheel.now())
+                ++late;
+        });
+    }
+    EXPECT_EQ(fired, delays.size());
+    EXPECT_EQ(late, 0u);
+}
+
+
+TEST(TimerWheelTest, MatchesSortedDeadlines)
+{
+    std::mt19937_64 random(7);
+    TimerWheel<std::uint64_t> wheel;
+    std::vector<TimerHandle> handles;
+    std::vector<std::uint64_t> expected;
+    for (int i = 0; i < 20000; ++i)
+    {
+        const std::uint64_t delay = random() % 200000;
+        handles.push_back(wheel.schedule(delay, std::max<std::uint64_t>(delay, 1)));
+    }
+    for (std::size_t i = 0; i < handles.size(); ++i)
+    {
+        if (i % 3 == 0)
+        {
+            EXPECT_TRUE(wheel.cancel(handles[i]));
+        }
+    }
+
+    std::uint64_t previous = 0;
+    std::size_t fired = 0;
+    bool ordered = true;
+    while (!wheel.empty())
+    {
+        wheel.advance(wheel.now() + random() % 5000, [&](std::uint64_t& deadline) {
+            ordered = ordered && deadline == wheel.now() && deadline >= previous;
+            previous = deadline;
+            ++fired;
+        });
+    }
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(fired, handles.size() - (handles.size() + 2) / 3);
+}
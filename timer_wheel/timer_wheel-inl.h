@@ -0,0 +1,241 @@
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+template <typename Task>
+TimerWheel<Task>::TimerWheel(const std::uint64_t now)
+{
+    free_head = none;
+    current = now;
+    count = 0;
+    std::fill(std::begin(heads), std::end(heads), none);
+    for (auto& level : occupied)
+        std::fill(std::begin(level), std::end(level), 0);
+}
+
+template <typename Task>
+void TimerWheel<Task>::link(const std::uint32_t index)
+{
+    Entry& entry = entries[index];
+    const std::uint64_t diff = entry.deadline - current;
+
+    int level = 0;
+    while (level < levels - 1 && diff >> (slot_bits * (level + 1)))
+        ++level;
+    // Beyond the top level the timer parks in the last slot it can reach
+    // and is filed again when that slot cascades.
+    const std::uint64_t span = std::uint64_t(1) << (slot_bits * levels);
+    const std::uint64_t due = diff < span ? entry.deadline : current + span - 1;
+    const std::uint32_t position = static_cast<std::uint32_t>(due >> (slot_bits * level)) & (slots - 1);
+    const std::uint16_t slot = static_cast<std::uint16_t>(level * slots + position);
+
+    entry.slot = slot;
+    entry.linked = true;
+    entry.previous = none;
+    entry.next = heads[slot];
+    if (entry.next != none)
+        entries[entry.next].previous = index;
+    heads[slot] = index;
+    occupied[level][position / 64] |= std::uint64_t(1) << (position % 64);
+}
+
+template <typename Task>
+void TimerWheel<Task>::unlink(const std::uint32_t index) noexcept
+{
+    Entry& entry = entries[index];
+    if (entry.previous != none)
+        entries[entry.previous].next = entry.next;
+    else
+        heads[entry.slot] = entry.next;
+    if (entry.next != none)
+        entries[entry.next].previous = entry.previous;
+    entry.linked = false;
+
+    if (heads[entry.slot] == none)
+    {
+        const std::uint32_t position = entry.slot % slots;
+        occupied[entry.slot / slots][position / 64] &= ~(std::uint64_t(1) << (position % 64));
+    }
+}
+
+template <typename Task>
+void TimerWheel<Task>::release(const std::uint32_t index) noexcept
+{
+    Entry& entry = entries[index];
+    ++entry.generation;
+    entry.next = free_head;
+    free_head = index;
+    --count;
+}
+
+template <typename Task>
+void TimerWheel<Task>::cascade(const int level)
+{
+    const std::uint32_t position = static_cast<std::uint32_t>(current >> (slot_bits * level)) & (slots - 1);
+    const std::uint32_t slot = level * slots + position;
+    std::uint32_t index = heads[slot];
+    heads[slot] = none;
+    occupied[level][position / 64] &= ~(std::uint64_t(1) << (position % 64));
+
+    while (index != none)
+    {
+        const std::uint32_t next = entries[index].next;
+        link(index);
+        index = next;
+    }
+}
+
+template <typename Task>
+void TimerWheel<Task>::collect(const std::uint32_t slot)
+{
+    std::uint32_t index = heads[slot];
+    heads[slot] = none;
+    occupied[0][slot / 64] &= ~(std::uint64_t(1) << (slot % 64));
+
+    while (index != none)
+    {
+        Entry& entry = entries[index];
+        const std::uint32_t next = entry.next;
+        entry.linked = false;
+        batch.push_back(std::move(entry.task));
+        release(index);
+        index = next;
+    }
+}
+
+template <typename Task>
+std::uint64_t TimerWheel<Task>::next_stop(const std::uint64_t target) const noexcept
+{
+    // The next tick with work is either an occupied level 0 slot or the
+    // boundary where an occupied upper slot cascades. Nothing in a level
+    // can come due before the levels below it have run through their
+    // current rotation.
+    for (int level = 0; level < levels; ++level)
+    {
+        const int shift = slot_bits * level;
+        const std::uint32_t position = static_cast<std::uint32_t>(current >> shift) & (slots - 1);
+        const std::uint64_t rotation = (current >> shift) - position;
+
+        for (std::uint32_t next = position + 1; next < slots;)
+        {
+            const std::uint64_t bits = occupied[level][next / 64] >> (next % 64);
+            if (bits)
+                return std::min((rotation + next + __builtin_ctzll(bits)) << shift, target);
+            next = (next / 64 + 1) * 64;
+        }
+        // Slots at or behind the current position belong to the next
+        // rotation of this level.
+        for (std::uint32_t word = 0; word <= position / 64; ++word)
+        {
+            std::uint64_t bits = occupied[level][word];
+            if (word == position / 64 && position % 64 != 63)
+                bits &= (std::uint64_t(2) << (position % 64)) - 1;
+            if (bits)
+                return std::min((rotation + slots) << shift, target);
+        }
+    }
+    return target;
+}
+
+template <typename Task>
+TimerHandle TimerWheel<Task>::schedule(const std::uint64_t delay, Task task)
+{
+    std::uint32_t index = free_head;
+    if (index != none)
+    {
+        free_head = entries[index].next;
+    }
+    else
+    {
+        if (entries.size() >= none)
+            throw std::length_error("TimerWheel is full");
+        index = static_cast<std::uint32_t>(entries.size());
+        entries.emplace_back();
+        entries.back().generation = 0;
+    }
+
+    Entry& entry = entries[index];
+    entry.task = std::move(task);
+    entry.deadline = current + std::max<std::uint64_t>(delay, 1);
+    link(index);
+    ++count;
+    return TimerHandle{index, entry.generation};
+}
+
+template <typename Task>
+bool TimerWheel<Task>::cancel(const TimerHandle handle)
+{
+    if (!pending(handle))
+        return false;
+
+    unlink(handle.index);
+    entries[handle.index].task = Task();
+    release(handle.index);
+    return true;
+}
+
+template <typename Task>
+bool TimerWheel<Task>::pending(const TimerHandle handle) const noexcept
+{
+    return handle.index < entries.size() && entries[handle.index].generation == handle.generation &&
+           entries[handle.index].linked;
+}
+
+template <typename Task>
+template <typename Func>
+std::size_t TimerWheel<Task>::advance(const std::uint64_t now, Func func)
+{
+    std::size_t fired = 0;
+    while (current < now)
+    {
+        current = next_stop(now);
+        if ((current & (slots - 1)) == 0)
+        {
+            for (int level = 1; level < levels; ++level)
+            {
+                cascade(level);
+                if ((current >> (slot_bits * level)) & (slots - 1))
+                    break;
+            }
+        }
+
+        collect(static_cast<std::uint32_t>(current & (slots - 1)));
+        try
+        {
+            for (Task& task : batch)
+                func(task);
+        }
+        catch (...)
+        {
+            batch.clear();
+            throw;
+        }
+        fired += batch.size();
+        batch.clear();
+    }
+    return fired;
+}
+
+template <typename Task>
+void TimerWheel<Task>::reserve(const std::size_t timers)
+{
+    entries.reserve(timers);
+}
+
+template <typename Task>
+std::uint64_t TimerWheel<Task>::now() const noexcept
+{
+    return current;
+}
+
+template <typename Task>
+std::size_t TimerWheel<Task>::size() const noexcept
+{
+    return count;
+}
+
+template <typename Task>
+bool TimerWheel<Task>::empty() const noexcept
+{
+    return count == 0;
+}
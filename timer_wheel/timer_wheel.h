@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Names a scheduled timer. The generation makes handles of fired or
+// cancelled timers harmless once their entry is reused.
+struct TimerHandle
+{
+    std::uint32_t index;
+    std::uint32_t generation;
+};
+
+// Hierarchical timing wheel over integer ticks. Four levels of 256 slots
+// cover 2^32 ticks; longer delays wait in the top level and are re-filed
+// every time it cascades. Timers live in a slab of entries linked into
+// their slot, so schedule and cancel are O(1) and only allocate when the
+// slab grows. The wheel owns each Task (any default-constructible movable
+// type, e.g. UniquePtr<Job>) until it fires or is cancelled.
+template <typename Task>
+class TimerWheel
+{
+private:
+    static constexpr int levels = 4;
+    static constexpr int slot_bits = 8;
+    static constexpr std::uint32_t slots = 1u << slot_bits;
+    static constexpr std::uint32_t none = 0xffffffffu;
+
+    struct Entry
+    {
+        Task task;
+        std::uint64_t deadline;
+        std::uint32_t next;
+        std::uint32_t previous;
+        std::uint32_t generation;
+        std::uint16_t slot;
+        bool linked;
+    };
+
+    std::vector<Entry> entries;
+    std::uint32_t free_head;
+    std::uint32_t heads[levels * slots];
+    std::uint64_t occupied[levels][slots / 64];
+    std::uint64_t current;
+    std::size_t count;
+    std::vector<Task> batch;
+
+    void link(std::uint32_t index);
+    void unlink(std::uint32_t index) noexcept;
+    void release(std::uint32_t index) noexcept;
+    void cascade(int level);
+    void collect(std::uint32_t slot);
+    std::uint64_t next_stop(std::uint64_t target) const noexcept;
+
+public:
+    explicit TimerWheel(std::uint64_t now = 0);
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    // Fires delay ticks from now; a delay of 0 fires on the next tick.
+    TimerHandle schedule(std::uint64_t delay, Task task);
+    bool cancel(TimerHandle handle);
+    bool pending(TimerHandle handle) const noexcept;
+
+    // Moves the wheel to now and calls func(Task&) for every timer that
+    // expired on the way, one tick's worth at a time. Expired tasks are moved
+    // out of the wheel before any of them runs, so func may schedule or
+    // cancel freely; cancelling a timer of the same batch has no effect.
+    // If func throws, the exception propagates and the rest of that tick's
+    // batch is dropped without running; later ticks stay in the wheel and
+    // fire on the next advance.
+    template <typename Func>
+    std::size_t advance(std::uint64_t now, Func func);
+
+    void reserve(std::size_t timers);
+    std::uint64_t now() const noexcept;
+    std::size_t size() const noexcept;
+    bool empty() const noexcept;
+};
+
+#include "timer_wheel-inl.h"
@@ -0,0 +1,81 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "tiny_mutex.h"
+
+
+template <typename Mutex>
+struct Guarded
+{
+    Mutex mutex;
+    int value;
+};
+
+
+template <typename Mutex>
+double uncontended(long operations)
+{
+    Guarded<Mutex> guarded;
+    guarded.value = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < operations; ++i)
+    {
+        guarded.mutex.lock();
+        ++guarded.value;
+        guarded.mutex.unlock();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (guarded.value == 42)
+        std::printf(" ");
+    return seconds * 1e9 / static_cast<double>(operations);
+}
+
+
+template <typename Mutex>
+double contended(int threads, long operations)
+{
+    Guarded<Mutex> guarded;
+    guarded.value = 0;
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&]() {
+            for (long i = 0; i < operations; ++i)
+            {
+                std::lock_guard<Mutex> lock(guarded.mutex);
+                ++guarded.value;
+            }
+        });
+    }
+    for (std::thread& worker : workers)
+        worker.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return seconds * 1e9 / (static_cast<double>(operations) * threads);
+}
+
+
+int main(int argc, char** argv)
+{
+    const int max_threads = argc > 1 ? std::atoi(argv[1]) : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()) * 2);
+    const long operations = argc > 2 ? std::atol(argv[2]) : 1000000;
+
+    // libstdc++ skips locking std::mutex until the process has a second
+    // thread, which would flatter the uncontended numbers.
+    std::thread([]() {}).join();
+
+    std::printf("%-24s %12s %12s\n", "", "std::mutex", "TinyMutex");
+    std::printf("%-24s %12zu %12zu\n", "bytes per mutex", sizeof(std::mutex), sizeof(TinyMutex));
+    std::printf("%-24s %12zu %12zu\n", "bytes per {mutex, int}", sizeof(Guarded<std::mutex>), sizeof(Guarded<TinyMutex>));
+    std::printf("%-24s %12.2f %12.2f\n", "uncontended ns/lock", uncontended<std::mutex>(operations), uncontended<TinyMutex>(operations));
+    for (int threads = 2; threads <= max_threads; threads *= 2)
+    {
+        char label[32];
+        std::snprintf(label, sizeof(label), "%d threads ns/lock", threads);
+        std::printf("%-24s %12.2f %12.2f\n", label, contended<std::mutex>(threads, operations), contended<TinyMutex>(threads, operations));
+    }
+    return 0;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <atomic>
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Sleeps while *word still equals expected. May return spuriously.
+inline void futex_wait(std::atomic<int>& word, const int expected) noexcept
+{
+    static_assert(sizeof(std::atomic<int>) == sizeof(int), "futex needs a plain 32-bit word");
+    syscall(SYS_futex, reinterpret_cast<int*>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+}
+
+inline void futex_wake(std::atomic<int>& word, const int count = INT_MAX) noexcept
+{
+    syscall(SYS_futex, reinterpret_cast<int*>(&word), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+}
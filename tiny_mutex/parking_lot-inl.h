@@ -0,0 +1,124 @@
+#include "futex.h"
+
+inline ParkingLot::Bucket& ParkingLot::bucket(const void* const address) noexcept
+{
+    static Bucket buckets[bucket_count];
+    std::uintptr_t key = reinterpret_cast<std::uintptr_t>(address);
+    key = (key >> 3) * 0x9e3779b97f4a7c15ull;
+    return buckets[(key >> 32) % bucket_count];
+}
+
+inline ParkingLot::Parker& ParkingLot::self() noexcept
+{
+    static thread_local Parker parker;
+    return parker;
+}
+
+template <typename Validate, typename BeforeSleep>
+bool ParkingLot::park(const void* const address, Validate validate, BeforeSleep before_sleep)
+{
+    Parker& parker = self();
+    Bucket& queue = bucket(address);
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!validate())
+            return false;
+
+        parker.woken.store(0, std::memory_order_relaxed);
+        parker.address = address;
+        parker.next = nullptr;
+        if (queue.tail)
+            queue.tail->next = &parker;
+        else
+            queue.head = &parker;
+        queue.tail = &parker;
+    }
+
+    before_sleep();
+    while (parker.woken.load(std::memory_order_acquire) == 0)
+        futex_wait(parker.woken, 0);
+    return true;
+}
+
+template <typename Validate>
+bool ParkingLot::park(const void* const address, Validate validate)
+{
+    return park(address, validate, []() {});
+}
+
+template <typename Callback>
+bool ParkingLot::unpark_one(const void* const address, Callback callback)
+{
+    Bucket& queue = bucket(address);
+    Parker* found = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        Parker* previous = nullptr;
+        for (Parker* parker = queue.head; parker; previous = parker, parker = parker->next)
+        {
+            if (parker->address != address)
+                continue;
+            found = parker;
+            if (previous)
+                previous->next = parker->next;
+            else
+                queue.head = parker->next;
+            if (queue.tail == parker)
+                queue.tail = previous;
+            break;
+        }
+
+        bool more = false;
+        for (Parker* parker = found ? found->next : queue.head; parker && !more; parker = parker->next)
+            more = parker->address == address;
+        callback(more);
+    }
+
+    if (found == nullptr)
+        return false;
+    found->woken.store(1, std::memory_order_release);
+    futex_wake(found->woken, 1);
+    return true;
+}
+
+inline std::size_t ParkingLot::unpark_all(const void* const address)
+{
+    Bucket& queue = bucket(address);
+    Parker* woken = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        Parker* previous = nullptr;
+        Parker* parker = queue.head;
+        while (parker)
+        {
+            Parker* next = parker->next;
+            if (parker->address == address)
+            {
+                if (previous)
+                    previous->next = next;
+                else
+                    queue.head = next;
+                if (queue.tail == parker)
+                    queue.tail = previous;
+                parker->next = woken;
+                woken = parker;
+            }
+            else
+            {
+                previous = parker;
+            }
+            parker = next;
+        }
+    }
+
+    std::size_t count = 0;
+    while (woken)
+    {
+        Parker* next = woken->next;
+        woken->woken.store(1, std::memory_order_release);
+        futex_wake(woken->woken, 1);
+        woken = next;
+        ++count;
+    }
+    return count;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+// Global table of sleeping threads keyed by address, so a lock or condition
+// only needs a few bits of its own state. Waiters for addresses that hash to
+// the same bucket share its queue; each waiter sleeps on a futex word of its
+// own.
+class ParkingLot
+{
+private:
+    struct Parker
+    {
+        std::atomic<int> woken;
+        const void* address;
+        Parker* next;
+    };
+
+    struct alignas(64) Bucket
+    {
+        std::mutex mutex;
+        Parker* head = nullptr;
+        Parker* tail = nullptr;
+    };
+
+    static const std::size_t bucket_count = 1024;
+
+    static Bucket& bucket(const void* address) noexcept;
+    static Parker& self() noexcept;
+
+public:
+    // Queues the calling thread on address if validate() still holds once
+    // the bucket is locked, runs before_sleep() after the bucket is released,
+    // then sleeps until unparked. Returns false without sleeping if
+    // validation failed.
+    template <typename Validate, typename BeforeSleep>
+    static bool park(const void* address, Validate validate, BeforeSleep before_sleep);
+
+    template <typename Validate>
+    static bool park(const void* address, Validate validate);
+
+    // Wakes the oldest thread parked on address. callback(more_waiters)
+    // runs under the bucket lock, before the woken thread can run, and is
+    // called even when nobody was parked.
+    template <typename Callback>
+    static bool unpark_one(const void* address, Callback callback);
+
+    static std::size_t unpark_all(const void* address);
+};
+
+#include "parking_lot-inl.h"
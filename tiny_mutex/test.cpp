@@ -0,0 +1,145 @@
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "tiny_mutex.h"
+
+
+TEST(TinyMutexTest, IsOneByte)
+{
+    EXPECT_EQ(sizeof(TinyMutex), 1u);
+    EXPECT_EQ(sizeof(TinyCondition), 1u);
+}
+
+
+TEST(TinyMutexTest, TryLockFailsWhileHeld)
+{
+    TinyMutex mutex;
+    EXPECT_FALSE(mutex.is_locked());
+    mutex.lock();
+    EXPECT_TRUE(mutex.is_locked());
+    EXPECT_FALSE(mutex.try_lock());
+    mutex.unlock();
+    EXPECT_TRUE(mutex.try_lock());
+    mutex.unlock();
+    EXPECT_FALSE(mutex.is_locked());
+}
+
+
+TEST(TinyMutexTest, ExcludesConcurrentWriters)
+{
+    TinyMutex mutex;
+    long counter = 0;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < 20000; ++i)
+            {
+                std::lock_guard<TinyMutex> lock(mutex);
+                ++counter;
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+    EXPECT_EQ(counter, 80000);
+    EXPECT_FALSE(mutex.is_locked());
+}
+
+
+TEST(TinyMutexTest, ParkedWaiterIsWokenByUnlock)
+{
+    TinyMutex mutex;
+    std::atomic<bool> acquired(false);
+    mutex.lock();
+
+    std::thread waiter([&]() {
+        mutex.lock();
+        acquired = true;
+        mutex.unlock();
+    });
+    // Long enough for the waiter to give up spinning and park.
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(acquired);
+    mutex.unlock();
+    waiter.join();
+    EXPECT_TRUE(acquired);
+}
+
+
+TEST(ParkingLotTest, FailedValidationDoesNotSleep)
+{
+    int key = 0;
+    bool slept = ParkingLot::park(&key, []() { return false; });
+    EXPECT_FALSE(slept);
+    EXPECT_FALSE(ParkingLot::unpark_one(&key, [](bool) {}));
+    EXPECT_EQ(ParkingLot::unpark_all(&key), 0u);
+}
+
+
+TEST(TinyConditionTest, ProducerConsumer)
+{
+    TinyMutex mutex;
+    TinyCondition ready;
+    std::deque<int> queue;
+    long sum = 0;
+
+    std::thread consumer([&]() {
+        for (int received = 0; received < 1000; ++received)
+        {
+            std::lock_guard<TinyMutex> lock(mutex);
+            ready.wait(mutex, [&]() { return !queue.empty(); });
+            sum += queue.front();
+            queue.pop_front();
+        }
+    });
+    for (int i = 1; i <= 1000; ++i)
+    {
+        {
+            std::lock_guard<TinyMutex> lock(mutex);
+            queue.push_back(i);
+        }
+        ready.notify_one();
+    }
+    consumer.join();
+    EXPECT_EQ(sum, 500500);
+}
+
+
+TEST(TinyConditionTest, NotifyAllWakesEveryWaiter)
+{
+    TinyMutex mutex;
+    TinyCondition go;
+    bool open = false;
+    int waiting = 0;
+    std::atomic<int> woken(0);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&]() {
+            std::lock_guard<TinyMutex> lock(mutex);
+            ++waiting;
+            go.wait(mutex, [&]() { return open; });
+            ++woken;
+        });
+    }
+    for (;;)
+    {
+        std::lock_guard<TinyMutex> lock(mutex);
+        if (waiting == 4)
+            break;
+        std::this_thread::yield();
+    }
+    {
+        std::lock_guard<TinyMutex> lock(mutex);
+        open = true;
+    }
+    go.notify_all();
+    for (std::thread& thread : threads)
+        thread.join();
+    EXPECT_EQ(woken, 4);
+}
@@ -0,0 +1,119 @@
+#include <thread>
+
+inline TinyMutex::TinyMutex() noexcept
+{
+    state.store(0, std::memory_order_relaxed);
+}
+
+inline void TinyMutex::lock() noexcept
+{
+    std::uint8_t expected = 0;
+    if (!state.compare_exchange_weak(expected, locked_bit, std::memory_order_acquire, std::memory_order_relaxed))
+        lock_slow();
+}
+
+inline bool TinyMutex::try_lock() noexcept
+{
+    std::uint8_t current = state.load(std::memory_order_relaxed);
+    while (!(current & locked_bit))
+    {
+        if (state.compare_exchange_weak(current, current | locked_bit, std::memory_order_acquire, std::memory_order_relaxed))
+            return true;
+    }
+    return false;
+}
+
+inline void TinyMutex::unlock() noexcept
+{
+    std::uint8_t expected = locked_bit;
+    if (!state.compare_exchange_strong(expected, 0, std::memory_order_release, std::memory_order_relaxed))
+        unlock_slow();
+}
+
+inline bool TinyMutex::is_locked() const noexcept
+{
+    return state.load(std::memory_order_relaxed) & locked_bit;
+}
+
+inline void TinyMutex::lock_slow() noexcept
+{
+    int spins = 0;
+    for (;;)
+    {
+        std::uint8_t current = state.load(std::memory_order_relaxed);
+        if (!(current & locked_bit))
+        {
+            if (state.compare_exchange_weak(current, current | locked_bit, std::memory_order_acquire, std::memory_order_relaxed))
+                return;
+            continue;
+        }
+
+        // Spinning only pays off while nobody is parked yet.
+        if (!(current & parked_bit) && spins < spin_limit)
+        {
+            ++spins;
+            std::this_thread::yield();
+            continue;
+        }
+
+        if (!(current & parked_bit) &&
+            !state.compare_exchange_weak(current, current | parked_bit, std::memory_order_relaxed, std::memory_order_relaxed))
+            continue;
+
+        ParkingLot::park(this, [this]() {
+            return state.load(std::memory_order_relaxed) == (locked_bit | parked_bit);
+        });
+    }
+}
+
+inline void TinyMutex::unlock_slow() noexcept
+{
+    // While locked|parked is set nobody else may modify the state: lockers
+    // only CAS from states without the locked bit, and the parked bit is
+    // already set. So a plain store can rewrite it here, under the bucket
+    // lock, and a thread about to park revalidates against that store.
+    ParkingLot::unpark_one(this, [this](const bool more) {
+        state.store(more ? parked_bit : 0, std::memory_order_release);
+    });
+}
+
+inline TinyCondition::TinyCondition() noexcept
+{
+    waiters.store(0, std::memory_order_relaxed);
+}
+
+inline void TinyCondition::wait(TinyMutex& mutex) noexcept
+{
+    ParkingLot::park(
+        this,
+        [this]() {
+            waiters.store(1, std::memory_order_relaxed);
+            return true;
+        },
+        [&mutex]() { mutex.unlock(); });
+    mutex.lock();
+}
+
+template <typename Predicate>
+void TinyCondition::wait(TinyMutex& mutex, Predicate predicate)
+{
+    while (!predicate())
+        wait(mutex);
+}
+
+inline void TinyCondition::notify_one() noexcept
+{
+    if (!waiters.load(std::memory_order_acquire))
+        return;
+    ParkingLot::unpark_one(this, [this](const bool more) {
+        waiters.store(more ? 1 : 0, std::memory_order_relaxed);
+    });
+}
+
+inline void TinyCondition::notify_all() noexcept
+{
+    if (!waiters.load(std::memory_order_acquire))
+        return;
+    waiters.store(0, std::memory_order_relaxed);
+    ParkingLot::unpark_all(this);
+}
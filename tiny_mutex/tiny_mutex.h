@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "parking_lot.h"
+
+// A mutex that is a single byte. It spins briefly under contention and then
+// parks the thread in the global ParkingLot, keyed by the mutex address; the
+// parked bit tells unlock() whether anyone has to be woken.
+class TinyMutex
+{
+private:
+    static const std::uint8_t locked_bit = 1;
+    static const std::uint8_t parked_bit = 2;
+    static const int spin_limit = 40;
+
+    std::atomic<std::uint8_t> state;
+
+    void lock_slow() noexcept;
+    void unlock_slow() noexcept;
+
+public:
+    TinyMutex() noexcept;
+    TinyMutex(const TinyMutex&) = delete;
+    TinyMutex& operator=(const TinyMutex&) = delete;
+
+    void lock() noexcept;
+    bool try_lock() noexcept;
+    void unlock() noexcept;
+    bool is_locked() const noexcept;
+};
+
+// Condition variable for TinyMutex. Waiters are parked on the address of
+// the condition; the byte only records whether any are parked so notify is
+// free when nobody waits. Waits may wake spuriously.
+class TinyCondition
+{
+private:
+    std::atomic<std::uint8_t> waiters;
+
+public:
+    TinyCondition() noexcept;
+    TinyCondition(const TinyCondition&) = delete;
+    TinyCondition& operator=(const TinyCondition&) = delete;
+
+    void wait(TinyMutex& mutex) noexcept;
+    template <typename Predicate>
+    void wait(TinyMutex& mutex, Predicate predicate);
+    void notify_one() noexcept;
+    void notify_all() noexcept;
+};
+
+#include "tiny_mutex-inl.h"
@@ -135,3 +135,50 @@ TYPED_TEST(UniquePtrTest, SelfMoveAssignment)
 
     EXPECT_EQ(*ptr, TestHelper::getValue<TypeParam>());
 }
+
+
+class CountingDelete
+{
+public:
+    int* calls;
+
+    void operator()(int* pointer) const noexcept
+    {
+        ++*calls;
+        delete pointer;
+    }
+};
+
+
+TEST(UniquePtrDeleterTest, CustomDeleterRunsOnce)
+{
+    int calls = 0;
+    {
+        UniquePtr<int, CountingDelete> ptr1(new int(1), CountingDelete{&calls});
+        UniquePtr<int, CountingDelete> ptr2(std::move(ptr1));
+        EXPECT_EQ(ptr2.get_deleter().calls, &calls);
+        EXPECT_EQ(calls, 0);
+    }
+    EXPECT_EQ(calls, 1);
+}
+
+
+TEST(UniquePtrDeleterTest, ResetAndMoveAssignmentUseDeleter)
+{
+    int calls = 0;
+    UniquePtr<int, CountingDelete> ptr1(new int(1), CountingDelete{&calls});
+    UniquePtr<int, CountingDelete> ptr2(new int(2), CountingDelete{&calls});
+
+    ptr1 = std::move(ptr2);
+    EXPECT_EQ(calls, 1);
+    EXPECT_EQ(*ptr1, 2);
+
+    ptr1.reset();
+    EXPECT_EQ(calls, 2);
+}
+
+
+TEST(UniquePtrDeleterTest, EmptyDeleterAddsNoSize)
+{
+    EXPECT_EQ(sizeof(UniquePtr<int>), sizeof(int*));
+}
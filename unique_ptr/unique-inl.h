@@ -1,82 +1,132 @@
+#include <utility>
+
 template<typename T>
-UniquePtr<T>::UniquePtr() noexcept
+void DefaultDelete<T>::operator()(T* pointer) const noexcept
+{
+    delete pointer;
+}
+
+template<typename T, typename Deleter>
+UniquePtr<T, Deleter>::UniquePtr() noexcept
 {
     this->pointer = nullptr;
 }
 
-template<typename T>
-UniquePtr<T>::UniquePtr(T* pointer) noexcept
+template<typename T, typename Deleter>
+UniquePtr<T, Deleter>::UniquePtr(T* pointer) noexcept
 {
     this->pointer = pointer;
+    if (pointer)
+        PTR_TRACE(unique, create, this, pointer, sizeof(T));
 }
 
-template<typename T>
-UniquePtr<T>::UniquePtr(UniquePtr&& other) noexcept
+template<typename T, typename Deleter>
+UniquePtr<T, Deleter>::UniquePtr(T* pointer, const Deleter& deleter) noexcept
+    : Deleter(deleter)
+{
+    this->pointer = pointer;
+    if (pointer)
+        PTR_TRACE(unique, create, this, pointer, sizeof(T));
+}
+
+template<typename T, typename Deleter>
+UniquePtr<T, Deleter>::UniquePtr(UniquePtr&& other) noexcept
+    : Deleter(std::move(other.get_deleter()))
 {
+    if (other.pointer)
+        PTR_TRACE(unique, move, this, &other, 0);
     pointer = other.pointer;
     other.pointer = nullptr;
 }
 
-template<typename T>
-UniquePtr<T>& UniquePtr<T>::operator=(UniquePtr&& other) noexcept
+template<typename T, typename Deleter>
+UniquePtr<T, Deleter>& UniquePtr<T, Deleter>::operator=(UniquePtr&& other) noexcept
 {
     if (this == &other)
         return *this;
 
-    delete pointer;
+    if (pointer || other.pointer)
+        PTR_TRACE(unique, move_assign, this, &other, 0);
+    if (pointer)
+        get_deleter()(pointer);
 
     pointer = other.pointer;
     other.pointer = nullptr;
+    get_deleter() = std::move(other.get_deleter());
 
     return *this;
 }
 
-template<typename T>
-UniquePtr<T>::~UniquePtr() noexcept
+template<typename T, typename Deleter>
+UniquePtr<T, Deleter>::~UniquePtr() noexcept
 {
-    delete pointer;
+    if (pointer)
+    {
+        PTR_TRACE(unique, destroy, this, nullptr, 0);
+        get_deleter()(pointer);
+    }
 }
 
-template<typename T>
-T UniquePtr<T>::operator*() const noexcept
+template<typename T, typename Deleter>
+T& UniquePtr<T, Deleter>::operator*() const noexcept
 {
     return *pointer;
 }
 
-template<typename T>
-T* UniquePtr<T>::operator->() const noexcept
+template<typename T, typename Deleter>
+T* UniquePtr<T, Deleter>::operator->() const noexcept
 {
     return pointer;
 }
 
-template<typename T>
-bool UniquePtr<T>::operator!() const noexcept
+template<typename T, typename Deleter>
+bool UniquePtr<T, Deleter>::operator!() const noexcept
 {
     return pointer == nullptr;
 }
 
-template<typename T>
-UniquePtr<T>::operator bool() const noexcept
+template<typename T, typename Deleter>
+UniquePtr<T, Deleter>::operator bool() const noexcept
 {
     return pointer != nullptr;
 }
 
-template<typename T>
-T* UniquePtr<T>::get() const noexcept
+template<typename T, typename Deleter>
+T* UniquePtr<T, Deleter>::get() const noexcept
 {
     return pointer;
 }
 
-template<typename T>
-void UniquePtr<T>::reset() noexcept
+template<typename T, typename Deleter>
+Deleter& UniquePtr<T, Deleter>::get_deleter() noexcept
 {
-    delete pointer;
+    return *this;
+}
+
+template<typename T, typename Deleter>
+const Deleter& UniquePtr<T, Deleter>::get_deleter() const noexcept
+{
+    return *this;
+}
+
+template<typename T, typename Deleter>
+void UniquePtr<T, Deleter>::reset() noexcept
+{
+    if (pointer)
+    {
+        PTR_TRACE(unique, reset, this, nullptr, 0);
+        get_deleter()(pointer);
+    }
     pointer = nullptr;
 }
 
-template<typename T>
-T* UniquePtr<T>::release() noexcept
+template<typename T, typename Deleter>
+T* UniquePtr<T, Deleter>::release() noexcept
 {
+    // The caller takes over the object; for a replay it is as good as
+    // gone from this pointer.
+    if (pointer)
+        PTR_TRACE(unique, reset, this, nullptr, 0);
     T* temp = pointer;
     pointer = nullptr;
     return temp;
@@ -1,24 +1,37 @@
+#pragma once
+
+#include "../ptr_trace/trace_hooks.h"
+
 template<typename T>
-class UniquePtr {
+class DefaultDelete {
+public:
+    void operator()(T* pointer) const noexcept;
+};
+
+template<typename T, typename Deleter = DefaultDelete<T>>
+class UniquePtr : private Deleter {
 private:
     T* pointer;
 
 public:
     UniquePtr() noexcept;
     explicit UniquePtr(T* pointer) noexcept;
+    UniquePtr(T* pointer, const Deleter& deleter) noexcept;
     UniquePtr(const UniquePtr&) = delete;
     UniquePtr& operator=(const UniquePtr&) = delete;
     UniquePtr(UniquePtr&& other) noexcept;
     UniquePtr& operator=(UniquePtr&& other) noexcept;
     ~UniquePtr() noexcept;
 
-    T operator*() const noexcept;
+    T& operator*() const noexcept;
     T* operator->() const noexcept;
     bool operator!() const noexcept;
     explicit operator bool() const noexcept;
     T* get() const noexcept;
+    Deleter& get_deleter() noexcept;
+    const Deleter& get_deleter() const noexcept;
     void reset() noexcept;
     T* release() noexcept;
 };
 
-#include "unique-inl.h"
\ No newline at end of file
+#include "unique-inl.h"